@@ -11,6 +11,7 @@
 
 #include "IOCore/Exception.hpp"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -31,4 +32,21 @@ void Entity::loadBehavior(const std::string& script)
 	throw IOCore::NotImplementedException();
 }
 
+auto Entity::getBounds() const -> Rectangle
+{
+	auto component = [](const std::vector<int>& values, size_t index) {
+		return static_cast<uint32_t>(
+		    std::max(index < values.size() ? values[index] : 0, 0)
+		);
+	};
+	return { { component(position, 0), component(position, 1) },
+		 { component(size, 0), component(size, 1) } };
+}
+
+void Entity::setPosition(Point new_position)
+{
+	position = { static_cast<int>(new_position.x),
+		     static_cast<int>(new_position.y) };
+}
+
 } // namespace elemental
@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include "types/rendering.hpp"
+
 #include <string>
 #include <vector>
 
@@ -24,6 +26,11 @@ class Entity {
 	// Placeholder method for behaviors
 	void loadBehavior(const std::string& script);
 
+	/*! \brief Scene-space bounds; negative coordinates clamp to the
+	 * scene origin. */
+	auto getBounds() const -> Rectangle;
+	void setPosition(Point new_position);
+
     private:
 	std::string type;
 	std::vector<int> position;
@@ -18,10 +18,27 @@
 
 namespace elemental {
 
+struct ResourceSettings {
+	//! Memory budget of the texture cache, in MiB
+	uint32_t texture_cache_mb;
+
+	TOML_CLASS(ResourceSettings, texture_cache_mb);
+};
+
 struct GameSettings {
 	RendererSettings renderer_settings;
+	ResourceSettings resource_settings;
+
+	TOML_CLASS(GameSettings, renderer_settings, resource_settings);
+};
+
+/*! \brief The layout of settings files written before ResourceSettings
+ * existed. Those files have no [resource_settings] table, so they are read
+ * through this and upgraded with the default resource settings. */
+struct LegacyGameSettings {
+	RendererSettings renderer_settings;
 
-	TOML_CLASS(GameSettings, renderer_settings);
+	TOML_CLASS(LegacyGameSettings, renderer_settings);
 };
 
 } // namespace elemental
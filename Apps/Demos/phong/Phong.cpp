@@ -14,15 +14,20 @@
 #include "sys/paths.hpp"
 #include "util/debug.hpp"
 
+#include "FixedTimestep.hpp"
 #include "IOCore/Exception.hpp"
 #include "LoopRegulator.hpp"
+#include "Profiler.hpp"
 #include "SdlEventSource.hpp"
 #include "SdlRenderer.hpp"
 
 #include <SDL_events.h>
 #include <chrono>
+#include <filesystem>
 #include <iostream>
+#include <sstream>
 #include <stack>
+#include <string>
 #include <thread>
 #include <utility>
 
@@ -36,47 +41,91 @@ const GameSettings kDefaultSettings{ { { "Phong",
 	                                 WindowPlacement::Centered,
 	                                 Position2D({ 0, 0 }),
 	                                 { 1270_px, 720_px } },
-	                               { 1024_px, 768_px } } };
+	                               { 1024_px, 768_px } },
+	                             { 256 } };
 
-/// \name Helper Functions
-/// \{
-void print_cycle_rate(
-    milliseconds& cycle_length, c::const_string label = "cycle_length"
-)
+const size_t kBytesPerMiB = 1024 * 1024;
+const auto kFrameRate = 60_Hz;
+const auto kSimulationRate = 120_Hz;
+
+const auto kFrameStatsKey = SDLK_F12;
+const auto kTraceCaptureKey = SDLK_F11;
+
+auto get_settings_path() -> std::filesystem::path
 {
-	DBG_PRINT(label << cycle_length.count() << "ms.");
+	return paths::get_app_config_root() / "phong" / "settings.toml";
+}
+
+auto serialize_settings(const GameSettings& settings) -> std::string
+{
+	std::ostringstream toml_text;
+	toml_text << toml::value(settings);
+	return toml_text.str();
 }
-/// \}
 Phong::Phong(int argc, c::const_string args[], c::const_string env[])
     : Application(argc, args, env)
-    , IObserver()
-    , running_threads()
+    , ITypedObserver<SDL_Event>()
     , video_renderer(IRenderer::GetInstance<SdlRenderer>())
     , event_emitter(Singleton::getReference<SdlEventSource>())
-    , settings_file(
-	  paths::get_app_config_root() / "phong" / "settings.toml",
-	  CreateDirs::Enabled
-      )
+    , event_subscription()
+    , hotkey_subscription()
+    , frame_stats("phong")
+    , frame_arena()
+    , file_writer()
+    , settings_file(get_settings_path(), CreateDirs::Enabled)
     , settings()
+    , asset_loader()
+    , texture_cache(video_renderer, 0)
+    , worker_pool()
+    , components()
+    , systems(worker_pool)
 {
 
 	// Load settings -or- create default settings
+	bool needs_write = false;
 	try {
 		settings_file.read();
-		settings = settings_file.get<GameSettings>();
+		try {
+			settings = settings_file.get<GameSettings>();
+		} catch (std::exception& except) {
+			// Older files lack [resource_settings]; keep the rest
+			auto legacy = settings_file.get<LegacyGameSettings>();
+			settings = { legacy.renderer_settings,
+				     kDefaultSettings.resource_settings };
+			settings_file.set(settings);
+			needs_write = true;
+		}
 	} catch (std::exception& except) {
 		settings_file.set(kDefaultSettings);
-		settings_file.write();
-		settings = settings_file.get<GameSettings>();
+		settings = kDefaultSettings;
+		needs_write = true;
+	}
+	if (needs_write) {
+		// Saved atomically on the writer's I/O thread, so startup does
+		// not wait on the disk and the simulation pool never does I/O
+		this->file_writer.submit(
+		    get_settings_path(), serialize_settings(settings)
+		);
 	}
 
 	this->video_renderer.init(settings.renderer_settings);
+	this->texture_cache.setBudget(
+	    settings.resource_settings.texture_cache_mb * kBytesPerMiB
+	);
 
-	this->event_emitter.registerObserver(*this);
+	this->event_subscription =
+	    this->event_emitter.subscribe(*this, SDL_QUIT);
+	this->hotkey_subscription =
+	    this->event_emitter.subscribe(*this, SDL_KEYDOWN);
 	this->event_emitter.pollEvents();
 }
 Phong::~Phong()
 {
+	// Reports a failed settings save if run() never flushed it
+	this->flush_file_writes();
+	// Textures must be gone before the renderer that owns them
+	texture_cache.clear();
+	asset_loader.stop();
 	video_renderer.deactivate();
 }
 
@@ -85,16 +134,12 @@ auto Phong::run() -> int
 	this->is_running = true;
 	try {
 
-		this->running_threads["simulation_thread"] =
-		    std::thread([this]() { this->simulation_thread_loop(); });
-
-		this->event_and_rendering_loop();
-
-		/* threading clean-up:
-		 * wait for all child threads to finish */
-		for (auto& [key, values] : this->running_threads) {
-			values.join();
+		this->main_loop();
+		this->dump_frame_stats();
+		if (Profiler::Get().isCapturing()) {
+			this->toggle_trace_capture();
 		}
+		this->flush_file_writes();
 
 		return kSuccess;
 	} catch (IOCore::Exception& exc) {
@@ -105,46 +150,110 @@ auto Phong::run() -> int
 	return kError;
 }
 
-void Phong::recieveMessage(const Observable& sender, std::any message)
+void Phong::recieveMessage(
+    const TypedObservable<SDL_Event>& sender, const SDL_Event& event
+)
 {
-	ASSERT(message.has_value());
-
-	auto event = std::any_cast<SDL_Event>(message);
 	if (event.type == SDL_QUIT) {
 		this->is_running = false;
+	} else if (event.type == SDL_KEYDOWN && !event.key.repeat) {
+		if (event.key.keysym.sym == kFrameStatsKey) {
+			this->dump_frame_stats();
+		} else if (event.key.keysym.sym == kTraceCaptureKey) {
+			this->toggle_trace_capture();
+		}
 	}
 }
 
-void Phong::event_and_rendering_loop()
+void Phong::main_loop()
 {
-	LoopRegulator frame_regulator(60_Hz);
+	LoopRegulator frame_regulator(kFrameRate);
+	FixedTimestep simulation(kSimulationRate);
+	const auto kUploadBudget = std::chrono::milliseconds(2);
+	Profiler::Get().setThreadName("main");
 
 	do {
+		PROFILE_ZONE("frame");
 		frame_regulator.startUpdate();
-		this->video_renderer.clearScreen();
+		frame_stats.beginFrame();
 
 		this->event_emitter.pollEvents();
+		this->event_emitter.sendEvents();
+
+		simulation.advance([this](nanoseconds step) {
+			this->simulate(step);
+		});
+		frame_stats.mark(FramePhase::Update);
+
+		this->asset_loader.processUploads(video_renderer, kUploadBudget);
+		this->render(simulation.getAlpha());
+		frame_stats.mark(FramePhase::Render);
+
+		frame_regulator.delay();
+		frame_stats.mark(FramePhase::Sleep);
 
-		auto cycle_delay_ms = frame_regulator.delay();
-		print_cycle_rate(cycle_delay_ms, "frame delay");
 		video_renderer.flip();
+		frame_stats.mark(FramePhase::Present);
+		frame_stats.endFrame();
+
+		// Scratch memory only lives for the frame that allocated it
+		frame_arena.reset();
 	} while (this->is_running);
 
 	this->is_running = false;
 }
 
-void Phong::simulation_thread_loop()
+void Phong::dump_frame_stats()
 {
-	LoopRegulator loop_regulator(60_Hz);
+	auto stats_path =
+	    paths::get_app_config_root() / "phong" / "frame-stats.txt";
+	// Written on the I/O thread, so the dump costs no frame time
+	std::ostringstream report;
+	this->frame_stats.writeReport(report);
+	this->file_writer.submit(stats_path, report.str());
+	DBG_PRINT("Frame stats queued for " << stats_path);
+}
 
-	do {
-		loop_regulator.startUpdate();
+void Phong::toggle_trace_capture()
+{
+	auto& profiler = Profiler::Get();
+	if (!profiler.isCapturing()) {
+		profiler.beginCapture();
+		DBG_PRINT("Trace capture started");
+		return;
+	}
 
-		this->event_emitter.sendEvents();
+	profiler.endCapture();
+	auto trace_path = paths::get_app_config_root() / "phong" / "trace.json";
+	std::ostringstream trace;
+	profiler.writeChromeTrace(trace);
+	this->file_writer.submit(trace_path, trace.str());
+	DBG_PRINT("Trace queued for " << trace_path);
+}
 
-		auto cycle_delay_ms = loop_regulator.delay();
-		print_cycle_rate(cycle_delay_ms);
-	} while (this->is_running);
+void Phong::flush_file_writes()
+{
+	try {
+		this->file_writer.flush();
+	} catch (IOCore::Exception& exc) {
+		// Losing a stats dump is not worth ending the game over
+		std::cerr << exc.what() << std::endl;
+	}
+}
+
+void Phong::simulate(nanoseconds step)
+{
+	PROFILE_FUNCTION();
+	// Game state advances by exactly one step per call
+	this->systems.run(this->components, step);
+}
+
+void Phong::render([[maybe_unused]] double alpha)
+{
+	PROFILE_FUNCTION();
+	/* Nothing is interpolated yet: there is no drawable game state. Once
+	 * there is, blend the previous and current tick's state by alpha. */
+	this->video_renderer.clearScreen();
 }
 
 // clang-format off
@@ -15,10 +15,21 @@
 #include "IOCore/JsonConfigFile.hpp"
 #include "IOCore/TomlConfigFile.hpp"
 
+#include "elemental/AssetLoader.hpp"
+#include "elemental/AsyncFileWriter.hpp"
+#include "elemental/ComponentFactory.hpp"
+#include "elemental/FixedTimestep.hpp"
+#include "elemental/FrameArena.hpp"
+#include "elemental/FrameStats.hpp"
 #include "elemental/IObserver.hpp"
 #include "elemental/LoopRegulator.hpp"
 #include "elemental/Observable.hpp"
 #include "elemental/Singleton.hpp"
+#include "elemental/SystemScheduler.hpp"
+#include "elemental/TextureCache.hpp"
+#include "elemental/ThreadPool.hpp"
+
+#include <SDL.h>
 
 #include <functional>
 #include <memory>
@@ -28,7 +39,7 @@
 namespace elemental {
 
 // Forward declarations
-class IRenderer;
+class SdlRenderer;
 class SdlEventSource;
 
 using IOCore::Application;
@@ -36,14 +47,14 @@ using IOCore::Dictionary;
 
 class Phong
     : public Application
-    , public IObserver {
+    , public ITypedObserver<SDL_Event> {
     public:
 	Phong(int argc, c::const_string args[], c::const_string env[]);
 	~Phong() override;
 
 	auto run() -> int override;
 	void recieveMessage(
-	    const Observable& sender, std::any message = std::any()
+	    const TypedObservable<SDL_Event>& sender, const SDL_Event& event
 	) override;
 
     protected:
@@ -57,16 +68,33 @@ class Phong
 
 	bool is_running{ false };
 
-	Dictionary<std::thread> running_threads;
-
-	void event_and_rendering_loop();
-	void simulation_thread_loop();
+	/*! Events, simulation and rendering share one thread: each frame
+	 * runs however many fixed simulation ticks are due, then renders. */
+	void main_loop();
+	void simulate(std::chrono::nanoseconds step);
+	void render(double alpha);
+	void dump_frame_stats();
+	void toggle_trace_capture();
+	void flush_file_writes();
 
-	IRenderer& video_renderer;
+	SdlRenderer& video_renderer;
 	SdlEventSource& event_emitter;
+	Subscription event_subscription;
+	Subscription hotkey_subscription;
+
+	FrameStats frame_stats;
+	FrameArena frame_arena;
+	AsyncFileWriter file_writer;
 
 	GameSettings settings;
 	IOCore::TomlConfigFile settings_file;
+
+	AssetLoader asset_loader;
+	TextureCache texture_cache;
+
+	ThreadPool worker_pool;
+	ComponentFactory components;
+	SystemScheduler systems;
 };
 
 } // namespace elemental
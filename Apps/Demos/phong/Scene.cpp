@@ -9,37 +9,300 @@
 
 #include "Scene.hpp"
 
+#include "Entity.hpp"
 #include "JsonConfigFile.hpp"
+#include "JsonPathStream.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <fmt/core.h>
+
+#include <utility>
 
 namespace elemental {
 
 using configuration::JsonConfigFile;
 
-Scene::Scene(SDL_Renderer* renderer, JsonConfigFile& configFile)
+namespace {
+// A member name as a JSON pointer segment: '~' is "~0" and '/' is "~1"
+auto escape_pointer_segment(const std::string& name) -> std::string
+{
+	std::string escaped;
+	for (auto character : name) {
+		if (character == '~') {
+			escaped += "~0";
+		} else if (character == '/') {
+			escaped += "~1";
+		} else {
+			escaped += character;
+		}
+	}
+	return escaped;
+}
+} // namespace
+
+Scene::Scene(SDL_Renderer* renderer, JsonConfigFile& configFile,
+             const std::optional<std::string>& scene_key)
     : renderer(renderer)
 {
-	auto config = configFile.jsonDataRef();
-	dimensions = config["dimensions"].get<std::vector<int>>();
-	layers = config["layers"].get<std::vector<std::string>>();
-	for (const auto& entity : config["entities"]) {
-		entities[entity["name"]] = std::make_shared<Entity>(
-		    entity["type"],
-		    entity["position"],
-		    entity["size"],
-		    entity["layer"]
+	// Like scene_format::compile_file(), accept the scene at the top
+	// level or under a single member (MainScene.json nests it in "main")
+	std::vector<std::pair<std::string, bool>> prefixes;
+	if (!scene_key) {
+		prefixes = { { "", false }, { "/*", true } };
+	} else if (!scene_key->empty()) {
+		auto member = "/" + escape_pointer_segment(*scene_key);
+		prefixes = { { member, false } };
+	} else {
+		prefixes = { { "", false } };
+	}
+
+	// Every value must come from the same scene; which member that is
+	// is only known once the first value arrives
+	std::optional<std::string> scene_root;
+	auto in_scene = [&scene_root](bool is_nested,
+	                              JsonPathStream::Handler handler) {
+		return [&scene_root, is_nested, handler](
+			   const std::string& path, nlohmann::json& value
+		       ) {
+			auto root = is_nested
+			                ? JsonPathStream::splitPath(path).front()
+			                : std::string();
+			if (!scene_root) {
+				scene_root = root;
+			} else if (*scene_root != root) {
+				throw IOCore::Exception(fmt::format(
+				    "Scene file holds several scenes ('{}' and "
+				    "'{}'); pass a scene key",
+				    *scene_root,
+				    root
+				));
+			}
+			handler(path, value);
+		};
+	};
+
+	JsonPathStream::Handler on_dimensions =
+	    [this](const std::string&, nlohmann::json& value) {
+		    auto size = value.get<std::vector<uint32_t>>();
+		    dimensions = { size.at(0), size.at(1) };
+	    };
+	JsonPathStream::Handler on_layers = [this](const std::string&,
+	                                           nlohmann::json& value) {
+		layers = value.get<std::vector<std::string>>();
+	};
+	JsonPathStream::Handler on_entity = [this](const std::string& path,
+	                                           nlohmann::json& entity) {
+		// Entities may be listed in an array or keyed by name
+		auto name = entity.value("name",
+		                         JsonPathStream::splitPath(path).back());
+		entities[name] = std::make_shared<Entity>(
+		    entity.value("type", std::string()),
+		    entity["position"].get<std::vector<int>>(),
+		    entity["size"].get<std::vector<int>>(),
+		    entity.value("layer", std::string())
 		);
+		if (entity.contains("image")) {
+			images[name] = entity["image"];
+		}
+	};
+	JsonPathStream::Handler on_tilemap = [this](const std::string&,
+	                                            nlohmann::json& section) {
+		auto size = section.at("size").get<std::vector<uint32_t>>();
+		TileMapSource source{ section.at("directory"),
+			              { size.at(0), size.at(1) },
+			              {},
+			              { size.at(0) / 2, size.at(1) / 2 } };
+		auto& streaming = source.streaming;
+		if (section.contains("chunk_size")) {
+			auto chunk =
+			    section["chunk_size"].get<std::vector<uint32_t>>();
+			streaming.chunk_size = { chunk.at(0), chunk.at(1) };
+		}
+		streaming.load_radius =
+		    section.value("load_radius", streaming.load_radius);
+		streaming.hysteresis =
+		    section.value("hysteresis", streaming.hysteresis);
+		streaming.max_requests_per_update =
+		    section.value("max_requests_per_update",
+		                  streaming.max_requests_per_update);
+		if (section.contains("spawn")) {
+			auto spawn =
+			    section["spawn"].get<std::vector<uint32_t>>();
+			source.spawn = { spawn.at(0), spawn.at(1) };
+		}
+		tile_map_source = std::move(source);
+	};
+	JsonPathStream::Handler on_script = [this](const std::string& path,
+	                                           nlohmann::json& script) {
+		auto name = script.value("name",
+		                         JsonPathStream::splitPath(path).back());
+		scripts[name] = script.value("path", name);
+	};
+
+	// Only the sections a scene uses are built, one entry at a time
+	JsonPathStream paths;
+	for (const auto& [prefix, is_nested] : prefixes) {
+		paths
+		    .on(prefix + "/dimensions",
+		        in_scene(is_nested, on_dimensions))
+		    .on(prefix + "/layers", in_scene(is_nested, on_layers))
+		    .on(prefix + "/entities/*", in_scene(is_nested, on_entity))
+		    .on(prefix + "/tilemap", in_scene(is_nested, on_tilemap))
+		    .on(prefix + "/scripts/*", in_scene(is_nested, on_script));
 	}
-	for (const auto& script : config["scripts"]) {
-		scripts[script["name"]] = script["path"];
+	configFile.stream(paths);
+
+	if (!scene_root) {
+		throw IOCore::Exception(
+		    scene_key ? fmt::format("Scene file has no scene '{}'",
+		                            *scene_key)
+		              : std::string("Scene file contains no scene")
+		);
 	}
+	build_spatial_index(SpatialIndexKind::HashGrid);
+}
+
+Scene::Scene(SDL_Renderer* renderer, const CompiledScene& compiled)
+    : renderer(renderer)
+{
+	dimensions = { compiled.getWidth(), compiled.getHeight() };
+
+	layers.reserve(compiled.getLayerCount());
+	for (size_t index = 0; index < compiled.getLayerCount(); ++index) {
+		layers.emplace_back(compiled.getLayer(index));
+	}
+
+	const auto kEntities = compiled.getEntities();
+	entities.reserve(kEntities.size());
+	for (const auto& record : kEntities) {
+		std::string name(compiled.getString(record.name));
+		auto layer = (record.layer != scene_format::kNoLayer)
+		                 ? compiled.getLayer(record.layer)
+		                 : std::string_view();
+		entities[name] = std::make_shared<Entity>(
+		    std::string(compiled.getString(record.type)),
+		    std::vector<int>(record.position, record.position + 2),
+		    std::vector<int>(record.size, record.size + 2),
+		    std::string(layer)
+		);
+		if (record.image.length != 0) {
+			images[name] = compiled.getString(record.image);
+		}
+	}
+	for (const auto& script : compiled.getScripts()) {
+		scripts[std::string(compiled.getString(script.name))] =
+		    compiled.getString(script.path);
+	}
+	build_spatial_index(SpatialIndexKind::HashGrid);
 }
 Scene::~Scene() = default;
 
-void Scene::loadResources()
+void Scene::loadResources(AssetLoader& loader)
 {
+	// Kick off every decode at once; the loader's workers run them in
+	// parallel while the scripts load.
+	for (const auto& [entity_name, image_path] : images) {
+		textures[entity_name] = loader.loadTexture(image_path);
+	}
 	for (const auto& script : scripts) {
 		load_script(script.second);
 	}
+
+	if (tile_map_source) {
+		tile_map = std::make_unique<TileMapStreamer>(
+		    loader, tile_map_source->directory, tile_map_source->size,
+		    tile_map_source->streaming
+		);
+		tile_map->update(tile_map_source->spawn);
+	}
+}
+
+auto Scene::updateTileMap(Point camera_center) -> size_t
+{
+	return tile_map ? tile_map->update(camera_center) : 0;
+}
+
+auto Scene::getTileMap() const -> const TileMapStreamer*
+{
+	return tile_map.get();
+}
+
+auto Scene::getTexture(const std::string& entity_name) const
+    -> const AssetLoader::TextureFuture&
+{
+	return textures.at(entity_name);
+}
+
+void Scene::build_spatial_index(SpatialIndexKind kind)
+{
+	spatial_index = ISpatialIndex::Create(
+	    kind, { { 0, 0 }, dimensions }
+	);
+	indexed_names.clear();
+	index_ids.clear();
+	indexed_names.reserve(entities.size());
+	index_ids.reserve(entities.size());
+
+	for (const auto& [name, entity] : entities) {
+		auto id =
+		    static_cast<ISpatialIndex::EntryID>(indexed_names.size());
+		indexed_names.push_back(name);
+		index_ids[name] = id;
+		spatial_index->insert(id, entity->getBounds());
+	}
+}
+
+void Scene::setSpatialIndex(SpatialIndexKind kind)
+{
+	build_spatial_index(kind);
+}
+
+void Scene::moveEntity(const std::string& entity_name, Point position)
+{
+	auto& entity = entities.at(entity_name);
+	entity->setPosition(position);
+	spatial_index->update(index_ids.at(entity_name), entity->getBounds());
+}
+
+auto Scene::names_of(const std::vector<ISpatialIndex::EntryID>& ids) const
+    -> std::vector<std::string>
+{
+	std::vector<std::string> names;
+	names.reserve(ids.size());
+	for (auto id : ids) {
+		names.push_back(indexed_names[id]);
+	}
+	return names;
+}
+
+auto Scene::queryEntities(const Rectangle& area) const
+    -> std::vector<std::string>
+{
+	std::vector<ISpatialIndex::EntryID> ids;
+	spatial_index->queryRange(area, ids);
+	return names_of(ids);
+}
+
+auto Scene::pickEntities(Point point) const -> std::vector<std::string>
+{
+	std::vector<ISpatialIndex::EntryID> ids;
+	spatial_index->queryPoint(point, ids);
+	return names_of(ids);
+}
+
+auto Scene::nearestEntity(Point point) const -> std::optional<std::string>
+{
+	if (auto id = spatial_index->queryNearest(point)) {
+		return indexed_names[*id];
+	}
+	return std::nullopt;
+}
+
+// Scripting is not implemented yet; scripts are only collected so far
+void Scene::load_script(const std::string& script)
+{
+	(void)script;
 }
 
 void Scene::setupEntities()
@@ -48,3 +311,8 @@ void Scene::setupEntities()
 		entity.second->loadBehavior(scripts[entity.first]);
 	}
 }
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax foldminlines=10 textwidth=80 ts=8 sts=0 sw=8 noexpandtab ft=cpp.doxygen :
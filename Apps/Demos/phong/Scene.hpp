@@ -9,6 +9,10 @@
 
 #pragma once
 
+#include "AssetLoader.hpp"
+#include "CompiledScene.hpp"
+#include "ISpatialIndex.hpp"
+#include "TileMapStreamer.hpp"
 #include "JsonConfigFile.hpp"
 #include "types/rendering.hpp"
 
@@ -16,6 +20,7 @@
 #include <nlohmann/json.hpp>
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -32,20 +37,72 @@ class Scene {
 	using Dimensions = Area;
 
     public:
-	// Constructor from JSON
-	Scene(SDL_Renderer* renderer, JsonConfigFile& config);
+	/*! \brief Constructor from JSON.
+	 *
+	 * The scene is read from the member \c scene_key of the document,
+	 * or from the document itself if the key is empty. Without a key,
+	 * either layout is accepted, as long as the file holds one scene.
+	 * \throws IOCore::Exception if no scene is found */
+	Scene(SDL_Renderer* renderer, JsonConfigFile& config,
+	      const std::optional<std::string>& scene_key = std::nullopt);
+	/*! \brief Constructor from a compiled scene (see scene-compiler);
+	 * reads the records in place instead of parsing JSON. */
+	Scene(SDL_Renderer* renderer, const CompiledScene& compiled);
 	virtual ~Scene();
 
-	// Resource loading and entity setup methods
-	void loadResources();
+	/*! \brief Queues every image used by the scene on the loader and
+	 * returns without waiting; use getTexture() to wait on the ones the
+	 * first frame needs. Of the tile map, only the chunks around the
+	 * spawn point are requested. */
+	void loadResources(AssetLoader& loader);
 	void setupEntities();
 
+	auto getTexture(const std::string& entity_name) const
+	    -> const AssetLoader::TextureFuture&;
+
+	/*! \brief Rebuilds the entity index with another implementation;
+	 * the hash grid is the default. */
+	void setSpatialIndex(SpatialIndexKind kind);
+	//! \brief Moves an entity and updates the index incrementally
+	void moveEntity(const std::string& entity_name, Point position);
+	auto queryEntities(const Rectangle& area) const
+	    -> std::vector<std::string>;
+	auto pickEntities(Point point) const -> std::vector<std::string>;
+	auto nearestEntity(Point point) const -> std::optional<std::string>;
+
+	/*! \brief Streams tile map chunks in and out around the camera;
+	 * a no-op for scenes without a tile map or before loadResources().
+	 * \returns the number of chunks that became resident */
+	auto updateTileMap(Point camera_center) -> size_t;
+	//! \brief Null unless the scene has a tile map and it was loaded
+	auto getTileMap() const -> const TileMapStreamer*;
+
     private:
 	SDL_Renderer* renderer;
 	Dimensions dimensions;
 	std::vector<std::string> layers;
 	std::unordered_map<std::string, std::shared_ptr<Entity>> entities;
 	std::unordered_map<std::string, std::string> scripts;
+	std::unordered_map<std::string, std::string> images;
+	std::unordered_map<std::string, AssetLoader::TextureFuture> textures;
+
+	// The "tilemap" section; chunk images are streamed, not preloaded
+	struct TileMapSource {
+		std::string directory;
+		Area size;
+		StreamingSettings streaming;
+		Point spawn;
+	};
+	std::optional<TileMapSource> tile_map_source;
+	std::unique_ptr<TileMapStreamer> tile_map;
+
+	std::unique_ptr<ISpatialIndex> spatial_index;
+	std::vector<std::string> indexed_names;
+	std::unordered_map<std::string, ISpatialIndex::EntryID> index_ids;
+
+	void build_spatial_index(SpatialIndexKind kind);
+	auto names_of(const std::vector<ISpatialIndex::EntryID>& ids) const
+	    -> std::vector<std::string>;
 
 	// Placeholder for script handling
 	void load_script(const std::string& script);
@@ -0,0 +1,55 @@
+/* main.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+// Compiles JSON scene descriptions into the binary format read by
+// CompiledScene:
+//
+//     scene-compiler <input.json> <output.scene> [scene-key]
+
+#include "CompiledScene.hpp"
+#include "SceneCompiler.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <iostream>
+#include <string_view>
+
+using namespace elemental;
+
+auto main(int argc, char* args[]) -> int
+{
+	if (argc < 3 || argc > 4) {
+		std::cerr << "Usage: " << args[0]
+			  << " <input.json> <output.scene> [scene-key]"
+			  << std::endl;
+		return 2;
+	}
+
+	try {
+		std::string_view scene_key = (argc == 4) ? args[3] : "";
+		scene_format::compile_file(args[1], args[2], scene_key);
+
+		// Read it back, so a bad file never leaves the build
+		CompiledScene compiled(args[2]);
+		std::cout << args[2] << ": " << compiled.getEntities().size()
+			  << " entities, " << compiled.getScripts().size()
+			  << " scripts, " << compiled.getLayerCount()
+			  << " layers" << std::endl;
+		return 0;
+	} catch (IOCore::Exception& custom_exception) {
+		std::cerr << custom_exception.what() << std::endl;
+		return 1;
+	} catch (std::exception& stl_exception) {
+		std::cerr << stl_exception.what() << std::endl;
+		return -1;
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldminlines=10 textwidth=80 ts=8 sts=0 sw=8 noexpandtab ft=cpp.doxygen :
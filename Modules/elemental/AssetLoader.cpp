@@ -0,0 +1,209 @@
+/* AssetLoader.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "AssetLoader.hpp"
+
+#include "SdlRenderer.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <SDL.h>
+#include <SDL_image.h>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+using namespace elemental;
+using namespace std::chrono;
+
+AssetLoader::AssetLoader(unsigned worker_count)
+    : workers()
+    , decode_mutex()
+    , decode_ready()
+    , decode_queue()
+    , upload_mutex()
+    , upload_queue()
+{
+	if (worker_count == 0) {
+		auto core_count = std::thread::hardware_concurrency();
+		// hardware_concurrency() may report 0 when it cannot tell
+		worker_count = core_count > 1 ? core_count - 1 : 1;
+	}
+
+	/* SDL_image sets its format loaders up lazily, with global state
+	 * that is not thread-safe; do it here, before the workers race to
+	 * the first IMG_Load(). A format that fails to initialise shows up
+	 * as a load error in the affected futures. */
+	IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+
+	for (unsigned index = 0; index < worker_count; ++index) {
+		workers.emplace_back([this]() { this->worker_loop(); });
+	}
+}
+
+AssetLoader::~AssetLoader()
+{
+	this->stop();
+}
+
+void AssetLoader::stop()
+{
+	{
+		auto lock = std::lock_guard(decode_mutex);
+		is_stopping = true;
+	}
+	decode_ready.notify_all();
+
+	for (auto& worker : workers) {
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+
+	// Requests that never ran are dropped; their futures report
+	// std::future_errc::broken_promise.
+	auto lock = std::scoped_lock(decode_mutex, upload_mutex);
+	decode_queue.clear();
+	upload_queue.clear();
+}
+
+auto AssetLoader::loadTexture(const std::filesystem::path& image_path)
+    -> TextureFuture
+{
+	DecodeRequest request{ image_path, {} };
+	TextureFuture texture = request.result.get_future().share();
+	bool is_queued = false;
+	{
+		auto lock = std::lock_guard(decode_mutex);
+		if (!is_stopping) {
+			decode_queue.push_back(std::move(request));
+			is_queued = true;
+		}
+	}
+
+	// No worker is left to serve the queue after stop()
+	if (!is_queued) {
+		request.result.set_exception(std::make_exception_ptr(
+		    std::future_error(std::future_errc::broken_promise)
+		));
+		return texture;
+	}
+	decode_ready.notify_one();
+
+	return texture;
+}
+
+void AssetLoader::worker_loop()
+{
+	while (true) {
+		DecodeRequest request;
+		{
+			auto lock = std::unique_lock(decode_mutex);
+			decode_ready.wait(lock, [this]() {
+				return is_stopping || !decode_queue.empty();
+			});
+			if (is_stopping) {
+				return;
+			}
+			request = std::move(decode_queue.front());
+			decode_queue.pop_front();
+			++decodes_in_flight;
+		}
+
+		UniqueSdlPtr<SDL_Surface> surface = nullptr;
+		surface = IMG_Load(request.image_path.string().c_str());
+
+		if (nullptr == surface) {
+			auto error = std::make_exception_ptr(
+			    IOCore::Exception(fmt::format(
+				"Could not load image {}: {}",
+				request.image_path.string(),
+				IMG_GetError()
+			    ))
+			);
+			{
+				auto lock = std::lock_guard(decode_mutex);
+				--decodes_in_flight;
+			}
+			request.result.set_exception(error);
+		} else {
+			// Moves from decoding to the upload queue in one step,
+			// so getPendingCount() never counts the image twice
+			auto lock = std::scoped_lock(decode_mutex, upload_mutex);
+			--decodes_in_flight;
+			upload_queue.push_back(
+			    { std::move(surface), std::move(request.result) }
+			);
+		}
+	}
+}
+
+auto AssetLoader::processUploads(SdlRenderer& renderer, nanoseconds budget)
+    -> size_t
+{
+	const auto kDeadline = steady_clock::now() + budget;
+	size_t upload_count = 0;
+
+	do {
+		UploadRequest request;
+		{
+			auto lock = std::lock_guard(upload_mutex);
+			if (upload_queue.empty()) {
+				break;
+			}
+			request = std::move(upload_queue.front());
+			upload_queue.pop_front();
+		}
+
+		try {
+			request.result.set_value(
+			    renderer.createTexture(request.surface)
+			);
+		} catch (...) {
+			request.result.set_exception(std::current_exception());
+		}
+		++upload_count;
+	} while (steady_clock::now() < kDeadline);
+
+	return upload_count;
+}
+
+auto AssetLoader::waitFor(const TextureFuture& texture, SdlRenderer& renderer)
+    -> SdlPtr<SDL_Texture>
+{
+	const auto kPollInterval = milliseconds(1);
+
+	while (texture.wait_for(seconds(0)) != std::future_status::ready) {
+		if (0 == this->processUploads(renderer, kPollInterval)) {
+			std::this_thread::sleep_for(kPollInterval);
+		}
+	}
+	return texture.get();
+}
+
+auto AssetLoader::getPendingCount() const -> size_t
+{
+	auto lock = std::scoped_lock(decode_mutex, upload_mutex);
+	return decode_queue.size() + decodes_in_flight + upload_queue.size();
+}
+
+auto AssetLoader::getUploadQueueSize() const -> size_t
+{
+	auto lock = std::lock_guard(upload_mutex);
+	return upload_queue.size();
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,103 @@
+/* AssetLoader.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "INonCopyable.hpp"
+#include "SDL_Memory.hpp"
+
+#include <SDL.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace elemental {
+
+class SdlRenderer;
+
+/*! \brief Loads images off the render thread.
+ *
+ * Files are decoded to SDL_Surfaces on a pool of worker threads. The
+ * decoded surfaces wait in an upload queue until the render thread calls
+ * processUploads(), which turns them into textures within a per-frame time
+ * budget. Every request hands back a future that becomes ready once the
+ * texture exists (or holds the exception that stopped it).
+ *
+ * \note processUploads() and waitFor() must run on the thread that owns the
+ * renderer. */
+class AssetLoader : private INonCopyable
+{
+  public:
+	using TextureFuture = std::shared_future<SdlPtr<SDL_Texture>>;
+
+	//! \param worker_count 0 picks one less than the number of cores
+	explicit AssetLoader(unsigned worker_count = 0);
+	virtual ~AssetLoader();
+
+	//! \brief Queues an image for decoding and returns immediately.
+	auto loadTexture(const std::filesystem::path& image_path)
+	    -> TextureFuture;
+
+	/*! \brief Creates textures for decoded images until the queue is
+	 * empty or \c budget has been spent. At least one upload is done per
+	 * call, so loading always makes progress.
+	 * \returns the number of textures created */
+	auto processUploads(SdlRenderer& renderer,
+	                    std::chrono::nanoseconds budget) -> size_t;
+
+	/*! \brief Blocks until \c texture is ready, uploading whatever is
+	 * decoded in the meantime. Rethrows load errors. */
+	auto waitFor(const TextureFuture& texture, SdlRenderer& renderer)
+	    -> SdlPtr<SDL_Texture>;
+
+	/*! \brief Joins the workers and drops every request that has no
+	 * texture yet; their futures report broken_promise. Call it before
+	 * the renderer goes away. Also done by the destructor. Later
+	 * loadTexture() calls fail the same way. */
+	void stop();
+
+	//! \brief Requests that have not been turned into textures yet
+	auto getPendingCount() const -> size_t;
+	//! \brief Decoded images waiting for processUploads()
+	auto getUploadQueueSize() const -> size_t;
+
+  protected:
+	struct DecodeRequest {
+		std::filesystem::path image_path;
+		std::promise<SdlPtr<SDL_Texture>> result;
+	};
+	struct UploadRequest {
+		UniqueSdlPtr<SDL_Surface> surface;
+		std::promise<SdlPtr<SDL_Texture>> result;
+	};
+
+	void worker_loop();
+
+	std::vector<std::thread> workers;
+	bool is_stopping{ false };
+
+	mutable std::mutex decode_mutex;
+	std::condition_variable decode_ready;
+	std::deque<DecodeRequest> decode_queue;
+	size_t decodes_in_flight{ 0 };
+
+	mutable std::mutex upload_mutex;
+	std::deque<UploadRequest> upload_queue;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
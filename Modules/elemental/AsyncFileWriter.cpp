@@ -0,0 +1,111 @@
+/* AsyncFileWriter.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "AsyncFileWriter.hpp"
+
+#include "AtomicFile.hpp"
+#include "Profiler.hpp"
+
+#include <utility>
+
+using namespace elemental;
+namespace fs = std::filesystem;
+
+AsyncFileWriter::AsyncFileWriter()
+    : mutex()
+    , work_ready()
+    , work_done()
+    , pending()
+    , is_writing(false)
+    , is_stopping(false)
+    , write_count(0)
+    , first_error()
+    , io_thread()
+{
+	// Started last, once every member it touches exists
+	io_thread = std::thread([this]() { this->io_loop(); });
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+	{
+		auto lock = std::lock_guard(mutex);
+		is_stopping = true;
+	}
+	work_ready.notify_one();
+	io_thread.join();
+}
+
+void AsyncFileWriter::submit(const fs::path& file_path, std::string contents)
+{
+	{
+		auto lock = std::lock_guard(mutex);
+		pending[file_path.string()] = std::move(contents);
+	}
+	work_ready.notify_one();
+}
+
+void AsyncFileWriter::flush()
+{
+	auto lock = std::unique_lock(mutex);
+	work_done.wait(lock, [this]() { return pending.empty() && !is_writing; });
+	if (first_error) {
+		std::rethrow_exception(std::exchange(first_error, nullptr));
+	}
+}
+
+auto AsyncFileWriter::getWriteCount() const -> size_t
+{
+	auto lock = std::lock_guard(mutex);
+	return write_count;
+}
+
+void AsyncFileWriter::io_loop()
+{
+	Profiler::Get().setThreadName("file writer");
+
+	auto lock = std::unique_lock(mutex);
+	while (true) {
+		work_ready.wait(lock,
+		                [this]() { return is_stopping || !pending.empty(); });
+		if (pending.empty()) {
+			// Stopping, with nothing left to write
+			break;
+		}
+
+		auto batch = std::exchange(pending, {});
+		is_writing = true;
+		lock.unlock();
+
+		std::exception_ptr batch_error;
+		size_t written = 0;
+		for (const auto& [file_path, contents] : batch) {
+			PROFILE_ZONE("write file");
+			try {
+				write_file_atomically(file_path, contents);
+				++written;
+			} catch (...) {
+				if (!batch_error) {
+					batch_error = std::current_exception();
+				}
+			}
+		}
+
+		lock.lock();
+		is_writing = false;
+		write_count += written;
+		if (batch_error && !first_error) {
+			first_error = batch_error;
+		}
+		work_done.notify_all();
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,71 @@
+/* AsyncFileWriter.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "INonCopyable.hpp"
+
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace elemental {
+
+/*! \brief Writes files on a background I/O thread.
+ *
+ * Callers serialise into a string and hand it over; the I/O thread writes
+ * it with write_file_atomically(). Submitting a file that is still waiting
+ * to be written replaces the waiting contents, so a burst of saves to the
+ * same file costs one write.
+ *
+ * Errors are kept and rethrown by the next flush(). The destructor writes
+ * whatever is still waiting, dropping any error. */
+class AsyncFileWriter : private INonCopyable
+{
+  public:
+	AsyncFileWriter();
+	virtual ~AsyncFileWriter();
+
+	//! \brief Queues \c contents to replace \c file_path
+	void submit(const std::filesystem::path& file_path,
+	            std::string contents);
+
+	/*! \brief Blocks until everything submitted so far is on disk.
+	 * \throws IOCore::Exception for the first write that failed since
+	 *         the last flush() */
+	void flush();
+
+	//! \brief Files written successfully; coalesced submits count once
+	auto getWriteCount() const -> size_t;
+
+  protected:
+	void io_loop();
+
+	mutable std::mutex mutex;
+	std::condition_variable work_ready;
+	std::condition_variable work_done;
+
+	// Keyed by path, so a newer submit replaces an older one
+	std::unordered_map<std::string, std::string> pending;
+	bool is_writing;
+	bool is_stopping;
+	size_t write_count;
+	std::exception_ptr first_error;
+
+	std::thread io_thread;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,152 @@
+/* AtomicFile.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "AtomicFile.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <fmt/core.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace elemental {
+
+namespace {
+// Unique per call, so concurrent writers never share a temporary file
+auto temporary_path_for(const fs::path& file_path) -> fs::path
+{
+	static std::atomic<uint64_t> counter{ 0 };
+	auto suffix = fmt::format(
+	    ".{:x}-{}.tmp",
+	    std::hash<std::thread::id>{}(std::this_thread::get_id()),
+	    counter.fetch_add(1, std::memory_order_relaxed)
+	);
+	auto temporary = file_path;
+	temporary += suffix;
+	return temporary;
+}
+
+[[noreturn]] void throw_write_error(const fs::path& file_path,
+                                    const std::string& reason)
+{
+	throw IOCore::Exception(fmt::format(
+	    "Could not write {}: {}", file_path.string(), reason
+	));
+}
+
+#ifndef _WIN32
+void write_and_sync(const fs::path& temporary, std::string_view contents)
+{
+	int file = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (file < 0) {
+		throw_write_error(temporary, std::strerror(errno));
+	}
+
+	const char* cursor = contents.data();
+	size_t remaining = contents.size();
+	while (remaining > 0) {
+		auto written = ::write(file, cursor, remaining);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			auto reason = std::strerror(errno);
+			::close(file);
+			throw_write_error(temporary, reason);
+		}
+		cursor += written;
+		remaining -= static_cast<size_t>(written);
+	}
+
+	// Without this, a crash after the rename can leave an empty file
+	int sync_error = ::fsync(file) != 0 ? errno : 0;
+	int close_error = ::close(file) != 0 ? errno : 0;
+	if (sync_error != 0 || close_error != 0) {
+		throw_write_error(
+		    temporary,
+		    std::strerror(sync_error != 0 ? sync_error : close_error)
+		);
+	}
+}
+
+// The rename is only durable once the directory entry itself is synced
+void sync_parent_directory(const fs::path& file_path)
+{
+	auto directory = file_path.parent_path();
+	if (directory.empty()) {
+		directory = ".";
+	}
+
+	int handle = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+	if (handle < 0) {
+		throw_write_error(file_path, std::strerror(errno));
+	}
+
+	// Some filesystems cannot sync a directory and report EINVAL
+	int sync_error = ::fsync(handle) != 0 ? errno : 0;
+	::close(handle);
+	if (sync_error != 0 && sync_error != EINVAL) {
+		throw_write_error(file_path, std::strerror(sync_error));
+	}
+}
+#else
+void write_and_sync(const fs::path& temporary, std::string_view contents)
+{
+	std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+	file.write(contents.data(),
+	           static_cast<std::streamsize>(contents.size()));
+	file.flush();
+	if (!file) {
+		throw_write_error(temporary, "write failed");
+	}
+}
+
+void sync_parent_directory(const fs::path&) {}
+#endif
+} // namespace
+
+void write_file_atomically(const fs::path& file_path,
+                           std::string_view contents)
+{
+	auto temporary = temporary_path_for(file_path);
+	try {
+		write_and_sync(temporary, contents);
+	} catch (...) {
+		std::error_code ignored;
+		fs::remove(temporary, ignored);
+		throw;
+	}
+
+	std::error_code error;
+	fs::rename(temporary, file_path, error);
+	if (error) {
+		std::error_code ignored;
+		fs::remove(temporary, ignored);
+		throw_write_error(file_path, error.message());
+	}
+
+	sync_parent_directory(file_path);
+}
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
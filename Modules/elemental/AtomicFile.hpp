@@ -0,0 +1,32 @@
+/* AtomicFile.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+
+namespace elemental {
+
+/*! \brief Replaces \c file_path with \c contents, all or nothing.
+ *
+ * The data goes to a temporary file next to the target, is flushed to
+ * disk, and is then renamed over the target. Readers, and the file left
+ * behind by a crash, see either the old contents or the new ones, never
+ * a mix. The target's directory must exist.
+ *
+ * \throws IOCore::Exception if the file cannot be written; the target is
+ *         left untouched */
+void write_file_atomically(const std::filesystem::path& file_path,
+                           std::string_view contents);
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,92 @@
+/* BlockPool.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "BlockPool.hpp"
+
+#include <algorithm>
+
+using namespace elemental;
+
+namespace {
+constexpr size_t kBlockAlignment = alignof(std::max_align_t);
+}
+
+BlockPool::BlockPool(size_t block_size, size_t blocks_per_chunk,
+                     std::pmr::memory_resource* upstream)
+    : upstream(upstream)
+    , block_size(std::max(block_size, sizeof(FreeBlock)))
+    , blocks_per_chunk(std::max<size_t>(blocks_per_chunk, 1))
+    , chunks()
+{
+	// Every block starts at a max_align_t boundary
+	this->block_size = (this->block_size + kBlockAlignment - 1) /
+	                   kBlockAlignment * kBlockAlignment;
+}
+
+BlockPool::~BlockPool()
+{
+	for (auto* chunk : chunks) {
+		upstream->deallocate(
+		    chunk, block_size * blocks_per_chunk, kBlockAlignment
+		);
+	}
+}
+
+auto BlockPool::fits(size_t bytes, size_t alignment) const -> bool
+{
+	return bytes <= block_size && alignment <= kBlockAlignment;
+}
+
+auto BlockPool::do_allocate(size_t bytes, size_t alignment) -> void*
+{
+	if (!fits(bytes, alignment)) {
+		return upstream->allocate(bytes, alignment);
+	}
+	if (free_list == nullptr) {
+		add_chunk();
+	}
+
+	auto* block = free_list;
+	free_list = block->next;
+	++live_count;
+	return block;
+}
+
+void BlockPool::do_deallocate(void* block, size_t bytes, size_t alignment)
+{
+	if (!fits(bytes, alignment)) {
+		upstream->deallocate(block, bytes, alignment);
+		return;
+	}
+
+	auto* freed = static_cast<FreeBlock*>(block);
+	freed->next = free_list;
+	free_list = freed;
+	--live_count;
+}
+
+void BlockPool::add_chunk()
+{
+	auto* chunk = static_cast<std::byte*>(upstream->allocate(
+	    block_size * blocks_per_chunk, kBlockAlignment
+	));
+	chunks.push_back(chunk);
+
+	// Thread the new blocks onto the free list, lowest address first
+	for (size_t index = blocks_per_chunk; index-- > 0;) {
+		auto* block = reinterpret_cast<FreeBlock*>(
+		    chunk + index * block_size
+		);
+		block->next = free_list;
+		free_list = block;
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
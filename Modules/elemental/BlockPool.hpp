@@ -0,0 +1,74 @@
+/* BlockPool.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "INonCopyable.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace elemental {
+
+/*! \brief Allocator for blocks of one fixed size.
+ *
+ * Blocks are carved from chunks requested from the upstream resource and
+ * recycled through an intrusive free list, so steady allocate / deallocate
+ * churn never reaches upstream. Requests larger than the block size (or
+ * more strictly aligned than std::max_align_t) are passed to upstream.
+ * Chunks are returned to upstream only when the pool is destroyed.
+ *
+ * Not thread-safe. */
+class BlockPool
+    : public std::pmr::memory_resource
+    , private INonCopyable {
+    public:
+	explicit BlockPool(
+	    size_t block_size,
+	    size_t blocks_per_chunk = 64,
+	    std::pmr::memory_resource* upstream = std::pmr::get_default_resource()
+	);
+	~BlockPool() override;
+
+	auto getBlockSize() const -> size_t { return block_size; }
+	//! \brief Blocks currently handed out
+	auto getLiveCount() const -> size_t { return live_count; }
+	auto getChunkCount() const -> size_t { return chunks.size(); }
+
+    protected:
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	auto do_allocate(size_t bytes, size_t alignment) -> void* override;
+	void do_deallocate(void* block, size_t bytes, size_t alignment)
+	    override;
+	auto do_is_equal(const std::pmr::memory_resource& other) const noexcept
+	    -> bool override
+	{
+		return this == &other;
+	}
+
+	auto fits(size_t bytes, size_t alignment) const -> bool;
+	void add_chunk();
+
+	std::pmr::memory_resource* upstream;
+	size_t block_size;
+	size_t blocks_per_chunk;
+
+	FreeBlock* free_list{ nullptr };
+	std::vector<void*> chunks;
+	size_t live_count{ 0 };
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
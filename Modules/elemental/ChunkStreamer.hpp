@@ -0,0 +1,344 @@
+/* ChunkStreamer.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "types/rendering.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <unordered_map>
+#include <utility>
+
+namespace elemental {
+
+//! \brief Column and row of a chunk; chunk (0, 0) is at the world origin
+struct ChunkCoord {
+	uint32_t column, row;
+
+	constexpr auto operator==(const ChunkCoord&) const -> bool = default;
+};
+
+/*! \brief How far around the focus point chunks are kept.
+ *
+ * Radii are counted in chunks, as the larger of the column and row
+ * distance, so a radius of 1 covers a 3 × 3 block. A chunk is requested
+ * once it comes within \c load_radius and only released once it is more
+ * than \c load_radius + \c hysteresis away, so moving back and forth over
+ * a chunk border does not reload the same chunks. */
+struct StreamingSettings {
+	Area chunk_size{ 512, 512 };
+	uint32_t load_radius{ 1 };
+	uint32_t hysteresis{ 1 };
+	//! Requests started per update(); 0 means no limit
+	uint32_t max_requests_per_update{ 0 };
+};
+
+//! \brief Counters reported by ChunkStreamer::getStats()
+struct StreamingStats {
+	size_t resident_count;
+	size_t loading_count;
+	size_t resident_bytes;
+	uint64_t loads;
+	uint64_t unloads;
+	uint64_t failures;
+};
+
+/*! \brief Keeps the chunks of a large world resident around a focus point.
+ *
+ * The world is divided into fixed-size chunks. Each update() releases the
+ * chunks that drifted out of range and asks the loader for the missing
+ * ones nearest the focus first. Loads are asynchronous: the loader hands
+ * back a future, and a chunk becomes resident on the first update() after
+ * that future is ready. A chunk whose load failed is not retried until it
+ * has left the range and come back.
+ *
+ * update() and the accessors are meant to be called from a single thread,
+ * normally the render thread.
+ *
+ * \tparam TPtr shared pointer type of a loaded chunk, e.g.
+ * SdlPtr<SDL_Texture> */
+template<typename TPtr>
+class ChunkStreamer
+{
+  public:
+	using ChunkPtr = TPtr;
+	using ChunkFuture = std::shared_future<ChunkPtr>;
+	using Loader =
+	    std::function<ChunkFuture(ChunkCoord, const Rectangle& bounds)>;
+	using SizeEstimator = std::function<size_t(const ChunkPtr&)>;
+
+	ChunkStreamer(Area world_size, const StreamingSettings& settings,
+	              Loader loader, SizeEstimator size_estimator)
+	    : world_size(world_size)
+	    , settings(settings)
+	    , loader(std::move(loader))
+	    , size_estimator(std::move(size_estimator))
+	    , stats{ 0, 0, 0, 0, 0, 0 }
+	{
+		this->settings.chunk_size.width =
+		    std::max(this->settings.chunk_size.width, 1u);
+		this->settings.chunk_size.height =
+		    std::max(this->settings.chunk_size.height, 1u);
+	}
+	virtual ~ChunkStreamer() = default;
+
+	/*! \brief Collects finished loads, releases out-of-range chunks and
+	 * requests the missing ones around \c focus.
+	 * \returns the number of chunks that became resident */
+	auto update(Point focus) -> size_t
+	{
+		auto center = chunkAt(focus);
+		auto became_resident = collect_loads();
+		release_beyond(center, settings.load_radius + settings.hysteresis);
+		request_around(center);
+		return became_resident;
+	}
+
+	//! \brief Releases every chunk, including loads still in flight
+	void clear()
+	{
+		stats.unloads += chunks.size();
+		chunks.clear();
+		stats.resident_count = 0;
+		stats.loading_count = 0;
+		stats.resident_bytes = 0;
+	}
+
+	//! \brief The chunk containing \c point, clamped to the world
+	auto chunkAt(Point point) const -> ChunkCoord
+	{
+		auto counts = getChunkCounts();
+		return { std::min(point.x / settings.chunk_size.width,
+		                  counts.width - 1),
+			 std::min(point.y / settings.chunk_size.height,
+		                  counts.height - 1) };
+	}
+
+	//! \brief World-space area of a chunk; edge chunks may be smaller
+	auto chunkBounds(ChunkCoord coord) const -> Rectangle
+	{
+		Rectangle chunk{ { coord.column * settings.chunk_size.width,
+			           coord.row * settings.chunk_size.height },
+			         settings.chunk_size };
+		return chunk.clip({ { 0, 0 }, world_size });
+	}
+
+	//! \brief Columns and rows of chunks covering the world
+	auto getChunkCounts() const -> Area
+	{
+		auto count = [](uint32_t length, uint32_t chunk_length) {
+			return std::max(
+			    (length + (chunk_length - 1)) / chunk_length, 1u
+			);
+		};
+		return { count(world_size.width, settings.chunk_size.width),
+			 count(world_size.height, settings.chunk_size.height) };
+	}
+
+	//! \brief The loaded chunk, or null while it is absent or loading
+	auto getChunk(ChunkCoord coord) const -> ChunkPtr
+	{
+		auto chunk_iter = chunks.find(key_of(coord));
+		if (chunk_iter == chunks.end() ||
+		    chunk_iter->second.state != State::Resident) {
+			return nullptr;
+		}
+		return chunk_iter->second.resource;
+	}
+
+	auto isResident(ChunkCoord coord) const -> bool
+	{
+		return getChunk(coord) != nullptr;
+	}
+
+	auto isRequested(ChunkCoord coord) const -> bool
+	{
+		return chunks.contains(key_of(coord));
+	}
+
+	/*! \brief Calls visit(coord, bounds, chunk) for every resident chunk
+	 * overlapping \c view, for drawing. */
+	template<typename TVisitor>
+	void forEachResident(const Rectangle& view, TVisitor&& visit) const
+	{
+		auto area = view.clip({ { 0, 0 }, world_size });
+		if (area.isEmpty()) {
+			return;
+		}
+		auto first = chunkAt(area.position);
+		auto last = chunkAt({ area.right() - 1, area.bottom() - 1 });
+		for (auto row = first.row; row <= last.row; ++row) {
+			for (auto column = first.column; column <= last.column;
+			     ++column) {
+				ChunkCoord coord{ column, row };
+				if (auto chunk = getChunk(coord)) {
+					visit(coord, chunkBounds(coord), chunk);
+				}
+			}
+		}
+	}
+
+	auto getSettings() const -> const StreamingSettings&
+	{
+		return settings;
+	}
+	auto getWorldSize() const -> Area { return world_size; }
+	auto getStats() const -> StreamingStats { return stats; }
+	//! \brief Approximate memory held by resident chunks
+	auto getResidentBytes() const -> size_t
+	{
+		return stats.resident_bytes;
+	}
+
+  protected:
+	enum class State { Loading, Resident, Failed };
+
+	struct Chunk {
+		State state;
+		ChunkFuture pending;
+		ChunkPtr resource;
+		size_t bytes;
+		ChunkCoord coord;
+	};
+
+	static auto key_of(ChunkCoord coord) -> uint64_t
+	{
+		return (static_cast<uint64_t>(coord.row) << 32) | coord.column;
+	}
+
+	static auto distance(ChunkCoord lhs, ChunkCoord rhs) -> uint32_t
+	{
+		auto axis = [](uint32_t a, uint32_t b) {
+			return (a > b) ? a - b : b - a;
+		};
+		return std::max(axis(lhs.column, rhs.column),
+		                axis(lhs.row, rhs.row));
+	}
+
+	auto collect_loads() -> size_t
+	{
+		using namespace std::chrono_literals;
+
+		size_t became_resident = 0;
+		for (auto& [key, chunk] : chunks) {
+			if (chunk.state != State::Loading ||
+			    chunk.pending.wait_for(0s) !=
+			        std::future_status::ready) {
+				continue;
+			}
+			--stats.loading_count;
+			try {
+				chunk.resource = chunk.pending.get();
+			} catch (...) {
+				chunk.resource = nullptr;
+			}
+			chunk.pending = {};
+			if (chunk.resource == nullptr) {
+				chunk.state = State::Failed;
+				++stats.failures;
+				continue;
+			}
+			chunk.state = State::Resident;
+			chunk.bytes = size_estimator(chunk.resource);
+			++stats.resident_count;
+			stats.resident_bytes += chunk.bytes;
+			++became_resident;
+		}
+		return became_resident;
+	}
+
+	void release_beyond(ChunkCoord center, uint32_t radius)
+	{
+		std::erase_if(chunks, [&](const auto& key_and_chunk) {
+			const auto& chunk = key_and_chunk.second;
+			if (distance(chunk.coord, center) <= radius) {
+				return false;
+			}
+			// A load still in flight finishes on its own; its
+			// result is dropped with the last copy of the future
+			if (chunk.state == State::Loading) {
+				--stats.loading_count;
+			} else if (chunk.state == State::Resident) {
+				--stats.resident_count;
+				stats.resident_bytes -= chunk.bytes;
+			}
+			++stats.unloads;
+			return true;
+		});
+	}
+
+	// Requests missing chunks ring by ring, nearest first, so a request
+	// limit never starves the chunk under the focus point.
+	void request_around(ChunkCoord center)
+	{
+		auto counts = getChunkCounts();
+		auto limit = settings.max_requests_per_update;
+		uint32_t requested = 0;
+
+		for (uint32_t ring = 0; ring <= settings.load_radius; ++ring) {
+			auto first_column =
+			    center.column - std::min(center.column, ring);
+			auto first_row = center.row - std::min(center.row, ring);
+			auto last_column =
+			    std::min(center.column + ring, counts.width - 1);
+			auto last_row = std::min(center.row + ring, counts.height - 1);
+
+			for (auto row = first_row; row <= last_row; ++row) {
+				for (auto column = first_column;
+				     column <= last_column; ++column) {
+					ChunkCoord coord{ column, row };
+					if (distance(coord, center) != ring ||
+					    chunks.contains(key_of(coord))) {
+						continue;
+					}
+					if (limit != 0 && requested == limit) {
+						return;
+					}
+					request(coord);
+					++requested;
+				}
+			}
+		}
+	}
+
+	void request(ChunkCoord coord)
+	{
+		Chunk chunk{ State::Loading, {}, nullptr, 0, coord };
+		try {
+			chunk.pending = loader(coord, chunkBounds(coord));
+		} catch (...) {
+			chunk.pending = {};
+		}
+		if (!chunk.pending.valid()) {
+			chunk.state = State::Failed;
+			++stats.failures;
+		} else {
+			++stats.loading_count;
+			++stats.loads;
+		}
+		chunks.emplace(key_of(coord), std::move(chunk));
+	}
+
+	Area world_size;
+	StreamingSettings settings;
+	Loader loader;
+	SizeEstimator size_estimator;
+
+	std::unordered_map<uint64_t, Chunk> chunks;
+	StreamingStats stats;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
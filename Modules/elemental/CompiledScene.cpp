@@ -0,0 +1,124 @@
+/* CompiledScene.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "CompiledScene.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace elemental;
+namespace fs = std::filesystem;
+
+namespace {
+[[noreturn]] void throw_invalid(const char* what)
+{
+	throw IOCore::Exception(fmt::format("Invalid compiled scene: {}", what)
+	);
+}
+} // namespace
+
+CompiledScene::CompiledScene(const fs::path& file_path)
+    : file(std::in_place, file_path)
+    , bytes(file->getData())
+    , layers()
+    , entities()
+    , scripts()
+    , strings()
+{
+	this->validate();
+}
+
+CompiledScene::CompiledScene(std::span<const std::byte> bytes)
+    : file(), bytes(bytes), layers(), entities(), scripts(), strings()
+{
+	this->validate();
+}
+
+template<typename TRecord>
+auto CompiledScene::section(uint32_t offset, uint32_t count) const
+    -> std::span<const TRecord>
+{
+	if (offset % alignof(TRecord) != 0) {
+		throw_invalid("misaligned section");
+	}
+	// 64-bit math: offset + count * size cannot wrap
+	if (offset + static_cast<uint64_t>(count) * sizeof(TRecord) >
+	    bytes.size()) {
+		throw_invalid("section out of bounds");
+	}
+	return { reinterpret_cast<const TRecord*>(bytes.data() + offset),
+		 count };
+}
+
+void CompiledScene::validate()
+{
+	using namespace scene_format;
+
+	if (bytes.size() < sizeof(Header)) {
+		throw_invalid("truncated header");
+	}
+	if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(Header) != 0) {
+		throw_invalid("misaligned data");
+	}
+	const auto& kHeader = header();
+	if (std::memcmp(kHeader.magic, kMagic, sizeof(kMagic)) != 0) {
+		throw_invalid("bad magic");
+	}
+	if (kHeader.version != kVersion) {
+		throw IOCore::Exception(fmt::format(
+		    "Compiled scene version {} is not supported (expected {}); "
+		    "recompile the scene",
+		    kHeader.version,
+		    kVersion
+		));
+	}
+	if (kHeader.header_size != sizeof(Header) ||
+	    kHeader.file_size != bytes.size()) {
+		throw_invalid("size mismatch");
+	}
+
+	layers = section<StringRef>(kHeader.layers_offset, kHeader.layer_count);
+	entities = section<EntityRecord>(
+	    kHeader.entities_offset, kHeader.entity_count
+	);
+	scripts = section<ScriptRecord>(
+	    kHeader.scripts_offset, kHeader.script_count
+	);
+	auto text = section<char>(kHeader.strings_offset, kHeader.strings_size);
+	strings = std::string_view(text.data(), text.size());
+
+	// Checked once here so getString() can skip it
+	auto check = [&](StringRef reference) {
+		if (static_cast<uint64_t>(reference.offset) + reference.length >
+		    strings.size()) {
+			throw_invalid("string out of bounds");
+		}
+	};
+	std::for_each(layers.begin(), layers.end(), check);
+	for (const auto& entity : entities) {
+		check(entity.name);
+		check(entity.type);
+		check(entity.image);
+		check(entity.script);
+		if (entity.layer != kNoLayer && entity.layer >= layers.size()) {
+			throw_invalid("layer index out of bounds");
+		}
+	}
+	for (const auto& script : scripts) {
+		check(script.name);
+		check(script.path);
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
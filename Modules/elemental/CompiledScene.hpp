@@ -0,0 +1,94 @@
+/* CompiledScene.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "INonCopyable.hpp"
+#include "MappedFile.hpp"
+#include "SceneFormat.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace elemental {
+
+/*! \brief Read-only view of a compiled scene, read in place.
+ *
+ * The constructor checks the header and that every section and string
+ * lies inside the data; after that, accessors return spans and
+ * string_views into the data itself, so nothing is parsed or copied.
+ * They stay valid for the lifetime of this object (and, for the span
+ * constructor, of the borrowed bytes).
+ *
+ * \see SceneFormat.hpp for the layout, SceneCompiler for producing it */
+class CompiledScene : private INonCopyable
+{
+  public:
+	using EntityRecord = scene_format::EntityRecord;
+	using ScriptRecord = scene_format::ScriptRecord;
+	using StringRef = scene_format::StringRef;
+
+	//! \brief Maps \c file_path and reads it in place
+	explicit CompiledScene(const std::filesystem::path& file_path);
+	//! \brief Reads \c bytes in place, without taking ownership
+	explicit CompiledScene(std::span<const std::byte> bytes);
+	virtual ~CompiledScene() = default;
+
+	auto getWidth() const -> uint32_t { return header().width; }
+	auto getHeight() const -> uint32_t { return header().height; }
+
+	auto getLayerCount() const -> size_t { return layers.size(); }
+	auto getLayer(size_t index) const -> std::string_view
+	{
+		return this->getString(layers[index]);
+	}
+	auto getEntities() const -> std::span<const EntityRecord>
+	{
+		return entities;
+	}
+	auto getScripts() const -> std::span<const ScriptRecord>
+	{
+		return scripts;
+	}
+
+	auto getString(StringRef reference) const -> std::string_view
+	{
+		return strings.substr(reference.offset, reference.length);
+	}
+
+  protected:
+	auto header() const -> const scene_format::Header&
+	{
+		return *reinterpret_cast<const scene_format::Header*>(
+		    bytes.data()
+		);
+	}
+	//! \throws IOCore::Exception if the data is not a valid scene
+	void validate();
+
+	template<typename TRecord>
+	auto section(uint32_t offset, uint32_t count) const
+	    -> std::span<const TRecord>;
+
+	std::optional<MappedFile> file;
+	std::span<const std::byte> bytes;
+
+	std::span<const StringRef> layers;
+	std::span<const EntityRecord> entities;
+	std::span<const ScriptRecord> scripts;
+	std::string_view strings;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <typeindex>
 
 namespace elemental {
@@ -35,6 +36,7 @@ struct Component
 	{
 		static_assert(std::is_base_of_v<Component, T_>,
 		              "T must be a derived class of Component");
+		return true;
 	}
 
   protected:
@@ -43,18 +45,20 @@ struct Component
 	ComponentFactory& factory;
 
 	Component(ComponentFactory& owner)
-	    : instance_id(next_instance_id++)
+	    : instance_id(
+		  next_instance_id.fetch_add(1, std::memory_order_relaxed)
+	      )
 	    //	    , entity_id(0)
 	    , factory(owner)
 	{
 	}
 
   private:
-	static unsigned int next_instance_id;
+	// Components may be constructed on worker threads. Ids for entities
+	// that come and go should come from an EntityAllocator instead.
+	static inline std::atomic<InstanceID> next_instance_id{ 0 };
 };
 
-unsigned int Component::next_instance_id = 0;
-
 } // namespace elemental
   // clang-format off
 // vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8 foldlevel=99 noexpandtab ft=cpp.doxygen :
@@ -10,33 +10,74 @@
 #pragma once
 
 #include "Component.hpp"
-#include "Exception.hpp"
+#include "ComponentPool.hpp"
+#include "ComponentView.hpp"
+#include "INonCopyable.hpp"
 
-#include <typeindex>
-#include <unordered_map>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
 #include <vector>
 
 namespace elemental {
-class ComponentFactory
-{
-	using TypeInfo = Component::TypeInfo;
-	using ComponentPtr = std::shared_ptr<Component>;
-	using ComponentVector = std::vector<std::shared_ptr<Component>>;
-	using ComponentPool = std::unordered_map<TypeInfo, ComponentVector>;
 
+/*! \brief Owns one ComponentPool per component type.
+ *
+ * Components are plain values keyed by the InstanceID of the object that
+ * owns them; an id may hold at most one component of each type. Pools are
+ * found through a per-type slot number rather than a hash lookup.
+ *
+ * Pools allocate from the memory resource given at construction. */
+class ComponentFactory : private INonCopyable
+{
   public:
-	template<typename TComponent, typename... Args>
-	std::shared_ptr<TComponent> createComponent(
-	    const Component::InstanceID&, Args&&...);
+	using InstanceID = Component::InstanceID;
+
+	explicit ComponentFactory(
+	    std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+	)
+	    : resource(resource), pools()
+	{
+	}
+
+	//! \brief Adds (or replaces) the \c TComponent of \c id
+	template<typename TComponent, typename... TArgs>
+	auto createComponent(InstanceID id, TArgs&&... args) -> TComponent&;
+
+	//! \returns the \c TComponent of \c id, or nullptr if it has none
+	template<typename TComponent>
+	auto getComponent(InstanceID id) -> TComponent*;
 
 	template<typename TComponent>
-	std::shared_ptr<TComponent> getComponent(const Component::InstanceID&);
+	auto hasComponent(InstanceID id) const -> bool;
 
 	template<typename TComponent>
-	ComponentVector& GetComponentVector(const TypeInfo&);
+	auto removeComponent(InstanceID id) -> bool;
+
+	//! \brief Removes every component of \c id, of any type
+	void removeAll(InstanceID id);
+
+	//! \brief The pool of \c TComponent, created empty on first use
+	template<typename TComponent>
+	auto getPool() -> ComponentPool<TComponent>&;
+
+	/*! \brief Iterates the ids that have every one of \c TComponents
+	 * \see ComponentView */
+	template<typename... TComponents>
+	auto view() -> ComponentView<TComponents...>;
+
+	//! \returns the pool of \c TComponent, or nullptr if none exists yet
+	template<typename TComponent>
+	auto findPool() const -> const ComponentPool<TComponent>*;
+
+  protected:
+	template<typename TComponent>
+	static auto type_slot() -> size_t;
+
+	static inline std::atomic<size_t> next_type_slot{ 0 };
 
-  private:
-	ComponentPool component_pool;
+	std::pmr::memory_resource* resource;
+	std::vector<std::unique_ptr<IComponentPool>> pools;
 };
 } // namespace elemental
 
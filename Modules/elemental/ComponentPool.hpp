@@ -0,0 +1,213 @@
+/* ComponentPool.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "BlockPool.hpp"
+#include "Component.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace elemental {
+
+//! \brief What ComponentFactory needs to handle pools of any type
+class IComponentPool
+{
+  public:
+	using InstanceID = Component::InstanceID;
+
+	virtual ~IComponentPool() = default;
+
+	virtual auto has(InstanceID id) const -> bool = 0;
+	virtual auto remove(InstanceID id) -> bool = 0;
+	virtual auto size() const -> size_t = 0;
+	virtual void clear() = 0;
+};
+
+/*! \brief Sparse-set storage for the components of one type.
+ *
+ * Components are stored by value in one dense array, next to a parallel
+ * array of the ids that own them; a paged sparse array maps each id to its
+ * dense index. Add, lookup and removal are O(1), and iterating the pool
+ * walks contiguous memory.
+ *
+ * The dense arrays come from the memory resource given at construction;
+ * sparse pages come from a BlockPool of page-sized blocks on top of it.
+ *
+ * Removal moves the last component into the freed position, so it
+ * invalidates references to that component and reorders the pool; do not
+ * add or remove while iterating. */
+template<typename TComponent>
+class ComponentPool : public IComponentPool
+{
+  public:
+	explicit ComponentPool(
+	    std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+	)
+	    : components(resource)
+	    , ids(resource)
+	    , page_pool(sizeof(SparsePage), kPagesPerChunk, resource)
+	    , sparse_pages(resource)
+	{
+	}
+	~ComponentPool() override = default;
+
+	/*! \brief Constructs the component of \c id in place, replacing any
+	 * component \c id already had. */
+	template<typename... TArgs>
+	auto emplace(InstanceID id, TArgs&&... args) -> TComponent&
+	{
+		auto& index = sparse_entry(id);
+		if (index != kNoIndex) {
+			components[index] =
+			    TComponent{ std::forward<TArgs>(args)... };
+			return components[index];
+		}
+
+		// Both dense arrays grow before the sparse entry points into
+		// them, so a throwing constructor or allocation leaves no trace
+		components.push_back(TComponent{ std::forward<TArgs>(args)... });
+		try {
+			ids.push_back(id);
+		} catch (...) {
+			components.pop_back();
+			throw;
+		}
+		index = static_cast<uint32_t>(components.size() - 1);
+		return components.back();
+	}
+
+	auto has(InstanceID id) const -> bool override
+	{
+		return find_index(id) != kNoIndex;
+	}
+
+	//! \returns the component of \c id, or nullptr if it has none
+	auto get(InstanceID id) -> TComponent*
+	{
+		auto index = find_index(id);
+		return (index != kNoIndex) ? &components[index] : nullptr;
+	}
+	auto get(InstanceID id) const -> const TComponent*
+	{
+		auto index = find_index(id);
+		return (index != kNoIndex) ? &components[index] : nullptr;
+	}
+
+	auto remove(InstanceID id) -> bool override
+	{
+		auto index = find_index(id);
+		if (index == kNoIndex) {
+			return false;
+		}
+
+		auto last_index = static_cast<uint32_t>(components.size() - 1);
+		if (index != last_index) {
+			components[index] = std::move(components[last_index]);
+			ids[index] = ids[last_index];
+			sparse_entry(ids[index]) = index;
+		}
+		components.pop_back();
+		ids.pop_back();
+		sparse_entry(id) = kNoIndex;
+		return true;
+	}
+
+	auto size() const -> size_t override { return components.size(); }
+	auto empty() const -> bool { return components.empty(); }
+	void reserve(size_t count)
+	{
+		components.reserve(count);
+		ids.reserve(count);
+	}
+	void clear() override
+	{
+		for (auto id : ids) {
+			sparse_entry(id) = kNoIndex;
+		}
+		components.clear();
+		ids.clear();
+	}
+
+	/*! \name Dense iteration
+	 * getIds()[i] owns getComponents()[i]. \{ */
+	auto getIds() const -> std::span<const InstanceID> { return ids; }
+	auto getComponents() -> std::span<TComponent> { return components; }
+	auto getComponents() const -> std::span<const TComponent>
+	{
+		return components;
+	}
+
+	auto begin() { return components.begin(); }
+	auto end() { return components.end(); }
+	auto begin() const { return components.begin(); }
+	auto end() const { return components.end(); }
+	/*! \} */
+
+	//! \brief Calls \c function(id, component) for every component.
+	template<typename TFunction>
+	void forEach(TFunction&& function)
+	{
+		const size_t kCount = components.size();
+		for (size_t index = 0; index < kCount; ++index) {
+			function(ids[index], components[index]);
+		}
+	}
+
+  protected:
+	static constexpr uint32_t kNoIndex = UINT32_MAX;
+	// Sparse pages are allocated on first use, so ids far apart do not
+	// cost one sparse entry per id in between.
+	static constexpr size_t kPageSize = 4096;
+	static constexpr size_t kPagesPerChunk = 4;
+	using SparsePage = std::array<uint32_t, kPageSize>;
+
+	auto find_index(InstanceID id) const -> uint32_t
+	{
+		auto page = id / kPageSize;
+		if (page >= sparse_pages.size() ||
+		    sparse_pages[page] == nullptr) {
+			return kNoIndex;
+		}
+		return (*sparse_pages[page])[id % kPageSize];
+	}
+
+	auto sparse_entry(InstanceID id) -> uint32_t&
+	{
+		auto page = id / kPageSize;
+		if (page >= sparse_pages.size()) {
+			sparse_pages.resize(page + 1);
+		}
+		if (sparse_pages[page] == nullptr) {
+			// Freed along with page_pool
+			sparse_pages[page] =
+			    static_cast<SparsePage*>(page_pool.allocate(
+				sizeof(SparsePage), alignof(SparsePage)
+			    ));
+			sparse_pages[page]->fill(kNoIndex);
+		}
+		return (*sparse_pages[page])[id % kPageSize];
+	}
+
+	std::pmr::vector<TComponent> components;
+	std::pmr::vector<InstanceID> ids;
+
+	BlockPool page_pool;
+	std::pmr::vector<SparsePage*> sparse_pages;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,142 @@
+/* ComponentView.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "ComponentPool.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace elemental {
+
+/*! \brief Visits every id that has all of \c TComponents.
+ *
+ * The view walks the ids of its smallest pool (the "driver") and probes
+ * the other pools for each one, so its cost follows the rarest component.
+ * Visiting allocates nothing; the callback receives the id followed by a
+ * reference to each component, in template-argument order.
+ *
+ * Views hold pointers into the pools and the driver's id array, so do not
+ * add or remove components of the viewed types while iterating. */
+template<typename... TComponents>
+class ComponentView
+{
+	static_assert(sizeof...(TComponents) > 0,
+	              "A view needs at least one component type");
+
+  public:
+	using InstanceID = Component::InstanceID;
+
+	static constexpr size_t kDefaultChunkSize = 1024;
+
+	explicit ComponentView(ComponentPool<TComponents>&... viewed_pools)
+	    : pools(&viewed_pools...), driver(0), driver_ids()
+	{
+		const size_t kSizes[] = { viewed_pools.size()... };
+		driver = static_cast<size_t>(
+		    std::min_element(std::begin(kSizes), std::end(kSizes)) -
+		    std::begin(kSizes)
+		);
+		driver_ids =
+		    driver_ids_of(std::index_sequence_for<TComponents...>{});
+	}
+
+	//! \brief Upper bound on the number of ids visited
+	auto sizeHint() const -> size_t { return driver_ids.size(); }
+
+	//! \brief Calls \c function(id, components&...) for each match.
+	template<typename TFunction>
+	void forEach(TFunction&& function)
+	{
+		visit_range(
+		    0,
+		    driver_ids.size(),
+		    function,
+		    std::index_sequence_for<TComponents...>{}
+		);
+	}
+
+	/*! \brief Like forEach(), split in chunks over a ThreadPool.
+	 *
+	 * Runs through ThreadPool::parallelFor(), so the calling thread takes
+	 * part and no threads are started per call. \c function must be safe
+	 * to call concurrently for different ids. The first exception thrown
+	 * by \c function is rethrown here once every chunk has stopped.
+	 *
+	 * \param chunk_size ids per chunk; 0 lets the pool choose */
+	template<typename TFunction>
+	void parallelEach(ThreadPool& pool, TFunction&& function,
+	                  size_t chunk_size = kDefaultChunkSize)
+	{
+		pool.parallelFor(
+		    0,
+		    driver_ids.size(),
+		    [&](size_t begin, size_t end) {
+			    visit_range(
+				begin,
+				end,
+				function,
+				std::index_sequence_for<TComponents...>{}
+			    );
+		    },
+		    chunk_size
+		);
+	}
+
+  protected:
+	template<size_t... Indices>
+	auto driver_ids_of(std::index_sequence<Indices...>) const
+	    -> std::span<const InstanceID>
+	{
+		std::span<const InstanceID> ids;
+		((ids = (Indices == driver) ? std::get<Indices>(pools)->getIds()
+		                            : ids),
+		 ...);
+		return ids;
+	}
+
+	// The driver's component sits at the same dense index as its id;
+	// the other pools are probed through their sparse maps.
+	template<size_t Index>
+	auto lookup(InstanceID id, size_t dense_index) const
+	{
+		auto* pool = std::get<Index>(pools);
+		return (Index == driver) ? &pool->getComponents()[dense_index]
+		                         : pool->get(id);
+	}
+
+	template<typename TFunction, size_t... Indices>
+	void visit_range(size_t begin, size_t end, TFunction& function,
+	                 std::index_sequence<Indices...>) const
+	{
+		for (size_t index = begin; index < end; ++index) {
+			auto id = driver_ids[index];
+			std::tuple<TComponents*...> found{ lookup<Indices>(
+			    id, index
+			)... };
+			if ((std::get<Indices>(found) && ...)) {
+				function(id, *std::get<Indices>(found)...);
+			}
+		}
+	}
+
+	std::tuple<ComponentPool<TComponents>*...> pools;
+	size_t driver;
+	std::span<const InstanceID> driver_ids;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,152 @@
+/* EntityAllocator.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "EntityAllocator.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <fmt/core.h>
+
+using namespace elemental;
+
+namespace {
+constexpr uint32_t kNoIndex = EntityHandle::kInvalidIndex;
+
+constexpr auto is_live_generation(uint32_t generation) -> bool
+{
+	return (generation & 1u) != 0;
+}
+} // namespace
+
+EntityAllocator::EntityAllocator()
+    : pages(std::make_unique<std::atomic<Page*>[]>(kMaxPages))
+    , free_head(pack(0, kNoIndex))
+    , next_fresh_index(0)
+    , live_count(0)
+{
+}
+
+EntityAllocator::~EntityAllocator()
+{
+	for (uint32_t page = 0; page < kMaxPages; ++page) {
+		delete pages[page].load(std::memory_order_relaxed);
+	}
+}
+
+auto EntityAllocator::create() -> EntityHandle
+{
+	auto index = this->pop_free();
+	if (index == kNoIndex) {
+		auto fresh =
+		    next_fresh_index.fetch_add(1, std::memory_order_relaxed);
+		// The last index is reserved for EntityHandle::kInvalidIndex
+		if (fresh >= static_cast<uint64_t>(kPageSize) * kMaxPages - 1) {
+			throw IOCore::Exception(fmt::format(
+			    "EntityAllocator: all {} entity slots are in use",
+			    static_cast<uint64_t>(kPageSize) * kMaxPages - 1
+			));
+		}
+		index = static_cast<uint32_t>(fresh);
+	}
+
+	// The slot is ours alone until the handle is returned
+	auto& slot = this->acquire_slot(index);
+	auto generation =
+	    slot.generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+	live_count.fetch_add(1, std::memory_order_relaxed);
+	return { index, generation };
+}
+
+auto EntityAllocator::destroy(EntityHandle entity) -> bool
+{
+	auto* slot = this->find_slot(entity.index);
+	if (slot == nullptr || !is_live_generation(entity.generation)) {
+		return false;
+	}
+
+	// Only one of several racing destroys can win this exchange
+	auto expected = entity.generation;
+	if (!slot->generation.compare_exchange_strong(
+		expected, entity.generation + 1, std::memory_order_acq_rel
+	    )) {
+		return false;
+	}
+	live_count.fetch_sub(1, std::memory_order_relaxed);
+	this->push_free(entity.index);
+	return true;
+}
+
+auto EntityAllocator::isAlive(EntityHandle entity) const -> bool
+{
+	auto* slot = this->find_slot(entity.index);
+	return slot != nullptr && is_live_generation(entity.generation) &&
+	       slot->generation.load(std::memory_order_acquire) ==
+	           entity.generation;
+}
+
+auto EntityAllocator::find_slot(uint32_t index) const -> Slot*
+{
+	// Pages hold many slots; indices never handed out are not valid
+	// just because their page exists
+	if (index == kNoIndex || index >= this->getSlotCount()) {
+		return nullptr;
+	}
+	auto* page = pages[index / kPageSize].load(std::memory_order_acquire);
+	return (page != nullptr) ? &page->slots[index % kPageSize] : nullptr;
+}
+
+auto EntityAllocator::acquire_slot(uint32_t index) -> Slot&
+{
+	auto& entry = pages[index / kPageSize];
+	auto* page = entry.load(std::memory_order_acquire);
+	if (page == nullptr) {
+		// Several threads may race to add the same page; one wins
+		auto fresh_page = std::make_unique<Page>();
+		if (entry.compare_exchange_strong(page,
+		                                  fresh_page.get(),
+		                                  std::memory_order_acq_rel,
+		                                  std::memory_order_acquire)) {
+			page = fresh_page.release();
+		}
+	}
+	return page->slots[index % kPageSize];
+}
+
+auto EntityAllocator::pop_free() -> uint32_t
+{
+	auto head = free_head.load(std::memory_order_acquire);
+	while (index_of(head) != kNoIndex) {
+		// The slot may be popped and pushed again before the exchange
+		// below; the tag then differs, so the stale next is discarded.
+		auto next = this->find_slot(index_of(head))
+		                ->next_free.load(std::memory_order_relaxed);
+		if (free_head.compare_exchange_weak(head,
+		                                    pack(tag_of(head) + 1, next),
+		                                    std::memory_order_acquire,
+		                                    std::memory_order_acquire)) {
+			return index_of(head);
+		}
+	}
+	return kNoIndex;
+}
+
+void EntityAllocator::push_free(uint32_t index)
+{
+	auto& slot = *this->find_slot(index);
+	auto head = free_head.load(std::memory_order_relaxed);
+	do {
+		slot.next_free.store(index_of(head), std::memory_order_relaxed);
+	} while (!free_head.compare_exchange_weak(head,
+	                                          pack(tag_of(head) + 1, index),
+	                                          std::memory_order_release,
+	                                          std::memory_order_relaxed));
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
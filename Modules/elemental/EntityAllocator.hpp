@@ -0,0 +1,127 @@
+/* EntityAllocator.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "Component.hpp"
+#include "INonCopyable.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace elemental {
+
+/*! \brief Names one entity: a slot index plus the generation of the slot.
+ *
+ * Slot indices are recycled once an entity is destroyed; the generation
+ * tells a handle to the new occupant from a stale handle to the old one.
+ * The index is what ComponentFactory and its pools use as InstanceID. */
+struct EntityHandle {
+	static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+	uint32_t index = kInvalidIndex;
+	uint32_t generation = 0;
+
+	auto isValid() const -> bool { return index != kInvalidIndex; }
+	auto getInstanceId() const -> Component::InstanceID { return index; }
+
+	auto operator==(const EntityHandle&) const -> bool = default;
+};
+
+/*! \brief Hands out and recycles EntityHandles from any thread.
+ *
+ * Freed indices go on a lock-free (Treiber) stack whose head carries a
+ * version tag against ABA; when it is empty a fresh index is taken from a
+ * counter. Slots live in fixed pages that are never moved or freed before
+ * the allocator is destroyed, so any thread may inspect any slot.
+ *
+ * A slot's generation is odd while an entity lives in it and even while it
+ * is free; create() and destroy() each bump it. So every outstanding handle
+ * stops being alive once its entity is destroyed, and no handle, stale or
+ * forged, can destroy a free slot. Generations are 32 bits wide; a handle
+ * kept across 2^31 reuses of its slot would alias the current occupant. */
+class EntityAllocator : private INonCopyable
+{
+  public:
+	static constexpr uint32_t kPageSize = 1u << 16;
+	static constexpr uint32_t kMaxPages = 1u << 16;
+
+	EntityAllocator();
+	virtual ~EntityAllocator();
+
+	/*! \brief Takes a recycled slot if there is one, or a fresh one.
+	 * \throws IOCore::Exception once every index is in use */
+	auto create() -> EntityHandle;
+
+	/*! \brief Frees the slot of \c entity for reuse.
+	 * \returns false if \c entity was already destroyed (stale) or was
+	 * never created */
+	auto destroy(EntityHandle entity) -> bool;
+
+	auto isAlive(EntityHandle entity) const -> bool;
+
+	//! \brief Entities created and not yet destroyed
+	auto getLiveCount() const -> size_t
+	{
+		return live_count.load(std::memory_order_relaxed);
+	}
+	//! \brief Slots ever handed out, alive or free
+	auto getSlotCount() const -> size_t
+	{
+		return std::min<size_t>(
+		    next_fresh_index.load(std::memory_order_relaxed),
+		    static_cast<size_t>(kPageSize) * kMaxPages - 1
+		);
+	}
+
+  protected:
+	struct Slot {
+		// Odd while alive, even while free
+		std::atomic<uint32_t> generation{ 0 };
+		// Next index on the free stack while this slot is free
+		std::atomic<uint32_t> next_free{ EntityHandle::kInvalidIndex };
+	};
+	struct Page {
+		Slot slots[kPageSize];
+	};
+
+	// Free stack head: version tag in the high half, index in the low
+	static constexpr auto pack(uint32_t tag, uint32_t index) -> uint64_t
+	{
+		return (static_cast<uint64_t>(tag) << 32) | index;
+	}
+	static constexpr auto index_of(uint64_t head) -> uint32_t
+	{
+		return static_cast<uint32_t>(head);
+	}
+	static constexpr auto tag_of(uint64_t head) -> uint32_t
+	{
+		return static_cast<uint32_t>(head >> 32);
+	}
+
+	/*! \returns the slot of \c index, or nullptr if the index was never
+	 * handed out or its page is not in yet */
+	auto find_slot(uint32_t index) const -> Slot*;
+	//! \brief Like find_slot(), adding the page if needed
+	auto acquire_slot(uint32_t index) -> Slot&;
+	auto pop_free() -> uint32_t;
+	void push_free(uint32_t index);
+
+	std::unique_ptr<std::atomic<Page*>[]> pages;
+	alignas(64) std::atomic<uint64_t> free_head;
+	alignas(64) std::atomic<uint64_t> next_fresh_index;
+	std::atomic<size_t> live_count;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
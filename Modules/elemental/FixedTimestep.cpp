@@ -0,0 +1,96 @@
+/* FixedTimestep.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "FixedTimestep.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <chrono>
+
+using namespace elemental;
+using namespace std::chrono;
+
+FixedTimestep::FixedTimestep(double tick_rate, unsigned max_steps_per_frame)
+    : step(0), max_steps_per_frame(max_steps_per_frame)
+{
+	ASSERT(max_steps_per_frame > 0);
+	this->setTickRate(tick_rate);
+}
+
+auto FixedTimestep::advance(const TickFunction& tick) -> unsigned
+{
+	auto now = steady_clock::now();
+	if (last_advance == steady_clock::time_point()) {
+		last_advance = now;
+		return 0;
+	}
+
+	auto frame_time = now - last_advance;
+	last_advance = now;
+	return this->advance(frame_time, tick);
+}
+
+auto FixedTimestep::advance(nanoseconds frame_time, const TickFunction& tick)
+    -> unsigned
+{
+	accumulator += frame_time;
+
+	unsigned steps_run = 0;
+	while (accumulator >= step && steps_run < max_steps_per_frame) {
+		tick(step);
+		accumulator -= step;
+		++steps_run;
+		++tick_count;
+	}
+
+	// Spiral-of-death guard: give up on time the cap did not let us
+	// simulate, keeping only the fraction used for interpolation.
+	if (accumulator >= step) {
+		auto excess = accumulator - (accumulator % step);
+		dropped_time += excess;
+		accumulator -= excess;
+	}
+	return steps_run;
+}
+
+auto FixedTimestep::getAlpha() const -> double
+{
+	return duration<double>(accumulator) / duration<double>(step);
+}
+
+auto FixedTimestep::getStep() const -> nanoseconds
+{
+	return this->step;
+}
+
+auto FixedTimestep::getTickCount() const -> uint64_t
+{
+	return this->tick_count;
+}
+
+auto FixedTimestep::getDroppedTime() const -> nanoseconds
+{
+	return this->dropped_time;
+}
+
+void FixedTimestep::setTickRate(double tick_rate)
+{
+	ASSERT(tick_rate > 0);
+	this->step =
+	    duration_cast<nanoseconds>(duration<double>(1.0 / tick_rate));
+}
+
+void FixedTimestep::reset()
+{
+	accumulator = nanoseconds(0);
+	last_advance = steady_clock::time_point();
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
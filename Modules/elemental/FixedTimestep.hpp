@@ -0,0 +1,85 @@
+/* FixedTimestep.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "types/units.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace elemental {
+
+/*! \brief Runs simulation ticks at a fixed rate from a variable-rate loop.
+ *
+ * Each frame, advance() adds the real time since the previous frame to an
+ * accumulator and runs as many whole ticks as fit in it. The leftover
+ * fraction of a tick is exposed as getAlpha(), for rendering to
+ * interpolate between the last two simulation states.
+ *
+ * Pair it with a LoopRegulator pacing the frames:
+ * \code
+ * LoopRegulator frame_regulator(60_Hz);
+ * FixedTimestep simulation(120_Hz);
+ * while (running) {
+ * 	frame_regulator.startUpdate();
+ * 	simulation.advance([&](auto step) { update(step); });
+ * 	render(simulation.getAlpha());
+ * 	frame_regulator.delay();
+ * }
+ * \endcode
+ *
+ * When the simulation cannot keep up, at most \c max_steps_per_frame ticks
+ * run per frame and the excess time is discarded, so the game slows down
+ * instead of spiralling into ever longer frames. */
+class FixedTimestep
+{
+  public:
+	using TickFunction = std::function<void(std::chrono::nanoseconds)>;
+
+	explicit FixedTimestep(double tick_rate = 60_Hz,
+	                       unsigned max_steps_per_frame = 8);
+
+	/*! \brief Accumulates the time since the previous call and runs the
+	 * ticks that are due. The first call only starts the clock.
+	 * \returns the number of ticks run */
+	auto advance(const TickFunction& tick) -> unsigned;
+
+	//! \brief Same as advance(tick), with an explicit frame time
+	auto advance(std::chrono::nanoseconds frame_time,
+	             const TickFunction& tick) -> unsigned;
+
+	/*! \brief Fraction of a tick left in the accumulator, in [0, 1).
+	 * 0 renders the latest simulated state as-is. */
+	auto getAlpha() const -> double;
+
+	auto getStep() const -> std::chrono::nanoseconds;
+	auto getTickCount() const -> uint64_t;
+	//! \brief Simulation time discarded by the catch-up cap
+	auto getDroppedTime() const -> std::chrono::nanoseconds;
+
+	void setTickRate(double tick_rate);
+	//! \brief Empties the accumulator and restarts the frame clock.
+	void reset();
+
+  protected:
+	std::chrono::nanoseconds step;
+	std::chrono::nanoseconds accumulator{ 0 };
+	std::chrono::nanoseconds dropped_time{ 0 };
+	std::chrono::steady_clock::time_point last_advance{};
+
+	unsigned max_steps_per_frame;
+	uint64_t tick_count{ 0 };
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,120 @@
+/* FrameArena.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "FrameArena.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+using namespace elemental;
+
+namespace {
+constexpr size_t kBlockAlignment = alignof(std::max_align_t);
+
+// Returns the first address at or after \c cursor aligned to \c alignment,
+// or nullptr if \c bytes from there would pass \c limit.
+auto bump(std::byte* cursor, std::byte* limit, size_t bytes, size_t alignment)
+    -> std::byte*
+{
+	auto address = reinterpret_cast<uintptr_t>(cursor);
+	auto aligned = (address + alignment - 1) & ~(uintptr_t(alignment) - 1);
+	auto available = reinterpret_cast<uintptr_t>(limit);
+	if (aligned > available || available - aligned < bytes) {
+		return nullptr;
+	}
+	return reinterpret_cast<std::byte*>(aligned);
+}
+} // namespace
+
+FrameArena::FrameArena(size_t capacity, std::pmr::memory_resource* upstream)
+    : upstream(upstream)
+    , buffer(nullptr)
+    , capacity(std::max<size_t>(capacity, kBlockAlignment))
+    , cursor(nullptr)
+    , limit(nullptr)
+    , overflow_blocks()
+{
+	buffer = static_cast<std::byte*>(
+	    upstream->allocate(this->capacity, kBlockAlignment)
+	);
+	cursor = buffer;
+	limit = buffer + this->capacity;
+}
+
+FrameArena::~FrameArena()
+{
+	for (auto& block : overflow_blocks) {
+		upstream->deallocate(block.data, block.size, kBlockAlignment);
+	}
+	upstream->deallocate(buffer, capacity, kBlockAlignment);
+}
+
+auto FrameArena::do_allocate(size_t bytes, size_t alignment) -> void*
+{
+	auto* start = bump(cursor, limit, bytes, alignment);
+	if (start == nullptr) {
+		return allocate_overflow(bytes, alignment);
+	}
+
+	used += static_cast<size_t>(start + bytes - cursor);
+	cursor = start + bytes;
+	return start;
+}
+
+auto FrameArena::allocate_overflow(size_t bytes, size_t alignment) -> void*
+{
+	// Later overflow allocations of this frame carry on in the new block
+	auto size = std::max(bytes + alignment, capacity / 2);
+	auto* data = static_cast<std::byte*>(
+	    upstream->allocate(size, kBlockAlignment)
+	);
+	overflow_blocks.push_back({ data, size });
+
+	cursor = data;
+	limit = data + size;
+	auto* start = bump(cursor, limit, bytes, alignment);
+	used += static_cast<size_t>(start + bytes - cursor);
+	cursor = start + bytes;
+	return start;
+}
+
+void FrameArena::reset()
+{
+	high_water_mark = std::max(high_water_mark, used);
+
+	if (!overflow_blocks.empty()) {
+		for (auto& block : overflow_blocks) {
+			upstream->deallocate(
+			    block.data, block.size, kBlockAlignment
+			);
+		}
+		overflow_blocks.clear();
+
+		// Grow once, so frames like this one fit from now on
+		upstream->deallocate(buffer, capacity, kBlockAlignment);
+		capacity =
+		    std::max(std::bit_ceil(high_water_mark), capacity * 2);
+		buffer = static_cast<std::byte*>(
+		    upstream->allocate(capacity, kBlockAlignment)
+		);
+	}
+
+	cursor = buffer;
+	limit = buffer + capacity;
+	used = 0;
+}
+
+auto FrameArena::getHighWaterMark() const -> size_t
+{
+	return std::max(high_water_mark, used);
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
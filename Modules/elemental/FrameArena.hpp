@@ -0,0 +1,86 @@
+/* FrameArena.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "INonCopyable.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace elemental {
+
+/*! \brief Linear allocator for memory that lives for one frame.
+ *
+ * Allocation bumps a pointer; deallocation does nothing, and reset()
+ * releases everything at once. Use it through std::pmr containers:
+ * \code
+ * std::pmr::vector<Rectangle> visible(&frame_arena);
+ * \endcode
+ *
+ * When a frame needs more than the capacity, the overflow is served from
+ * extra upstream blocks and the next reset() grows the main block to the
+ * high-water mark, so a steady-state frame never reaches upstream.
+ *
+ * Not thread-safe: use one arena per thread. */
+class FrameArena
+    : public std::pmr::memory_resource
+    , private INonCopyable {
+    public:
+	static constexpr size_t kDefaultCapacity = 1024 * 1024;
+
+	explicit FrameArena(
+	    size_t capacity = kDefaultCapacity,
+	    std::pmr::memory_resource* upstream = std::pmr::get_default_resource()
+	);
+	~FrameArena() override;
+
+	/*! \brief Releases every allocation made since the last reset.
+	 * Memory handed out before is invalid afterwards. */
+	void reset();
+
+	auto getCapacity() const -> size_t { return capacity; }
+	//! \brief Bytes handed out since the last reset, padding included
+	auto getUsed() const -> size_t { return used; }
+	//! \brief Most bytes used in any frame so far
+	auto getHighWaterMark() const -> size_t;
+
+    protected:
+	auto do_allocate(size_t bytes, size_t alignment) -> void* override;
+	void do_deallocate(void*, size_t, size_t) override {}
+	auto do_is_equal(const std::pmr::memory_resource& other) const noexcept
+	    -> bool override
+	{
+		return this == &other;
+	}
+
+	auto allocate_overflow(size_t bytes, size_t alignment) -> void*;
+
+	struct Block {
+		std::byte* data;
+		size_t size;
+	};
+
+	std::pmr::memory_resource* upstream;
+
+	std::byte* buffer;
+	size_t capacity;
+	std::byte* cursor;
+	std::byte* limit;
+
+	std::vector<Block> overflow_blocks;
+	size_t used{ 0 };
+	size_t high_water_mark{ 0 };
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
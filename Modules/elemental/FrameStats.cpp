@@ -0,0 +1,241 @@
+/* FrameStats.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "FrameStats.hpp"
+
+#include "AtomicFile.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+
+using namespace elemental;
+using namespace std::chrono;
+
+namespace {
+const std::array<const char*, kFramePhaseCount> kPhaseNames = {
+	"update", "render", "present", "sleep"
+};
+
+auto summarize_durations(std::vector<nanoseconds>& durations)
+    -> TimingSummary
+{
+	if (durations.empty()) {
+		return {};
+	}
+	std::sort(durations.begin(), durations.end());
+
+	nanoseconds total(0);
+	for (auto duration : durations) {
+		total += duration;
+	}
+	// Nearest rank, as LoopRegulator uses: the ceil(p% * size)-th sample
+	auto percentile = [&](size_t percent) {
+		auto rank = (durations.size() * percent + 99) / 100;
+		return durations[std::max<size_t>(rank, 1) - 1];
+	};
+
+	return { durations.front(),
+		 total / durations.size(),
+		 percentile(50),
+		 percentile(95),
+		 percentile(99),
+		 durations.back() };
+}
+
+auto to_ms(nanoseconds span) -> double
+{
+	return duration<double, std::milli>(span).count();
+}
+} // namespace
+
+auto FrameTiming::total() const -> nanoseconds
+{
+	nanoseconds sum(0);
+	for (auto phase : phases) {
+		sum += phase;
+	}
+	return sum;
+}
+
+FrameStats::FrameStats(std::string name)
+    : name(std::move(name)), slots(), current(), last_mark()
+{
+}
+
+void FrameStats::beginFrame()
+{
+	current = {};
+	last_mark = steady_clock::now();
+}
+
+void FrameStats::mark(FramePhase phase)
+{
+	auto now = steady_clock::now();
+	current[phase] += now - last_mark;
+	last_mark = now;
+}
+
+void FrameStats::endFrame()
+{
+	this->record(current);
+}
+
+/* Seqlock-style publication: a reader that observes any part of a slot
+ * being overwritten is guaranteed to also observe the write_count that
+ * preceded the overwrite, and discards the slot. */
+void FrameStats::record(const FrameTiming& timing)
+{
+	auto index = write_count.load(std::memory_order_relaxed);
+	auto& slot = slots[index % kSlotCount];
+
+	std::atomic_thread_fence(std::memory_order_release);
+	for (size_t phase = 0; phase < kFramePhaseCount; ++phase) {
+		slot.phase_ns[phase].store(
+		    timing.phases[phase].count(), std::memory_order_relaxed
+		);
+	}
+	write_count.store(index + 1, std::memory_order_release);
+}
+
+auto FrameStats::getName() const -> const std::string&
+{
+	return this->name;
+}
+
+auto FrameStats::getRecordedCount() const -> uint64_t
+{
+	return write_count.load(std::memory_order_acquire);
+}
+
+auto FrameStats::snapshot() const -> std::vector<FrameTiming>
+{
+	auto end = write_count.load(std::memory_order_acquire);
+	auto begin = (end > kWindowSize) ? end - kWindowSize : 0;
+
+	std::vector<FrameTiming> frames;
+	frames.reserve(end - begin);
+	for (auto index = begin; index < end; ++index) {
+		const auto& slot = slots[index % kSlotCount];
+		FrameTiming timing{};
+		for (size_t phase = 0; phase < kFramePhaseCount; ++phase) {
+			timing.phases[phase] = nanoseconds(
+			    slot.phase_ns[phase].load(std::memory_order_relaxed)
+			);
+		}
+		frames.push_back(timing);
+	}
+
+	// Drop the frames whose slots the writer reached while we copied
+	std::atomic_thread_fence(std::memory_order_acquire);
+	auto after = write_count.load(std::memory_order_relaxed);
+	if (after >= begin + kSlotCount) {
+		auto overwritten = std::min<uint64_t>(
+		    after - (begin + kSlotCount) + 1, frames.size()
+		);
+		frames.erase(frames.begin(), frames.begin() + overwritten);
+	}
+	return frames;
+}
+
+auto FrameStats::summarize() const -> FrameStatsReport
+{
+	auto frames = this->snapshot();
+	FrameStatsReport report{};
+	report.frame_count = frames.size();
+
+	std::vector<nanoseconds> durations;
+	durations.reserve(frames.size());
+	for (size_t phase = 0; phase < kFramePhaseCount; ++phase) {
+		durations.clear();
+		for (const auto& frame : frames) {
+			durations.push_back(frame.phases[phase]);
+		}
+		report.phases[phase] = summarize_durations(durations);
+	}
+
+	durations.clear();
+	const size_t kLastBucket = report.histogram.size() - 1;
+	for (const auto& frame : frames) {
+		auto total = frame.total();
+		durations.push_back(total);
+
+		auto bucket = static_cast<size_t>(
+		    std::max<int64_t>(0, duration_cast<milliseconds>(total).count())
+		);
+		++report.histogram[std::min(bucket, kLastBucket)];
+	}
+	report.frame = summarize_durations(durations);
+
+	return report;
+}
+
+void FrameStats::writeReport(std::ostream& output) const
+{
+	auto report = this->summarize();
+
+	output << fmt::format(
+	    "{} stats over the last {} frames (ms)\n", name, report.frame_count
+	);
+	output << fmt::format(
+	    "{:<8} {:>8} {:>8} {:>8} {:>8} {:>8} {:>8}\n",
+	    "",
+	    "min",
+	    "avg",
+	    "p50",
+	    "p95",
+	    "p99",
+	    "max"
+	);
+
+	auto write_row = [&](const char* label, const TimingSummary& row) {
+		output << fmt::format(
+		    "{:<8} {:>8.3f} {:>8.3f} {:>8.3f} {:>8.3f} {:>8.3f} "
+		    "{:>8.3f}\n",
+		    label,
+		    to_ms(row.min),
+		    to_ms(row.avg),
+		    to_ms(row.p50),
+		    to_ms(row.p95),
+		    to_ms(row.p99),
+		    to_ms(row.max)
+		);
+	};
+	for (size_t phase = 0; phase < kFramePhaseCount; ++phase) {
+		write_row(kPhaseNames[phase], report.phases[phase]);
+	}
+	write_row("frame", report.frame);
+
+	output << "\nframe time histogram\n";
+	const size_t kLastBucket = report.histogram.size() - 1;
+	for (size_t bucket = 0; bucket <= kLastBucket; ++bucket) {
+		if (report.histogram[bucket] == 0) {
+			continue;
+		}
+		output << fmt::format(
+		    "{:>3}{} ms: {}\n",
+		    bucket,
+		    (bucket == kLastBucket) ? "+" : " ",
+		    report.histogram[bucket]
+		);
+	}
+}
+
+void FrameStats::dumpToFile(const std::filesystem::path& file_path) const
+{
+	std::ostringstream report;
+	this->writeReport(report);
+	write_file_atomically(file_path, report.str());
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,114 @@
+/* FrameStats.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "INonCopyable.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace elemental {
+
+enum class FramePhase : unsigned int
+{
+	Update = 0,
+	Render,
+	Present,
+	Sleep,
+};
+constexpr size_t kFramePhaseCount = 4;
+
+//! \brief Time spent in each phase of one frame
+struct FrameTiming {
+	std::array<std::chrono::nanoseconds, kFramePhaseCount> phases;
+
+	auto total() const -> std::chrono::nanoseconds;
+	auto operator[](FramePhase phase) -> std::chrono::nanoseconds&
+	{
+		return phases[static_cast<size_t>(phase)];
+	}
+};
+
+//! \brief Order statistics over the frames in the window
+struct TimingSummary {
+	std::chrono::nanoseconds min, avg, p50, p95, p99, max;
+};
+
+struct FrameStatsReport {
+	size_t frame_count;
+	std::array<TimingSummary, kFramePhaseCount> phases;
+	TimingSummary frame;
+	//! Frame counts per whole millisecond; the last bucket is "or more"
+	std::array<uint32_t, 50> histogram;
+};
+
+/*! \brief Collects per-frame timings of one loop over a rolling window.
+ *
+ * Only the thread running the loop records (beginFrame() / mark() /
+ * endFrame(), or record()); recording costs a clock read per mark and a
+ * few relaxed stores, with no locks or allocation. Any thread may take a
+ * snapshot or a report concurrently; frames being overwritten while the
+ * snapshot is copied are left out of it. */
+class FrameStats : private INonCopyable
+{
+  public:
+	static constexpr size_t kWindowSize = 1024;
+
+	explicit FrameStats(std::string name = "frame");
+
+	/*! \name Recording (owning thread only) \{ */
+	void beginFrame();
+	//! \brief Ends \c phase: it spans the time since the previous mark.
+	void mark(FramePhase phase);
+	void endFrame();
+	void record(const FrameTiming& timing);
+	/*! \} */
+
+	auto getName() const -> const std::string&;
+	auto getRecordedCount() const -> uint64_t;
+
+	//! \brief The frames in the window, oldest first
+	auto snapshot() const -> std::vector<FrameTiming>;
+	auto summarize() const -> FrameStatsReport;
+
+	void writeReport(std::ostream& output) const;
+	/*! \brief Writes the report to \c file_path, replacing its contents
+	 * atomically (see write_file_atomically()). */
+	void dumpToFile(const std::filesystem::path& file_path) const;
+
+  protected:
+	struct Slot {
+		std::array<std::atomic<int64_t>, kFramePhaseCount> phase_ns;
+	};
+
+	// One spare slot, so the writer's next frame never lands on the
+	// oldest frame of the window while it is being copied
+	static constexpr size_t kSlotCount = kWindowSize + 1;
+
+	std::string name;
+
+	std::array<Slot, kSlotCount> slots;
+	std::atomic<uint64_t> write_count{ 0 };
+
+	// Writer-side state of the frame in progress
+	FrameTiming current{};
+	std::chrono::steady_clock::time_point last_mark;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
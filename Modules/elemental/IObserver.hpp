@@ -14,7 +14,11 @@
 namespace elemental {
 
 class Observable;
+template<typename TMessage>
+class TypedObservable;
 
+/*! \brief Receives messages of any type, wrapped in a std::any.
+ * \see ITypedObserver for the allocation-free alternative */
 class IObserver : INonCopyable
 {
   public:
@@ -27,6 +31,23 @@ class IObserver : INonCopyable
 	IObserver() = default;
 };
 
+/*! \brief Receives messages of a single type from a TypedObservable.
+ *
+ * Messages arrive by const reference: no copy, no type erasure, no
+ * allocation. */
+template<typename TMessage>
+class ITypedObserver : INonCopyable
+{
+  public:
+	virtual void recieveMessage(const TypedObservable<TMessage>& sender,
+	                            const TMessage& message) = 0;
+
+	virtual ~ITypedObserver() = default;
+
+  protected:
+	ITypedObserver() = default;
+};
+
 }
 // clang-format off
 // vim: set foldmethod=marker foldmarker=#region,#endregion textwidth=80 ts=8 sts=0 sw=8 noexpandtab ft=cpp.doxygen :
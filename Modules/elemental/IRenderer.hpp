@@ -18,6 +18,7 @@
 
 #include <any>
 #include <memory>
+#include <span>
 #include <type_traits>
 #include <utility>
 
@@ -66,6 +67,20 @@ struct IRenderer
 	virtual void blit(std::shared_ptr<void> image_data,
 	                  Rectangle& placement) = 0;
 
+	/*! \brief Draws the \c source sub-rectangle of an image, such as a
+	 * texture atlas region. Throws exceptions. */
+	virtual void blit(std::shared_ptr<void> image_data,
+	                  const Rectangle& source,
+	                  Rectangle& placement) = 0;
+
+	/*! \brief Draws many sprites at once.
+	 *
+	 * Sprites are grouped by texture, and each group is sent to the
+	 * backend as a single draw call. Sprites that share a texture are
+	 * drawn in submission order; the order between different textures is
+	 * unspecified, so submit one batch per layer. Throws exceptions. */
+	virtual void submitBatch(std::span<const SpriteInstance> sprites) = 0;
+
 	/*! \name DataType Conversion methods
 	 * \brief Conversion functions to convert Rectangle objects to the types
 	 * used by native APIs to update blocks of the screen.
@@ -0,0 +1,31 @@
+/* ISpatialIndex.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "ISpatialIndex.hpp"
+
+#include "LooseQuadtree.hpp"
+#include "SpatialHashGrid.hpp"
+
+using namespace elemental;
+
+auto ISpatialIndex::Create(SpatialIndexKind kind, const Rectangle& world,
+                           uint32_t cell_size)
+    -> std::unique_ptr<ISpatialIndex>
+{
+	switch (kind) {
+	case SpatialIndexKind::LooseQuadtree:
+		return std::make_unique<LooseQuadtree>(world);
+	case SpatialIndexKind::HashGrid:
+	default:
+		return std::make_unique<SpatialHashGrid>(cell_size);
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
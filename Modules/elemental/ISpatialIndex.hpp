@@ -0,0 +1,93 @@
+/* ISpatialIndex.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "types/rendering.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace elemental {
+
+enum class SpatialIndexKind { HashGrid, LooseQuadtree };
+
+/*! \brief Finds entries by their bounding rectangles.
+ *
+ * Entries are small integer ids, such as EntityAllocator indices; storage
+ * grows with the largest id, so ids should be dense. Range and point
+ * queries append to a caller-owned vector, so reusing one keeps them
+ * allocation-free.
+ * Queries on one index may run concurrently; updates may not. */
+class ISpatialIndex
+{
+  public:
+	using EntryID = uint32_t;
+
+	virtual ~ISpatialIndex() = default;
+
+	/*! \brief Creates an empty index of the given kind.
+	 * \param world the area most entries live in; entries outside it
+	 *        still work, only slower
+	 * \param cell_size grid cell edge for HashGrid; ignored otherwise */
+	static auto Create(SpatialIndexKind kind, const Rectangle& world,
+	                   uint32_t cell_size = 128)
+	    -> std::unique_ptr<ISpatialIndex>;
+
+	//! \brief Adds \c id, or moves it if it is already indexed
+	virtual void insert(EntryID id, const Rectangle& bounds) = 0;
+	//! \returns false if \c id is not indexed
+	virtual auto update(EntryID id, const Rectangle& bounds) -> bool = 0;
+	//! \returns false if \c id is not indexed
+	virtual auto remove(EntryID id) -> bool = 0;
+	virtual void clear() = 0;
+
+	virtual auto contains(EntryID id) const -> bool = 0;
+	virtual auto size() const -> size_t = 0;
+	//! \returns the bounds of \c id, or nullptr if it is not indexed
+	virtual auto getBounds(EntryID id) const -> const Rectangle* = 0;
+
+	/*! \brief Appends to \c results every entry whose bounds intersect
+	 * \c area, each once, in no particular order. */
+	virtual void queryRange(const Rectangle& area,
+	                        std::vector<EntryID>& results) const = 0;
+	//! \brief Appends every entry whose bounds contain \c point
+	virtual void queryPoint(Point point,
+	                        std::vector<EntryID>& results) const = 0;
+	/*! \returns the entry whose bounds are closest to \c point (distance
+	 * zero if they contain it), or nothing if no entry lies within
+	 * \c max_distance. Ties go to any of the closest entries. */
+	virtual auto queryNearest(Point point,
+	                          uint32_t max_distance = UINT32_MAX) const
+	    -> std::optional<EntryID> = 0;
+};
+
+//! \brief Squared Euclidean distance from \c point to \c bounds
+constexpr auto squared_distance(Point point, const Rectangle& bounds)
+    -> uint64_t
+{
+	auto axis = [](uint32_t value, uint32_t low, uint32_t high) -> uint64_t {
+		// high is exclusive; an empty range is the single value low
+		auto last = (high > low) ? high - 1 : low;
+		if (value < low) {
+			return low - value;
+		}
+		return (value > last) ? value - last : 0;
+	};
+	auto dx = axis(point.x, bounds.x(), bounds.right());
+	auto dy = axis(point.y, bounds.y(), bounds.bottom());
+	return dx * dx + dy * dy;
+}
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -1,5 +1,5 @@
 /* JsonConfigFile.cpp
- * Copyright © 202t4 Saul D. Beniquez
+ * Copyright © 2024 Saul D. Beniquez
  * License: Mozilla Public License v. 2.0
  *
  * This Source Code Form is subject to the terms of the Mozilla Public License,
@@ -8,6 +8,7 @@
  */
 
 #include "JsonConfigFile.hpp"
+#include "AtomicFile.hpp"
 #include "IOCore/Exception.hpp"
 
 #include <filesystem>
@@ -41,8 +42,9 @@ enum AsciiMode : bool {
 
 namespace elemental::configuration {
 
-JsonConfigFile::JsonConfigFile(const fs::path& file_path, CreateDirs mode)
-    : FileResource(file_path, mode)
+JsonConfigFile::JsonConfigFile(const fs::path& file_path, CreateDirs mode,
+                               JsonStyle style)
+    : FileResource(file_path, mode), config_json(), style(style)
 {
 }
 
@@ -77,37 +79,63 @@ auto JsonConfigFile::read() -> nlohmann::json&
 	return this->config_json;
 }
 
-void JsonConfigFile::write()
+void JsonConfigFile::stream(const JsonPathStream& paths) const
 {
 	try {
-		std::ofstream file_stream(file_path);
+		std::ifstream file_stream(file_path);
+
 		if (!file_stream.is_open()) {
 			error_buffer.str("");
-			error_buffer << "Error opening JsonConfigFile "
-					"for writing: "
-				     << file_path << std::endl;
+			error_buffer
+			    << "Error opening JsonConfigFile for streaming: "
+			    << file_path << std::endl;
 			throw IOCore::Exception(error_buffer.str());
 		}
 
-		file_stream << config_json.dump(
-				   IndentMode::Ident,
-				   '\t',
-				   AsciiMode::IgnoreUnicode,
-				   nlohmann::json::error_handler_t::replace
-			       )
-			    << std::endl;
-
-		return;
+		if (file_stream.peek() != std::ifstream::traits_type::eof()) {
+			paths.parse(file_stream);
+		}
 	} catch (IOCore::Exception& except) {
 		throw;
 	} catch (const std::exception& e) {
+		error_buffer.str("");
+		error_buffer << "JsonConfigFile::Stream() error" << std::endl
+			     << e.what() << std::flush;
+		throw IOCore::Exception(error_buffer.str());
+	}
+}
 
+auto JsonConfigFile::serialize() const -> std::string
+{
+	try {
+		auto indent = (style == JsonStyle::Compact) ? IndentMode::Compact
+		                                            : IndentMode::Ident;
+		auto text = config_json.dump(
+		    indent,
+		    '\t',
+		    AsciiMode::IgnoreUnicode,
+		    nlohmann::json::error_handler_t::replace
+		);
+		text += '\n';
+		return text;
+	} catch (const std::exception& e) {
 		error_buffer.str("");
-		error_buffer << "JSonConfigFile::Save() error: " << std::endl
+		error_buffer << "JsonConfigFile::Serialize() error: " << std::endl
 			     << e.what() << std::flush;
 		throw IOCore::Exception(error_buffer.str());
 	}
 }
+
+void JsonConfigFile::write()
+{
+	// Serialised up front, so a failure cannot leave a partial file
+	write_file_atomically(file_path, this->serialize());
+}
+
+void JsonConfigFile::writeAsync(AsyncFileWriter& writer) const
+{
+	writer.submit(file_path, this->serialize());
+}
 } // namespace elemental::configuration
 
 // clang-format off
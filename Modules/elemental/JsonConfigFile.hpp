@@ -0,0 +1,79 @@
+/* JsonConfigFile.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "AsyncFileWriter.hpp"
+#include "JsonPathStream.hpp"
+
+#include "IOCore/FileResource.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <string>
+
+namespace elemental::configuration {
+
+using IOCore::CreateDirs;
+using IOCore::FileResource;
+
+//! \brief How write() lays out the document
+enum class JsonStyle {
+	Pretty,  //!< tab-indented, for files people edit
+	Compact, //!< one line, for machine-written files
+};
+
+/*! \brief A JSON document on disk.
+ *
+ * read() loads the whole document into memory, where jsonDataRef() and
+ * getJson() expose it by reference; write() saves it back atomically,
+ * or writeAsync() hands it to an AsyncFileWriter. For large
+ * files that are only read, stream() visits just the values a
+ * JsonPathStream selects and keeps nothing in memory. */
+class JsonConfigFile : public FileResource
+{
+  public:
+	JsonConfigFile(const std::filesystem::path& file_path,
+	               CreateDirs mode = CreateDirs::Disabled,
+	               JsonStyle style = JsonStyle::Pretty);
+	virtual ~JsonConfigFile();
+
+	//! \throws IOCore::Exception if the file cannot be read or parsed
+	auto read() -> nlohmann::json&;
+	//! \brief The document as write() would save it
+	auto serialize() const -> std::string;
+	/*! \brief Replaces the file through write_file_atomically().
+	 * \throws IOCore::Exception if the file cannot be written */
+	void write();
+	/*! \brief Serialises now and queues the file on \c writer, which
+	 * reports write errors from its flush(). */
+	void writeAsync(AsyncFileWriter& writer) const;
+
+	auto getStyle() const -> JsonStyle { return style; }
+	void setStyle(JsonStyle new_style) { style = new_style; }
+
+	/*! \brief Parses the file through \c paths without reading it into
+	 * the document; jsonDataRef() is left untouched.
+	 * \throws IOCore::Exception if the file cannot be read or parsed */
+	void stream(const JsonPathStream& paths) const;
+
+	//! \brief The document last read, by reference; bind it as \c auto&
+	auto jsonDataRef() -> nlohmann::json& { return config_json; }
+	auto getJson() const -> const nlohmann::json& { return config_json; }
+
+  protected:
+	nlohmann::json config_json;
+	JsonStyle style;
+};
+
+} // namespace elemental::configuration
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
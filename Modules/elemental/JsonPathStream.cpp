@@ -0,0 +1,291 @@
+/* JsonPathStream.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "JsonPathStream.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <fmt/core.h>
+
+#include <utility>
+
+using nlohmann::json;
+
+namespace elemental {
+
+namespace {
+// JSON pointer escaping: ~ becomes ~0 and / becomes ~1
+auto unescape_segment(std::string_view segment) -> std::string
+{
+	std::string result;
+	result.reserve(segment.size());
+	for (size_t index = 0; index < segment.size(); ++index) {
+		if (segment[index] == '~' && index + 1 < segment.size()) {
+			result += (segment[++index] == '1') ? '/' : '~';
+		} else {
+			result += segment[index];
+		}
+	}
+	return result;
+}
+
+void append_escaped(std::string& path, const std::string& segment)
+{
+	path += '/';
+	for (char character : segment) {
+		if (character == '~') {
+			path += "~0";
+		} else if (character == '/') {
+			path += "~1";
+		} else {
+			path += character;
+		}
+	}
+}
+} // namespace
+
+/* Tracks the path of the value being parsed and builds matched values.
+ *
+ * Every value start (scalar or container) first gets its path segment
+ * from the enclosing container's frame; when nothing is being captured,
+ * that path is checked against the selectors. */
+class JsonPathSax
+{
+  public:
+	using number_integer_t = json::number_integer_t;
+	using number_unsigned_t = json::number_unsigned_t;
+	using number_float_t = json::number_float_t;
+	using string_t = json::string_t;
+	using binary_t = json::binary_t;
+
+	explicit JsonPathSax(const JsonPathStream& stream) : stream(stream) {}
+
+	auto null() -> bool { return this->scalar(nullptr); }
+	auto boolean(bool value) -> bool { return this->scalar(value); }
+	auto number_integer(number_integer_t value) -> bool
+	{
+		return this->scalar(value);
+	}
+	auto number_unsigned(number_unsigned_t value) -> bool
+	{
+		return this->scalar(value);
+	}
+	auto number_float(number_float_t value, const string_t&) -> bool
+	{
+		return this->scalar(value);
+	}
+	auto string(string_t& value) -> bool
+	{
+		return this->scalar(std::move(value));
+	}
+	auto binary(binary_t& value) -> bool
+	{
+		return this->scalar(json::binary(std::move(value)));
+	}
+
+	auto start_object(size_t) -> bool
+	{
+		return this->start_container(json::object(), false);
+	}
+	auto key(string_t& name) -> bool
+	{
+		frames.back().key = std::move(name);
+		return true;
+	}
+	auto end_object() -> bool { return this->end_container(); }
+
+	auto start_array(size_t) -> bool
+	{
+		return this->start_container(json::array(), true);
+	}
+	auto end_array() -> bool { return this->end_container(); }
+
+	auto parse_error(size_t position, const std::string&,
+	                 const json::exception& error) -> bool
+	{
+		throw IOCore::Exception(fmt::format(
+		    "JSON parse error at byte {}: {}", position, error.what()
+		));
+	}
+
+  protected:
+	struct Frame {
+		bool is_array;
+		size_t next_index;
+		std::string key;
+	};
+
+	void enter_value()
+	{
+		if (frames.empty()) {
+			return;
+		}
+		auto& parent = frames.back();
+		if (parent.is_array) {
+			segments.push_back(std::to_string(parent.next_index++));
+		} else {
+			segments.push_back(parent.key);
+		}
+	}
+	void leave_value()
+	{
+		if (!frames.empty()) {
+			segments.pop_back();
+		}
+	}
+
+	auto is_capturing() const -> bool { return handler != nullptr; }
+
+	void try_capture()
+	{
+		for (const auto& selector : stream.selectors) {
+			if (selector.segments.size() != segments.size()) {
+				continue;
+			}
+			bool matches = true;
+			for (size_t index = 0; matches && index < segments.size();
+			     ++index) {
+				const auto& wanted = selector.segments[index];
+				matches = (wanted == "*" || wanted == segments[index]);
+			}
+			if (matches) {
+				handler = &selector.handler;
+				return;
+			}
+		}
+	}
+
+	// Adds a value to the capture, returning where it was stored
+	auto add(json&& value) -> json*
+	{
+		if (builder.empty()) {
+			captured = std::move(value);
+			return &captured;
+		}
+		auto* parent = builder.back();
+		if (parent->is_array()) {
+			parent->push_back(std::move(value));
+			return &parent->back();
+		}
+		auto& slot = (*parent)[frames.back().key];
+		slot = std::move(value);
+		return &slot;
+	}
+
+	void finish_capture()
+	{
+		std::string path;
+		for (const auto& segment : segments) {
+			append_escaped(path, segment);
+		}
+		const auto* finished = std::exchange(handler, nullptr);
+		(*finished)(path, captured);
+		captured = nullptr;
+	}
+
+	auto scalar(json&& value) -> bool
+	{
+		this->enter_value();
+		if (!is_capturing()) {
+			this->try_capture();
+		}
+		if (is_capturing()) {
+			this->add(std::move(value));
+			if (builder.empty()) {
+				this->finish_capture();
+			}
+		}
+		this->leave_value();
+		return true;
+	}
+
+	auto start_container(json&& empty, bool is_array) -> bool
+	{
+		this->enter_value();
+		if (!is_capturing()) {
+			this->try_capture();
+		}
+		if (is_capturing()) {
+			builder.push_back(this->add(std::move(empty)));
+		}
+		frames.push_back({ is_array, 0, {} });
+		return true;
+	}
+
+	auto end_container() -> bool
+	{
+		frames.pop_back();
+		if (is_capturing()) {
+			builder.pop_back();
+			if (builder.empty()) {
+				this->finish_capture();
+			}
+		}
+		this->leave_value();
+		return true;
+	}
+
+	const JsonPathStream& stream;
+
+	std::vector<Frame> frames;
+	std::vector<std::string> segments;
+
+	// The value being captured, while handler is set
+	const JsonPathStream::Handler* handler = nullptr;
+	json captured;
+	std::vector<json*> builder;
+};
+
+auto JsonPathStream::splitPath(std::string_view path)
+    -> std::vector<std::string>
+{
+	// "" is the root; "/a/b" splits into "a", "b"
+	std::vector<std::string> segments;
+	size_t start = 0;
+	while (start < path.size()) {
+		if (path[start] != '/') {
+			throw IOCore::Exception(fmt::format(
+			    "JSON path must start with '/': {}", path
+			));
+		}
+		auto end = path.find('/', start + 1);
+		if (end == std::string_view::npos) {
+			end = path.size();
+		}
+		segments.push_back(
+		    unescape_segment(path.substr(start + 1, end - start - 1))
+		);
+		start = end;
+	}
+	return segments;
+}
+
+auto JsonPathStream::on(std::string_view pattern, Handler handler)
+    -> JsonPathStream&
+{
+	selectors.push_back({ splitPath(pattern), std::move(handler) });
+	return *this;
+}
+
+void JsonPathStream::parse(std::istream& input) const
+{
+	JsonPathSax sax(*this);
+	json::sax_parse(input, &sax);
+}
+
+void JsonPathStream::parse(std::string_view text) const
+{
+	JsonPathSax sax(*this);
+	json::sax_parse(text.begin(), text.end(), &sax);
+}
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,71 @@
+/* JsonPathStream.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace elemental {
+
+/*! \brief Streams a JSON document, materialising only selected values.
+ *
+ * Handlers are registered for path patterns written as JSON pointers,
+ * where a \c * segment matches any key or array index; \c "/layers"
+ * selects one value, and \c "/entities/" plus \c * selects every entity.
+ * While parsing (through nlohmann's SAX interface),
+ * a value whose path matches a pattern is built into a small DOM, passed
+ * to the handler together with its concrete path, and freed; everything
+ * else is skipped without being stored. Memory use is bounded by the
+ * largest matched value, not by the document.
+ *
+ * Patterns are tried in registration order; values nested inside a
+ * matched value are not matched again. The empty pattern \c "" matches
+ * the whole document. */
+class JsonPathStream
+{
+  public:
+	using Handler =
+	    std::function<void(const std::string& path, nlohmann::json& value)>;
+
+	JsonPathStream() = default;
+	virtual ~JsonPathStream() = default;
+
+	//! \brief Calls \c handler for every value matching \c pattern
+	auto on(std::string_view pattern, Handler handler) -> JsonPathStream&;
+
+	//! \throws IOCore::Exception on malformed JSON
+	void parse(std::istream& input) const;
+	void parse(std::string_view text) const;
+
+	/*! \brief Splits a JSON pointer, such as the path passed to a
+	 * handler, into its unescaped keys: "/a~1b/0" gives "a/b", "0".
+	 * \throws IOCore::Exception if \c path does not start with '/' */
+	static auto splitPath(std::string_view path)
+	    -> std::vector<std::string>;
+
+  protected:
+	friend class JsonPathSax;
+
+	struct Selector {
+		std::vector<std::string> segments;
+		Handler handler;
+	};
+	std::vector<Selector> selectors;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -9,15 +9,28 @@
 
 #include "LoopRegulator.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
 using namespace elemental;
 using namespace std::chrono;
 
+namespace {
+/* Typical sleep overshoot is well under a millisecond on Linux and macOS,
+ * but can reach a full timer tick elsewhere. */
+const nanoseconds kDefaultSpinThreshold = 2ms;
+} // namespace
+
 // Constructor with default desired framerate of 30 frames per second
 LoopRegulator::LoopRegulator(uint32_t rate_per_second)
-    : start_time(), end_time(), elapsed_ms(0), desired_delay_ms(0)
+    : start_time()
+    , end_time()
+    , next_deadline()
+    , elapsed_time(0)
+    , desired_period(0)
+    , spin_threshold(kDefaultSpinThreshold)
+    , jitter_samples()
 {
 	this->setRate(rate_per_second);
 }
@@ -31,38 +44,101 @@ void LoopRegulator::startUpdate()
 }
 
 // End the loop update and calculate elapsed time
-auto LoopRegulator::endUpdate() -> std::chrono::milliseconds
+auto LoopRegulator::endUpdate() -> nanoseconds
 {
 	this->end_time = steady_clock::now();
-	this->elapsed_ms = duration_cast<milliseconds>(end_time - start_time);
-	return elapsed_ms;
+	this->elapsed_time = end_time - start_time;
+	return elapsed_time;
 }
 
-void LoopRegulator::setRate(float new_rate)
+void LoopRegulator::setRate(double new_rate)
 {
 	this->desired_rate_per_second = new_rate;
-	this->desired_delay_ms =
-	    duration_cast<milliseconds>(seconds(1) / new_rate);
+	this->desired_period =
+	    duration_cast<nanoseconds>(duration<double>(1.0 / new_rate));
+	this->reset();
 }
 
-// Delay the loop to achieve the desired framerate
-auto LoopRegulator::delay() -> milliseconds
+void LoopRegulator::setSpinThreshold(nanoseconds threshold)
+{
+	this->spin_threshold = threshold;
+}
+
+void LoopRegulator::reset()
 {
+	this->next_deadline = steady_clock::time_point();
+}
 
+// Delay the loop to achieve the desired framerate
+auto LoopRegulator::delay() -> nanoseconds
+{
 	if (end_time == steady_clock::time_point()) {
 		this->endUpdate();
 	}
+	if (next_deadline == steady_clock::time_point()) {
+		next_deadline = start_time + desired_period;
+	}
+
+	auto before_wait = steady_clock::now();
+	auto woke_at = before_wait;
+	if (before_wait < next_deadline) {
+		this->wait_until(next_deadline);
+		woke_at = steady_clock::now();
+	}
+	this->record_jitter(woke_at - next_deadline);
+
+	// Late by more than a whole frame: start a fresh schedule rather
+	// than running frames back-to-back to catch up.
+	next_deadline += desired_period;
+	if (woke_at >= next_deadline) {
+		next_deadline = woke_at + desired_period;
+	}
+
+	return woke_at - before_wait;
+}
+
+void LoopRegulator::wait_until(steady_clock::time_point deadline)
+{
+	auto coarse_deadline = deadline - spin_threshold;
+	if (steady_clock::now() < coarse_deadline) {
+		std::this_thread::sleep_until(coarse_deadline);
+	}
+	while (steady_clock::now() < deadline) {
+		std::this_thread::yield();
+	}
+}
 
-	// Calculate the remaining time to dela
-	auto remaining_delay_ms = this->desired_delay_ms - this->elapsed_ms;
+void LoopRegulator::record_jitter(nanoseconds lateness)
+{
+	jitter_samples[jitter_sample_count % kJitterWindow] = lateness;
+	++jitter_sample_count;
+}
 
-	// Check if delay is needed
-	if (remaining_delay_ms.count() > 0.0) {
-		std::this_thread::sleep_for(remaining_delay_ms);
-		return remaining_delay_ms;
-	} else {
-		return milliseconds(0);
+auto LoopRegulator::getPeriod() const -> nanoseconds
+{
+	return this->desired_period;
+}
+
+auto LoopRegulator::getJitterStats() const -> JitterStats
+{
+	auto count = std::min(jitter_sample_count, kJitterWindow);
+	if (count == 0) {
+		return { nanoseconds(0), nanoseconds(0), nanoseconds(0), 0 };
 	}
+
+	auto samples = jitter_samples;
+	auto end = samples.begin() + count;
+	nanoseconds total(0);
+	for (auto iter = samples.begin(); iter != end; ++iter) {
+		total += *iter;
+	}
+
+	// Nearest rank: the ceil(0.99 * count)-th smallest sample
+	auto p99 = samples.begin() + ((count * 99 + 99) / 100 - 1);
+	std::nth_element(samples.begin(), p99, end);
+
+	return { total / count, *p99, *std::max_element(samples.begin(), end),
+		 count };
 }
 
 // clang-format off
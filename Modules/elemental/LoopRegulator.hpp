@@ -10,6 +10,7 @@
 #pragma once
 
 #include <SDL.h>
+#include <array>
 #include <chrono>
 #include <ratio>
 #include <thread>
@@ -20,6 +21,21 @@ using namespace std::chrono;
 
 namespace elemental {
 
+//! \brief How late delay() woke up, over the most recent frames
+struct JitterStats {
+	nanoseconds mean;
+	nanoseconds p99;
+	nanoseconds max;
+	size_t sample_count;
+};
+
+/*! \brief Paces a loop to a fixed rate.
+ *
+ * Every call to delay() waits for an absolute deadline that advances by
+ * exactly one period per frame, so rounding and oversleeping do not
+ * accumulate into drift. The wait sleeps until shortly before the deadline
+ * and then yields in a loop for the remainder, since sleep_for() may
+ * overshoot by a scheduler tick. */
 class LoopRegulator
 {
   public:
@@ -31,22 +47,45 @@ class LoopRegulator
 	void startUpdate();
 
 	// End the loop update and calculate elapsed time
-	auto endUpdate() -> milliseconds;
+	auto endUpdate() -> nanoseconds;
+
+	void setRate(double new_rate);
+
+	/*! \brief How long before each deadline to stop sleeping and start
+	 * spinning. Larger values cost CPU time but absorb coarser OS timers.
+	 */
+	void setSpinThreshold(nanoseconds threshold);
 
-	void setRate(float new_rate);
+	/*! \brief Waits for the next frame deadline.
+	 * \returns how long it waited; zero when the frame ran late */
+	auto delay() -> nanoseconds;
 
-	// Delay the loop to achieve the desired framerate
-	auto delay() -> milliseconds;
+	/*! \brief Forgets the deadline schedule, e.g. after a pause, so the
+	 * loop does not try to catch up on missed frames. */
+	void reset();
+
+	auto getPeriod() const -> nanoseconds;
+	auto getJitterStats() const -> JitterStats;
+
+	static constexpr size_t kJitterWindow = 512;
 #ifndef UNIT_TEST
   protected:
 #endif
-	uint32_t desired_rate_per_second{ 0 };
+	void wait_until(steady_clock::time_point deadline);
+	void record_jitter(nanoseconds lateness);
+
+	double desired_rate_per_second{ 0 };
 
 	steady_clock::time_point start_time;
 	steady_clock::time_point end_time;
+	steady_clock::time_point next_deadline;
+
+	nanoseconds elapsed_time;
+	nanoseconds desired_period;
+	nanoseconds spin_threshold;
 
-	milliseconds elapsed_ms;
-	milliseconds desired_delay_ms;
+	std::array<nanoseconds, kJitterWindow> jitter_samples;
+	size_t jitter_sample_count{ 0 };
 };
 } // namespace elemental
   // clang-format off
@@ -0,0 +1,291 @@
+/* LooseQuadtree.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "LooseQuadtree.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+using namespace elemental;
+
+namespace {
+//! \c bounds grown by half its size on every side, clamped to uint32_t
+auto loosen(const Rectangle& bounds) -> Rectangle
+{
+	const int64_t kMax = UINT32_MAX;
+	auto left = std::max<int64_t>(int64_t{ bounds.x() } - bounds.width() / 2, 0);
+	auto top =
+	    std::max<int64_t>(int64_t{ bounds.y() } - bounds.height() / 2, 0);
+	auto right = std::min<int64_t>(
+	    int64_t{ bounds.x() } + bounds.width() + bounds.width() / 2, kMax
+	);
+	auto bottom = std::min<int64_t>(
+	    int64_t{ bounds.y() } + bounds.height() + bounds.height() / 2, kMax
+	);
+	return { { static_cast<uint32_t>(left), static_cast<uint32_t>(top) },
+		 { static_cast<uint32_t>(right - left),
+		   static_cast<uint32_t>(bottom - top) } };
+}
+} // namespace
+
+LooseQuadtree::LooseQuadtree(const Rectangle& world, uint32_t max_depth)
+    : world(world)
+    , max_depth(std::min(max_depth, kMaxDepthLimit))
+    , nodes()
+    , entries()
+    , entry_count(0)
+{
+	this->make_node(world, kNoNode, 0);
+}
+
+auto LooseQuadtree::make_node(const Rectangle& bounds, int32_t parent,
+                              uint32_t depth) -> int32_t
+{
+	nodes.push_back({ bounds,
+	                  loosen(bounds),
+	                  parent,
+	                  { kNoNode, kNoNode, kNoNode, kNoNode },
+	                  depth,
+	                  0,
+	                  {} });
+	return static_cast<int32_t>(nodes.size() - 1);
+}
+
+auto LooseQuadtree::child_of(int32_t node, unsigned quadrant) -> int32_t
+{
+	if (nodes[node].children[quadrant] != kNoNode) {
+		return nodes[node].children[quadrant];
+	}
+
+	// Quadrants: 0 top-left, 1 top-right, 2 bottom-left, 3 bottom-right
+	const auto kParent = nodes[node].bounds;
+	auto half_width = kParent.width() / 2;
+	auto half_height = kParent.height() / 2;
+	bool is_right = (quadrant & 1) != 0;
+	bool is_bottom = (quadrant & 2) != 0;
+	Rectangle bounds{
+		{ kParent.x() + (is_right ? half_width : 0),
+		  kParent.y() + (is_bottom ? half_height : 0) },
+		{ is_right ? kParent.width() - half_width : half_width,
+		  is_bottom ? kParent.height() - half_height : half_height }
+	};
+
+	// make_node() may reallocate nodes, so no references are held here
+	auto child = this->make_node(bounds, node, nodes[node].depth + 1);
+	nodes[node].children[quadrant] = child;
+	return child;
+}
+
+auto LooseQuadtree::node_for(const Rectangle& bounds) -> int32_t
+{
+	uint64_t center_x = uint64_t{ bounds.x() } + bounds.width() / 2;
+	uint64_t center_y = uint64_t{ bounds.y() } + bounds.height() / 2;
+	if (!world.contains(Point{ static_cast<uint32_t>(center_x),
+	                           static_cast<uint32_t>(center_y) }) ||
+	    center_x > UINT32_MAX || center_y > UINT32_MAX) {
+		return 0;
+	}
+
+	int32_t node = 0;
+	while (nodes[node].depth < max_depth) {
+		const auto& current = nodes[node].bounds;
+		auto half_width = current.width() / 2;
+		auto half_height = current.height() / 2;
+		// A child is no smaller than half its parent; the entry must
+		// fit in that to stay inside the child's loose bounds
+		if (half_width == 0 || half_height == 0 ||
+		    bounds.width() > half_width || bounds.height() > half_height) {
+			break;
+		}
+		unsigned quadrant = (center_x >= current.x() + half_width ? 1 : 0) |
+		                    (center_y >= current.y() + half_height ? 2 : 0);
+		node = this->child_of(node, quadrant);
+	}
+	return node;
+}
+
+void LooseQuadtree::attach(EntryID id, int32_t node)
+{
+	auto& entry = entries[id];
+	entry.node = node;
+	entry.slot = static_cast<uint32_t>(nodes[node].items.size());
+	nodes[node].items.push_back(id);
+	for (auto current = node; current != kNoNode;
+	     current = nodes[current].parent) {
+		++nodes[current].subtree_count;
+	}
+}
+
+void LooseQuadtree::detach(EntryID id)
+{
+	auto& entry = entries[id];
+	auto& items = nodes[entry.node].items;
+	ASSERT(entry.slot < items.size() && items[entry.slot] == id);
+
+	// Swap-and-pop, fixing the slot of the moved entry
+	auto moved = items.back();
+	items[entry.slot] = moved;
+	entries[moved].slot = entry.slot;
+	items.pop_back();
+
+	for (auto current = entry.node; current != kNoNode;
+	     current = nodes[current].parent) {
+		--nodes[current].subtree_count;
+	}
+	entry.node = kNoNode;
+}
+
+void LooseQuadtree::insert(EntryID id, const Rectangle& bounds)
+{
+	if (this->update(id, bounds)) {
+		return;
+	}
+	if (id >= entries.size()) {
+		entries.resize(static_cast<size_t>(id) + 1,
+		               { {}, kNoNode, 0, false });
+	}
+	entries[id].bounds = bounds;
+	entries[id].is_present = true;
+	this->attach(id, this->node_for(bounds));
+	++entry_count;
+}
+
+auto LooseQuadtree::update(EntryID id, const Rectangle& bounds) -> bool
+{
+	if (!this->contains(id)) {
+		return false;
+	}
+	auto node = this->node_for(bounds);
+	entries[id].bounds = bounds;
+	if (node != entries[id].node) {
+		this->detach(id);
+		this->attach(id, node);
+	}
+	return true;
+}
+
+auto LooseQuadtree::remove(EntryID id) -> bool
+{
+	if (!this->contains(id)) {
+		return false;
+	}
+	this->detach(id);
+	entries[id].is_present = false;
+	--entry_count;
+	return true;
+}
+
+void LooseQuadtree::clear()
+{
+	nodes.clear();
+	entries.clear();
+	entry_count = 0;
+	this->make_node(world, kNoNode, 0);
+}
+
+auto LooseQuadtree::contains(EntryID id) const -> bool
+{
+	return id < entries.size() && entries[id].is_present;
+}
+
+auto LooseQuadtree::getBounds(EntryID id) const -> const Rectangle*
+{
+	return this->contains(id) ? &entries[id].bounds : nullptr;
+}
+
+void LooseQuadtree::queryRange(const Rectangle& area,
+                               std::vector<EntryID>& results) const
+{
+	if (area.isEmpty()) {
+		return;
+	}
+
+	// Depth-first, at most three siblings waiting per level
+	std::array<int32_t, 4 * kMaxDepthLimit + 4> pending;
+	size_t pending_count = 0;
+	pending[pending_count++] = 0;
+
+	while (pending_count > 0) {
+		const auto& node = nodes[pending[--pending_count]];
+		for (auto id : node.items) {
+			if (entries[id].bounds.intersects(area)) {
+				results.push_back(id);
+			}
+		}
+		for (auto child : node.children) {
+			if (child != kNoNode && nodes[child].subtree_count > 0 &&
+			    nodes[child].loose_bounds.intersects(area)) {
+				pending[pending_count++] = child;
+			}
+		}
+	}
+}
+
+void LooseQuadtree::queryPoint(Point point,
+                               std::vector<EntryID>& results) const
+{
+	this->queryRange({ point, { 1, 1 } }, results);
+}
+
+void LooseQuadtree::nearest_in(int32_t node, Point point,
+                               uint64_t& best_distance,
+                               std::optional<EntryID>& best) const
+{
+	const auto& current = nodes[node];
+	for (auto id : current.items) {
+		auto distance = squared_distance(point, entries[id].bounds);
+		if (distance < best_distance) {
+			best_distance = distance;
+			best = id;
+		}
+	}
+
+	// Closest children first; every entry of a child lies within its
+	// loose bounds, so a child farther than the best so far is skipped
+	std::array<std::pair<uint64_t, int32_t>, 4> order;
+	size_t count = 0;
+	for (auto child : current.children) {
+		if (child != kNoNode && nodes[child].subtree_count > 0) {
+			order[count++] = {
+				squared_distance(point, nodes[child].loose_bounds),
+				child
+			};
+		}
+	}
+	// Insertion sort; there are at most four children
+	for (size_t index = 1; index < count; ++index) {
+		for (auto slot = index;
+		     slot > 0 && order[slot].first < order[slot - 1].first; --slot) {
+			std::swap(order[slot], order[slot - 1]);
+		}
+	}
+	for (size_t index = 0; index < count; ++index) {
+		if (order[index].first >= best_distance) {
+			break;
+		}
+		this->nearest_in(order[index].second, point, best_distance, best);
+	}
+}
+
+auto LooseQuadtree::queryNearest(Point point, uint32_t max_distance) const
+    -> std::optional<EntryID>
+{
+	std::optional<EntryID> best;
+	// Searching with the limit as the starting best prunes early
+	uint64_t best_distance =
+	    static_cast<uint64_t>(max_distance) * max_distance + 1;
+	this->nearest_in(0, point, best_distance, best);
+	return best;
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,96 @@
+/* LooseQuadtree.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "ISpatialIndex.hpp"
+
+#include <vector>
+
+namespace elemental {
+
+/*! \brief Loose quadtree over a fixed world rectangle.
+ *
+ * Each node's "loose" bounds are its quadrant grown by half its size on
+ * every side. An entry lives in exactly one node: the deepest one no
+ * smaller than the entry whose quadrant holds the entry's center, which
+ * guarantees the entry lies within that node's loose bounds. Entries of
+ * any size therefore cost one list slot, and moving an entry only touches
+ * the tree when its center crosses into another quadrant.
+ *
+ * Entries outside the world rectangle are kept in the root and checked
+ * on every query. Nodes are created on demand and kept until clear(). */
+class LooseQuadtree : public ISpatialIndex
+{
+  public:
+	static constexpr uint32_t kMaxDepthLimit = 16;
+
+	explicit LooseQuadtree(const Rectangle& world, uint32_t max_depth = 10);
+	~LooseQuadtree() override = default;
+
+	void insert(EntryID id, const Rectangle& bounds) override;
+	auto update(EntryID id, const Rectangle& bounds) -> bool override;
+	auto remove(EntryID id) -> bool override;
+	void clear() override;
+
+	auto contains(EntryID id) const -> bool override;
+	auto size() const -> size_t override { return entry_count; }
+	auto getBounds(EntryID id) const -> const Rectangle* override;
+
+	void queryRange(const Rectangle& area,
+	                std::vector<EntryID>& results) const override;
+	void queryPoint(Point point,
+	                std::vector<EntryID>& results) const override;
+	auto queryNearest(Point point, uint32_t max_distance = UINT32_MAX) const
+	    -> std::optional<EntryID> override;
+
+	auto getWorld() const -> const Rectangle& { return world; }
+	auto getNodeCount() const -> size_t { return nodes.size(); }
+
+  protected:
+	static constexpr int32_t kNoNode = -1;
+
+	struct Node {
+		Rectangle bounds;
+		Rectangle loose_bounds;
+		int32_t parent;
+		int32_t children[4];
+		uint32_t depth;
+		//! Entries in this node and all below it, for pruning
+		uint32_t subtree_count;
+		std::vector<EntryID> items;
+	};
+	struct Entry {
+		Rectangle bounds;
+		int32_t node;
+		uint32_t slot; //!< index in the node's items
+		bool is_present;
+	};
+
+	auto make_node(const Rectangle& bounds, int32_t parent, uint32_t depth)
+	    -> int32_t;
+	auto child_of(int32_t node, unsigned quadrant) -> int32_t;
+	auto node_for(const Rectangle& bounds) -> int32_t;
+	void attach(EntryID id, int32_t node);
+	void detach(EntryID id);
+
+	void nearest_in(int32_t node, Point point, uint64_t& best_distance,
+	                std::optional<EntryID>& best) const;
+
+	Rectangle world;
+	uint32_t max_depth;
+	std::vector<Node> nodes;
+	std::vector<Entry> entries;
+	size_t entry_count;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
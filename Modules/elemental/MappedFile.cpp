@@ -0,0 +1,158 @@
+/* MappedFile.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "MappedFile.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <fmt/core.h>
+
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace elemental;
+namespace fs = std::filesystem;
+
+namespace {
+[[noreturn]] void throw_map_error(const fs::path& file_path,
+                                  const char* what)
+{
+	throw IOCore::Exception(
+	    fmt::format("Could not map {}: {}", file_path.string(), what)
+	);
+}
+} // namespace
+
+#ifdef _WIN32
+MappedFile::MappedFile(const fs::path& file_path)
+    : data(nullptr), size(0), mapping_handle(nullptr)
+{
+	HANDLE file = CreateFileW(file_path.c_str(),
+	                          GENERIC_READ,
+	                          FILE_SHARE_READ,
+	                          nullptr,
+	                          OPEN_EXISTING,
+	                          FILE_ATTRIBUTE_NORMAL,
+	                          nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw_map_error(file_path, "cannot open file");
+	}
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size)) {
+		CloseHandle(file);
+		throw_map_error(file_path, "cannot read file size");
+	}
+	size = static_cast<size_t>(file_size.QuadPart);
+	if (size == 0) {
+		CloseHandle(file);
+		return;
+	}
+
+	mapping_handle =
+	    CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping_handle == nullptr) {
+		throw_map_error(file_path, "CreateFileMapping failed");
+	}
+	data = static_cast<const std::byte*>(
+	    MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0)
+	);
+	if (data == nullptr) {
+		CloseHandle(mapping_handle);
+		throw_map_error(file_path, "MapViewOfFile failed");
+	}
+}
+
+void MappedFile::unmap()
+{
+	if (data != nullptr) {
+		UnmapViewOfFile(data);
+	}
+	if (mapping_handle != nullptr) {
+		CloseHandle(mapping_handle);
+	}
+	data = nullptr;
+	size = 0;
+	mapping_handle = nullptr;
+}
+#else
+MappedFile::MappedFile(const fs::path& file_path) : data(nullptr), size(0)
+{
+	int file = ::open(file_path.c_str(), O_RDONLY);
+	if (file < 0) {
+		throw_map_error(file_path, "cannot open file");
+	}
+	struct stat info {};
+	if (::fstat(file, &info) != 0) {
+		::close(file);
+		throw_map_error(file_path, "cannot read file size");
+	}
+	size = static_cast<size_t>(info.st_size);
+	if (size == 0) {
+		::close(file);
+		return;
+	}
+
+	void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+	// The mapping keeps its own reference to the file
+	::close(file);
+	if (mapped == MAP_FAILED) {
+		size = 0;
+		throw_map_error(file_path, "mmap failed");
+	}
+	data = static_cast<const std::byte*>(mapped);
+}
+
+void MappedFile::unmap()
+{
+	if (data != nullptr) {
+		::munmap(const_cast<std::byte*>(data), size);
+	}
+	data = nullptr;
+	size = 0;
+}
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data(std::exchange(other.data, nullptr))
+    , size(std::exchange(other.size, 0))
+#ifdef _WIN32
+    , mapping_handle(std::exchange(other.mapping_handle, nullptr))
+#endif
+{
+}
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile&
+{
+	if (this != &other) {
+		this->unmap();
+		data = std::exchange(other.data, nullptr);
+		size = std::exchange(other.size, 0);
+#ifdef _WIN32
+		mapping_handle = std::exchange(other.mapping_handle, nullptr);
+#endif
+	}
+	return *this;
+}
+
+MappedFile::~MappedFile()
+{
+	this->unmap();
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
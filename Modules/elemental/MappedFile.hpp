@@ -0,0 +1,53 @@
+/* MappedFile.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "INonCopyable.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace elemental {
+
+/*! \brief Read-only memory mapping of a whole file.
+ *
+ * Pages are loaded by the OS on first touch, so opening is cheap no matter
+ * the file size. The mapping lasts as long as the object; moving it
+ * transfers ownership. */
+class MappedFile : private INonCopyable
+{
+  public:
+	//! \throws IOCore::Exception if the file cannot be opened or mapped
+	explicit MappedFile(const std::filesystem::path& file_path);
+	MappedFile(MappedFile&& other) noexcept;
+	auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+	virtual ~MappedFile();
+
+	auto getData() const -> std::span<const std::byte>
+	{
+		return { data, size };
+	}
+	auto getSize() const -> size_t { return size; }
+
+  protected:
+	void unmap();
+
+	const std::byte* data;
+	size_t size;
+#ifdef _WIN32
+	void* mapping_handle;
+#endif
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
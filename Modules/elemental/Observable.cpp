@@ -15,18 +15,31 @@
 
 namespace elemental {
 
-void
+auto
 Observable::registerObserver(Observable::ObserverRef observer)
+    -> ObserverHandle
+{
+	return this->observers.add(observer.get());
+}
+
+auto
+Observable::unregisterObserver(ObserverHandle handle) -> bool
+{
+	return this->observers.remove(handle);
+}
+
+auto
+Observable::subscribe(IObserver& observer) -> Subscription
 {
-	this->observers.push_back(observer);
+	return this->observers.subscribe(observer);
 }
 
 void
 Observable::notify_all(std::any message)
 {
-	for (auto& observer_ref : this->observers) {
-		observer_ref.get().recieveMessage(*this, message);
-	}
+	this->observers.forEach([&](IObserver& observer) {
+		observer.recieveMessage(*this, message);
+	});
 }
 } // namespace elemental
 
@@ -9,19 +9,28 @@
 
 #pragma once
 
+#include "IObserver.hpp"
+#include "ObserverRegistry.hpp"
+
 #include <any>
 #include <functional>
-#include <list>
 
 namespace elemental {
 
 class IObserver;
+template<typename TMessage>
+class ITypedObserver;
 
+/*! \brief Sends std::any messages to registered IObservers.
+ *
+ * Observers can be registered for the lifetime of the Observable, removed
+ * by handle, or tied to a Subscription that unregisters them on
+ * destruction. Unregistering from inside recieveMessage() is safe. */
 class Observable
 {
   public:
 	using ObserverRef = std::reference_wrapper<IObserver>;
-	using ObserverList = std::list<ObserverRef>;
+	using ObserverList = ObserverRegistry<IObserver>;
 
 	/** \name Deleteed Constructors & Operators
 	 * \{ */
@@ -33,7 +42,9 @@ class Observable
 
 	virtual ~Observable() = default;
 
-	void registerObserver(ObserverRef);
+	auto registerObserver(ObserverRef) -> ObserverHandle;
+	auto unregisterObserver(ObserverHandle) -> bool;
+	[[nodiscard]] auto subscribe(IObserver&) -> Subscription;
 
   protected:
 	Observable() = default;
@@ -41,6 +52,49 @@ class Observable
 	ObserverList observers;
 };
 
+/*! \brief Observable that sends a single message type to ITypedObservers.
+ *
+ * notify_all() hands every observer the same const reference. A class can
+ * derive from both Observable and TypedObservable to serve legacy
+ * std::any observers alongside typed ones. */
+template<typename TMessage>
+class TypedObservable
+{
+  public:
+	using ObserverType = ITypedObserver<TMessage>;
+
+	TypedObservable(const TypedObservable&) = default;
+	TypedObservable(TypedObservable&&) = delete;
+	auto operator=(const TypedObservable&) -> TypedObservable& = default;
+	auto operator=(TypedObservable&&) -> TypedObservable& = delete;
+
+	virtual ~TypedObservable() = default;
+
+	auto registerObserver(ObserverType& observer) -> ObserverHandle
+	{
+		return this->typed_observers.add(observer);
+	}
+	auto unregisterObserver(ObserverHandle handle) -> bool
+	{
+		return this->typed_observers.remove(handle);
+	}
+	[[nodiscard]] auto subscribe(ObserverType& observer) -> Subscription
+	{
+		return this->typed_observers.subscribe(observer);
+	}
+
+  protected:
+	TypedObservable() = default;
+
+	void notify_all(const TMessage& message)
+	{
+		this->typed_observers.forEach([&](ObserverType& observer) {
+			observer.recieveMessage(*this, message);
+		});
+	}
+	ObserverRegistry<ObserverType> typed_observers;
+};
+
 } // namespace elemental
   // clang-format off
 // vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,316 @@
+/* ObserverRegistry.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace elemental {
+
+/*! \brief Identifies one registration in an ObserverRegistry.
+ *
+ * Handles carry a generation, so a handle whose observer was already
+ * removed never matches a later registration that reuses its slot. */
+struct ObserverHandle {
+	static constexpr uint32_t kInvalidSlot = UINT32_MAX;
+
+	uint32_t slot{ kInvalidSlot };
+	uint32_t generation{ 0 };
+
+	constexpr auto isValid() const -> bool { return slot != kInvalidSlot; }
+};
+
+//! \brief What a Subscription needs to remove itself from its registry
+class IObserverSlots
+{
+  public:
+	virtual ~IObserverSlots() = default;
+	virtual auto remove(ObserverHandle handle) -> bool = 0;
+};
+
+/*! \brief Unregisters its observer when destroyed (RAII).
+ *
+ * Holds the registry weakly, so a Subscription may safely outlive the
+ * Observable it came from. */
+class Subscription
+{
+  public:
+	Subscription() = default;
+	Subscription(std::weak_ptr<IObserverSlots> registry,
+	             ObserverHandle handle)
+	    : registry(std::move(registry)), handle(handle)
+	{
+	}
+	~Subscription() { reset(); }
+
+	Subscription(const Subscription&) = delete;
+	auto operator=(const Subscription&) -> Subscription& = delete;
+
+	Subscription(Subscription&& other) noexcept
+	    : registry(std::move(other.registry))
+	    , handle(std::exchange(other.handle, {}))
+	{
+	}
+	auto operator=(Subscription&& other) noexcept -> Subscription&
+	{
+		if (this != &other) {
+			reset();
+			registry = std::move(other.registry);
+			handle = std::exchange(other.handle, {});
+		}
+		return *this;
+	}
+
+	//! \brief Unregisters now instead of at destruction.
+	void reset()
+	{
+		if (auto slots = registry.lock(); slots && handle.isValid()) {
+			slots->remove(handle);
+		}
+		registry.reset();
+		handle = {};
+	}
+
+	auto getHandle() const -> ObserverHandle { return handle; }
+	auto isActive() const -> bool
+	{
+		return handle.isValid() && !registry.expired();
+	}
+
+  protected:
+	std::weak_ptr<IObserverSlots> registry;
+	ObserverHandle handle;
+};
+
+/*! \brief Contiguous set of observer pointers with O(1) add and remove.
+ *
+ * Observers live in a dense vector and are addressed through
+ * slot + generation handles. Removal swaps the last observer into the
+ * freed position; removals requested while forEach() is running only blank
+ * the entry and are compacted once the outermost iteration ends, so an
+ * observer may unsubscribe itself (or others) while being notified.
+ *
+ * Observers are visited in registration order until the first removal.
+ * Observers added during forEach() are not visited by that iteration. */
+template<typename TObserver>
+class ObserverRegistry
+{
+  public:
+	ObserverRegistry() : core(std::make_shared<Core>()) {}
+	ObserverRegistry(const ObserverRegistry& other)
+	    : core(std::make_shared<Core>(other.core->copyLive()))
+	{
+	}
+	auto operator=(const ObserverRegistry& other) -> ObserverRegistry&
+	{
+		if (this != &other) {
+			core->clear();
+			core = std::make_shared<Core>(other.core->copyLive());
+		}
+		return *this;
+	}
+	~ObserverRegistry() = default;
+
+	auto add(TObserver& observer) -> ObserverHandle
+	{
+		return core->add(observer);
+	}
+	auto remove(ObserverHandle handle) -> bool
+	{
+		return core->remove(handle);
+	}
+	//! \brief Like add(), but removes the observer when the result dies
+	[[nodiscard]] auto subscribe(TObserver& observer) -> Subscription
+	{
+		return { core, core->add(observer) };
+	}
+
+	auto contains(ObserverHandle handle) const -> bool
+	{
+		return core->contains(handle);
+	}
+	auto size() const -> size_t { return core->live_count; }
+	auto empty() const -> bool { return core->live_count == 0; }
+	void clear() { core->clear(); }
+
+	template<typename TFunction>
+	void forEach(TFunction&& function)
+	{
+		// Keeps the core alive even if an observer destroys us
+		auto pinned = core;
+		IterationScope scope(*pinned);
+
+		const size_t kCount = pinned->dense.size();
+		for (size_t index = 0; index < kCount; ++index) {
+			if (auto* observer = pinned->dense[index]) {
+				function(*observer);
+			}
+		}
+	}
+
+  protected:
+	static constexpr uint32_t kNoDenseIndex = UINT32_MAX;
+
+	struct Slot {
+		uint32_t dense_index;
+		uint32_t generation;
+	};
+
+	struct Core : public IObserverSlots {
+		std::vector<TObserver*> dense;
+		std::vector<uint32_t> dense_slots;
+		std::vector<Slot> slots;
+		std::vector<uint32_t> free_slots;
+		unsigned iteration_depth{ 0 };
+		bool has_blanks{ false };
+		size_t live_count{ 0 };
+
+		auto add(TObserver& observer) -> ObserverHandle
+		{
+			uint32_t slot;
+			if (free_slots.empty()) {
+				slot = static_cast<uint32_t>(slots.size());
+				slots.push_back({ kNoDenseIndex, 0 });
+			} else {
+				slot = free_slots.back();
+				free_slots.pop_back();
+			}
+
+			slots[slot].dense_index =
+			    static_cast<uint32_t>(dense.size());
+			dense.push_back(&observer);
+			dense_slots.push_back(slot);
+			++live_count;
+
+			return { slot, slots[slot].generation };
+		}
+
+		auto contains(ObserverHandle handle) const -> bool
+		{
+			return handle.slot < slots.size() &&
+			       slots[handle.slot].generation ==
+			           handle.generation &&
+			       slots[handle.slot].dense_index != kNoDenseIndex;
+		}
+
+		auto remove(ObserverHandle handle) -> bool override
+		{
+			if (!contains(handle)) {
+				return false;
+			}
+			auto& slot = slots[handle.slot];
+			auto dense_index = slot.dense_index;
+
+			slot.dense_index = kNoDenseIndex;
+			++slot.generation;
+			free_slots.push_back(handle.slot);
+			--live_count;
+
+			if (iteration_depth > 0) {
+				dense[dense_index] = nullptr;
+				has_blanks = true;
+			} else {
+				swap_and_pop(dense_index);
+			}
+			return true;
+		}
+
+		void clear()
+		{
+			if (iteration_depth > 0) {
+				for (size_t index = 0; index < dense.size();
+				     ++index) {
+					if (dense[index] != nullptr) {
+						auto slot = dense_slots[index];
+						remove({ slot,
+						         slots[slot].generation });
+					}
+				}
+				return;
+			}
+
+			for (uint32_t slot : dense_slots) {
+				slots[slot].dense_index = kNoDenseIndex;
+				++slots[slot].generation;
+				free_slots.push_back(slot);
+			}
+			dense.clear();
+			dense_slots.clear();
+			live_count = 0;
+		}
+
+		void swap_and_pop(uint32_t dense_index)
+		{
+			auto last_index = dense.size() - 1;
+			if (dense_index != last_index) {
+				dense[dense_index] = dense[last_index];
+				dense_slots[dense_index] = dense_slots[last_index];
+				slots[dense_slots[dense_index]].dense_index =
+				    dense_index;
+			}
+			dense.pop_back();
+			dense_slots.pop_back();
+		}
+
+		// Drops blanked entries, keeping the survivors in order
+		void compact()
+		{
+			size_t kept = 0;
+			for (size_t index = 0; index < dense.size(); ++index) {
+				if (dense[index] == nullptr) {
+					continue;
+				}
+				dense[kept] = dense[index];
+				dense_slots[kept] = dense_slots[index];
+				slots[dense_slots[kept]].dense_index =
+				    static_cast<uint32_t>(kept);
+				++kept;
+			}
+			dense.resize(kept);
+			dense_slots.resize(kept);
+			has_blanks = false;
+		}
+
+		// Fresh state holding the same observers, for copies
+		auto copyLive() const -> Core
+		{
+			Core copy;
+			for (auto* observer : dense) {
+				if (observer != nullptr) {
+					copy.add(*observer);
+				}
+			}
+			return copy;
+		}
+	};
+
+	struct IterationScope {
+		explicit IterationScope(Core& core) : core(core)
+		{
+			++core.iteration_depth;
+		}
+		~IterationScope()
+		{
+			if (--core.iteration_depth == 0 && core.has_blanks) {
+				core.compact();
+			}
+		}
+		Core& core;
+	};
+
+	std::shared_ptr<Core> core;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
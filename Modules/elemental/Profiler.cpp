@@ -0,0 +1,182 @@
+/* Profiler.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "Profiler.hpp"
+
+#include "AtomicFile.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <sstream>
+
+using namespace elemental;
+using namespace std::chrono;
+
+namespace {
+// Zone and thread names are expected to be plain identifiers, but a stray
+// quote or backslash must not produce an unreadable trace.
+auto escape_json(const std::string_view text) -> std::string
+{
+	std::string escaped;
+	escaped.reserve(text.size());
+	for (char character : text) {
+		if (character == '"' || character == '\\') {
+			escaped.push_back('\\');
+		}
+		if (static_cast<unsigned char>(character) < 0x20) {
+			continue;
+		}
+		escaped.push_back(character);
+	}
+	return escaped;
+}
+
+auto to_us(nanoseconds span) -> double
+{
+	return duration<double, std::micro>(span).count();
+}
+} // namespace
+
+ZoneBuffer::ZoneBuffer(uint32_t thread_id, std::string thread_name)
+    : thread_id(thread_id)
+    , thread_name(std::move(thread_name))
+    , records(std::make_unique<Record[]>(kSlotCount))
+{
+}
+
+void ZoneBuffer::collect(
+    uint64_t first_index, std::vector<ZoneEvent>& output
+) const
+{
+	auto end = write_count.load(std::memory_order_acquire);
+	auto begin = std::max(first_index, (end > kCapacity) ? end - kCapacity : 0);
+	if (begin >= end) {
+		return;
+	}
+
+	auto first_output = output.size();
+	for (auto index = begin; index < end; ++index) {
+		const auto& record = records[index % kSlotCount];
+		auto start_ns = record.start_ns.load(std::memory_order_relaxed);
+		auto end_ns = record.end_ns.load(std::memory_order_relaxed);
+		output.push_back({ record.name.load(std::memory_order_relaxed),
+		                   thread_id,
+		                   nanoseconds(start_ns),
+		                   nanoseconds(end_ns - start_ns) });
+	}
+
+	// Drop the zones whose slots the writer reached while we copied
+	std::atomic_thread_fence(std::memory_order_acquire);
+	auto after = write_count.load(std::memory_order_relaxed);
+	if (after >= begin + kSlotCount) {
+		auto overwritten = std::min<uint64_t>(
+		    after - (begin + kSlotCount) + 1, end - begin
+		);
+		output.erase(output.begin() + first_output,
+		             output.begin() + first_output + overwritten);
+	}
+}
+
+void Profiler::beginCapture()
+{
+	std::lock_guard lock(buffers_mutex);
+	for (auto& buffer : buffers) {
+		buffer->capture_start = buffer->getWriteCount();
+	}
+	capture_origin = Profiler::now();
+	capturing.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::endCapture()
+{
+	capturing.store(false, std::memory_order_relaxed);
+}
+
+void Profiler::setThreadName(std::string name)
+{
+	auto& buffer = this->getThreadBuffer();
+	std::lock_guard lock(buffers_mutex);
+	buffer.thread_name = std::move(name);
+}
+
+auto Profiler::register_thread() -> ZoneBuffer&
+{
+	std::lock_guard lock(buffers_mutex);
+	auto thread_id = static_cast<uint32_t>(buffers.size() + 1);
+	buffers.push_back(std::make_unique<ZoneBuffer>(
+	    thread_id, fmt::format("thread {}", thread_id)
+	));
+	return *buffers.back();
+}
+
+auto Profiler::collectZones() const -> std::vector<ZoneEvent>
+{
+	std::vector<ZoneEvent> zones;
+	{
+		std::lock_guard lock(buffers_mutex);
+		for (const auto& buffer : buffers) {
+			buffer->collect(buffer->capture_start, zones);
+		}
+	}
+	std::sort(zones.begin(),
+	          zones.end(),
+	          [](const ZoneEvent& lhs, const ZoneEvent& rhs) {
+		          return lhs.start < rhs.start;
+	          });
+	return zones;
+}
+
+void Profiler::writeChromeTrace(std::ostream& output) const
+{
+	auto zones = this->collectZones();
+	nanoseconds origin(0);
+	const char* separator = "\n";
+
+	output << "{\"traceEvents\":[";
+	{
+		std::lock_guard lock(buffers_mutex);
+		origin = nanoseconds(capture_origin);
+		for (const auto& buffer : buffers) {
+			output << separator
+			       << fmt::format(
+				      "{{\"name\":\"thread_name\",\"ph\":\"M\","
+				      "\"pid\":1,\"tid\":{},\"args\":{{\"name\":"
+				      "\"{}\"}}}}",
+				      buffer->thread_id,
+				      escape_json(buffer->thread_name)
+			          );
+			separator = ",\n";
+		}
+	}
+	for (const auto& zone : zones) {
+		output << separator
+		       << fmt::format(
+			      "{{\"name\":\"{}\",\"cat\":\"elemental\","
+			      "\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},"
+			      "\"dur\":{:.3f}}}",
+			      escape_json(zone.name),
+			      zone.thread_id,
+			      to_us(zone.start - origin),
+			      to_us(zone.duration)
+		          );
+		separator = ",\n";
+	}
+	output << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void Profiler::dumpChromeTrace(const std::filesystem::path& file_path) const
+{
+	std::ostringstream trace;
+	this->writeChromeTrace(trace);
+	write_file_atomically(file_path, trace.str());
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,204 @@
+/* Profiler.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "INonCopyable.hpp"
+#include "Singleton.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*! \name Profiling zones
+ * PROFILE_ZONE("name") times the rest of the enclosing scope;
+ * PROFILE_FUNCTION() names the zone after the enclosing function. Names
+ * must be string literals (or otherwise outlive the capture).
+ *
+ * Both expand to nothing unless ELEMENTAL_PROFILING is defined (CMake
+ * option ELEMENTAL_PROFILING). \{ */
+#ifdef ELEMENTAL_PROFILING // #region
+#define ELEMENTAL_PROFILE_CONCAT_(lhs, rhs) lhs##rhs
+#define ELEMENTAL_PROFILE_CONCAT(lhs, rhs) ELEMENTAL_PROFILE_CONCAT_(lhs, rhs)
+#define PROFILE_ZONE(name)                                                     \
+	const ::elemental::ProfileZone ELEMENTAL_PROFILE_CONCAT(                \
+	    profile_zone_, __LINE__                                             \
+	)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#endif // #endregion
+/*! \} */
+
+namespace elemental {
+
+//! \brief One completed zone, as exported
+struct ZoneEvent {
+	const char* name;
+	uint32_t thread_id;
+	std::chrono::nanoseconds start;
+	std::chrono::nanoseconds duration;
+};
+
+/*! \brief Ring of the zones completed on one thread.
+ *
+ * Only its own thread writes to it; the newest kCapacity zones are kept.
+ * Readers on other threads use the same seqlock-style scheme as FrameStats,
+ * leaving out zones overwritten while they copy. */
+class ZoneBuffer : private INonCopyable
+{
+  public:
+	static constexpr size_t kCapacity = 16384;
+
+	ZoneBuffer(uint32_t thread_id, std::string thread_name);
+
+	void push(const char* name, int64_t start_ns, int64_t end_ns)
+	{
+		auto index = write_count.load(std::memory_order_relaxed);
+		auto& record = records[index % kSlotCount];
+
+		std::atomic_thread_fence(std::memory_order_release);
+		record.name.store(name, std::memory_order_relaxed);
+		record.start_ns.store(start_ns, std::memory_order_relaxed);
+		record.end_ns.store(end_ns, std::memory_order_relaxed);
+		write_count.store(index + 1, std::memory_order_release);
+	}
+
+	auto getWriteCount() const -> uint64_t
+	{
+		return write_count.load(std::memory_order_acquire);
+	}
+	//! \brief Appends the zones written since \c first_index to \c output
+	void collect(uint64_t first_index, std::vector<ZoneEvent>& output) const;
+
+	const uint32_t thread_id;
+	std::string thread_name;
+	//! Write count when the current capture began
+	uint64_t capture_start{ 0 };
+
+  protected:
+	struct Record {
+		std::atomic<const char*> name;
+		std::atomic<int64_t> start_ns;
+		std::atomic<int64_t> end_ns;
+	};
+	// One spare slot; see FrameStats
+	static constexpr size_t kSlotCount = kCapacity + 1;
+
+	std::unique_ptr<Record[]> records;
+	std::atomic<uint64_t> write_count{ 0 };
+};
+
+/*! \brief Collects timed zones from every thread and exports them as Chrome
+ * trace_event JSON (chrome://tracing, Perfetto).
+ *
+ * Zones are only recorded between beginCapture() and endCapture(). Each
+ * thread gets its own ZoneBuffer on its first zone; recording a zone takes
+ * two clock reads and a few relaxed stores, with no locks or allocation.
+ * Buffers live as long as the profiler, so traces keep the zones of threads
+ * that have already exited. */
+class Profiler : private INonCopyable
+{
+  public:
+	friend class Singleton;
+
+	static auto Get() -> Profiler&
+	{
+		return Singleton::getReference<Profiler>();
+	}
+
+	void beginCapture();
+	void endCapture();
+	auto isCapturing() const -> bool
+	{
+		return capturing.load(std::memory_order_relaxed);
+	}
+
+	//! \brief Names the calling thread in exported traces.
+	void setThreadName(std::string name);
+
+	//! \brief This thread's buffer, created on first use.
+	auto getThreadBuffer() -> ZoneBuffer&
+	{
+		if (thread_buffer == nullptr) {
+			thread_buffer = &register_thread();
+		}
+		return *thread_buffer;
+	}
+
+	//! \brief Zones recorded by the current (or last) capture, by start
+	auto collectZones() const -> std::vector<ZoneEvent>;
+
+	void writeChromeTrace(std::ostream& output) const;
+	/*! \brief Writes the trace to \c file_path, replacing its contents
+	 * atomically (see write_file_atomically()). */
+	void dumpChromeTrace(const std::filesystem::path& file_path) const;
+
+	static auto now() -> int64_t
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		    std::chrono::steady_clock::now().time_since_epoch()
+		)
+		    .count();
+	}
+
+  protected:
+	Profiler() = default;
+
+	auto register_thread() -> ZoneBuffer&;
+
+	mutable std::mutex buffers_mutex;
+	std::vector<std::unique_ptr<ZoneBuffer>> buffers;
+	std::atomic<bool> capturing{ false };
+	int64_t capture_origin{ 0 };
+
+	// The profiler is a singleton, so one cached buffer per thread suffices
+	static inline thread_local ZoneBuffer* thread_buffer = nullptr;
+};
+
+/*! \brief Records the lifetime of a scope as one zone (RAII).
+ * Prefer the PROFILE_ZONE macro, which compiles out. */
+class ProfileZone
+{
+  public:
+	explicit ProfileZone(const char* name) : name(name), buffer(nullptr)
+	{
+		auto& profiler = Profiler::Get();
+		if (profiler.isCapturing()) {
+			buffer = &profiler.getThreadBuffer();
+			start_ns = Profiler::now();
+		}
+	}
+	~ProfileZone()
+	{
+		if (buffer != nullptr) {
+			buffer->push(name, start_ns, Profiler::now());
+		}
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	auto operator=(const ProfileZone&) -> ProfileZone& = delete;
+
+  protected:
+	const char* name;
+	ZoneBuffer* buffer;
+	int64_t start_ns{ 0 };
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
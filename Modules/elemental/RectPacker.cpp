@@ -0,0 +1,145 @@
+/* RectPacker.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "RectPacker.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+
+using namespace elemental;
+
+RectPacker::RectPacker(Area bin_size) : bin_size(bin_size), skyline()
+{
+	this->reset();
+}
+
+void RectPacker::reset()
+{
+	this->used_area = 0;
+	this->skyline.clear();
+	this->skyline.push_back({ 0, 0, bin_size.width });
+}
+
+auto RectPacker::getOccupancy() const -> double
+{
+	const auto kBinArea =
+	    static_cast<double>(bin_size.width) * bin_size.height;
+
+	return (kBinArea > 0) ? static_cast<double>(used_area) / kBinArea
+	                      : 0.0;
+}
+
+auto RectPacker::insert(uint32_t width, uint32_t height)
+    -> std::optional<Point>
+{
+	if (width == 0 || height == 0) {
+		return std::nullopt;
+	}
+
+	size_t best_index = 0;
+	uint32_t best_bottom = std::numeric_limits<uint32_t>::max();
+	uint32_t best_width = std::numeric_limits<uint32_t>::max();
+	std::optional<Point> best_position;
+
+	for (size_t index = 0; index < skyline.size(); ++index) {
+		auto fit_y = this->fit_at(index, width, height);
+		if (!fit_y.has_value()) {
+			continue;
+		}
+
+		// Prefer the lowest resulting top edge, then the narrowest
+		// skyline segment to keep the remaining gaps usable.
+		auto bottom = *fit_y + height;
+		auto segment_width = skyline[index].width;
+		if (bottom < best_bottom ||
+		    (bottom == best_bottom && segment_width < best_width)) {
+			best_index = index;
+			best_bottom = bottom;
+			best_width = segment_width;
+			best_position = Point{ skyline[index].x, *fit_y };
+		}
+	}
+
+	if (best_position.has_value()) {
+		this->add_skyline_level(
+		    best_index, *best_position, Area{ width, height }
+		);
+		this->used_area += static_cast<uint64_t>(width) * height;
+	}
+	return best_position;
+}
+
+/* Returns the y coordinate at which a rectangle with its left edge on
+ * skyline[node_index] would rest, or nullopt if it would leave the bin. */
+auto RectPacker::fit_at(size_t node_index, uint32_t width, uint32_t height)
+    const -> std::optional<uint32_t>
+{
+	const auto kLeft = skyline[node_index].x;
+	if (kLeft + width > bin_size.width) {
+		return std::nullopt;
+	}
+
+	uint32_t fit_y = 0;
+	uint32_t width_left = width;
+	size_t index = node_index;
+
+	while (width_left > 0) {
+		if (index >= skyline.size()) {
+			return std::nullopt;
+		}
+		fit_y = std::max(fit_y, skyline[index].y);
+		if (fit_y + height > bin_size.height) {
+			return std::nullopt;
+		}
+		width_left -= std::min(width_left, skyline[index].width);
+		++index;
+	}
+	return fit_y;
+}
+
+void RectPacker::add_skyline_level(
+    size_t node_index, Point position, Area size
+)
+{
+	SkylineNode new_node{ position.x, position.y + size.height,
+		              size.width };
+	skyline.insert(skyline.begin() + node_index, new_node);
+
+	// Shrink or drop the segments now covered by the new node
+	const auto kNewRight = new_node.x + new_node.width;
+	for (size_t index = node_index + 1; index < skyline.size();) {
+		auto& node = skyline[index];
+		if (node.x >= kNewRight) {
+			break;
+		}
+
+		auto overlap = kNewRight - node.x;
+		if (overlap >= node.width) {
+			skyline.erase(skyline.begin() + index);
+			continue;
+		}
+		node.x += overlap;
+		node.width -= overlap;
+		break;
+	}
+
+	// Merge neighbours of equal height
+	for (size_t index = 0; index + 1 < skyline.size();) {
+		if (skyline[index].y == skyline[index + 1].y) {
+			skyline[index].width += skyline[index + 1].width;
+			skyline.erase(skyline.begin() + index + 1);
+		} else {
+			++index;
+		}
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,69 @@
+/* RectPacker.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "types/rendering.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace elemental {
+
+/*! \brief Skyline bin packer, used to allocate sub-rectangles of a texture
+ * atlas page.
+ *
+ * The packer tracks the top edge ("skyline") of everything placed so far
+ * and puts each new rectangle at the lowest position it fits
+ * (bottom-left rule). Inserting rectangles sorted by decreasing height gives
+ * the best results. */
+class RectPacker
+{
+  public:
+	explicit RectPacker(Area bin_size);
+
+	/*! \brief Finds room for a width × height rectangle.
+	 * \returns the top-left corner of the allocated rectangle, or
+	 * std::nullopt when the bin has no room left for it. */
+	auto insert(uint32_t width, uint32_t height) -> std::optional<Point>;
+
+	//! \brief Forgets every allocation.
+	void reset();
+
+	auto getBinSize() const -> Area { return bin_size; }
+
+	//! \brief Sum of the areas of all allocated rectangles.
+	auto getUsedArea() const -> uint64_t { return used_area; }
+
+	//! \brief Used area divided by bin area, between 0.0 and 1.0
+	auto getOccupancy() const -> double;
+
+#ifndef UNIT_TEST
+  protected:
+#endif
+	struct SkylineNode
+	{
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+	};
+
+	auto fit_at(size_t node_index, uint32_t width, uint32_t height) const
+	    -> std::optional<uint32_t>;
+	void add_skyline_level(size_t node_index, Point position, Area size);
+
+	Area bin_size;
+	uint64_t used_area{ 0 };
+	std::vector<SkylineNode> skyline;
+};
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
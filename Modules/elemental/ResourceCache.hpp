@@ -0,0 +1,217 @@
+/* ResourceCache.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace elemental {
+
+//! \brief Counters reported by ResourceCache::getStats()
+struct CacheStats {
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+	size_t resident_count;
+	size_t resident_bytes;
+};
+
+/*! \brief Key-value cache of shared resources with a memory budget.
+ *
+ * acquire() returns the cached resource for a key, loading it on a miss.
+ * Every resource carries an approximate size in bytes; once the total goes
+ * over budget, the least-recently-used resources that nobody else holds a
+ * reference to are evicted. Resources still in use are never evicted, so
+ * the budget can be exceeded while they are alive.
+ *
+ * \tparam TPtr shared pointer type handed out, e.g. SdlPtr<SDL_Texture> */
+template<typename TResource, typename TPtr = std::shared_ptr<TResource>>
+class ResourceCache
+{
+  public:
+	using ResourcePtr = TPtr;
+	using Loader = std::function<ResourcePtr(const std::string&)>;
+	using SizeEstimator = std::function<size_t(const ResourcePtr&)>;
+
+	ResourceCache(size_t budget_bytes, Loader loader,
+	              SizeEstimator size_estimator)
+	    : budget_bytes(budget_bytes)
+	    , loader(std::move(loader))
+	    , size_estimator(std::move(size_estimator))
+	    , stats{ 0, 0, 0, 0, 0 }
+	{
+	}
+	virtual ~ResourceCache() = default;
+
+	//! \brief Returns the cached resource, loading it on a miss.
+	auto acquire(const std::string& key) -> ResourcePtr
+	{
+		auto lock = std::lock_guard(mutex);
+
+		auto entry_iter = entries.find(key);
+		if (entry_iter != entries.end()) {
+			++stats.hits;
+			touch(entry_iter->second);
+			return entry_iter->second.resource;
+		}
+
+		++stats.misses;
+		ResourcePtr resource = loader(key);
+		store(key, resource);
+		return resource;
+	}
+
+	/*! \brief Adds a resource that was loaded elsewhere (for example by
+	 * the AssetLoader), replacing any previous entry for the key. */
+	void insert(const std::string& key, ResourcePtr resource)
+	{
+		auto lock = std::lock_guard(mutex);
+
+		erase_entry(key);
+		store(key, std::move(resource));
+	}
+
+	auto contains(const std::string& key) const -> bool
+	{
+		auto lock = std::lock_guard(mutex);
+		return entries.contains(key);
+	}
+
+	void setBudget(size_t new_budget_bytes)
+	{
+		auto lock = std::lock_guard(mutex);
+		budget_bytes = new_budget_bytes;
+		evict_over_budget();
+	}
+	auto getBudget() const -> size_t
+	{
+		auto lock = std::lock_guard(mutex);
+		return budget_bytes;
+	}
+
+	auto getStats() const -> CacheStats
+	{
+		auto lock = std::lock_guard(mutex);
+		return stats;
+	}
+
+	/*! \brief Evicts unreferenced resources until the cache is back
+	 * within budget. Call it after releasing many handles at once. */
+	void trim()
+	{
+		auto lock = std::lock_guard(mutex);
+		evict_over_budget();
+	}
+
+	//! \brief Evicts every unreferenced resource, regardless of budget.
+	void purgeUnused()
+	{
+		auto lock = std::lock_guard(mutex);
+		evict_until([]() { return false; });
+	}
+
+	/*! \brief Drops every entry, referenced or not. Handles held
+	 * elsewhere stay valid; the cache just stops owning them. */
+	void clear()
+	{
+		auto lock = std::lock_guard(mutex);
+		entries.clear();
+		lru.clear();
+		stats.resident_count = 0;
+		stats.resident_bytes = 0;
+	}
+
+  protected:
+	using LruList = std::list<std::string>;
+
+	struct Entry {
+		ResourcePtr resource;
+		size_t bytes;
+		typename LruList::iterator lru_position;
+	};
+
+	void touch(Entry& entry)
+	{
+		lru.splice(lru.begin(), lru, entry.lru_position);
+	}
+
+	void store(const std::string& key, ResourcePtr resource)
+	{
+		auto bytes = size_estimator(resource);
+		lru.push_front(key);
+		entries.emplace(
+		    key, Entry{ std::move(resource), bytes, lru.begin() }
+		);
+
+		++stats.resident_count;
+		stats.resident_bytes += bytes;
+		evict_over_budget();
+	}
+
+	void erase_entry(const std::string& key)
+	{
+		auto entry_iter = entries.find(key);
+		if (entry_iter == entries.end()) {
+			return;
+		}
+		--stats.resident_count;
+		stats.resident_bytes -= entry_iter->second.bytes;
+		lru.erase(entry_iter->second.lru_position);
+		entries.erase(entry_iter);
+	}
+
+	void evict_over_budget()
+	{
+		evict_until([this]() {
+			return stats.resident_bytes <= budget_bytes;
+		});
+	}
+
+	// Walks from least- to most-recently used, evicting resources whose
+	// only owner is the cache, until is_done() holds.
+	template<typename TPredicate>
+	void evict_until(TPredicate is_done)
+	{
+		auto lru_iter = lru.end();
+		while (lru_iter != lru.begin() && !is_done()) {
+			--lru_iter;
+			auto& entry = entries.at(*lru_iter);
+			if (entry.resource.use_count() > 1) {
+				continue;
+			}
+
+			auto key = *lru_iter;
+			lru_iter = std::next(lru_iter);
+			erase_entry(key);
+			++stats.evictions;
+		}
+	}
+
+	size_t budget_bytes;
+	Loader loader;
+	SizeEstimator size_estimator;
+
+	LruList lru;
+	std::unordered_map<std::string, Entry> entries;
+	CacheStats stats;
+
+	mutable std::mutex mutex;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
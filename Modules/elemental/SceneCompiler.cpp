@@ -0,0 +1,285 @@
+/* SceneCompiler.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "SceneCompiler.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <fmt/core.h>
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+using nlohmann::json;
+
+namespace elemental::scene_format {
+
+namespace {
+[[noreturn]] void throw_malformed(const std::string& what)
+{
+	throw IOCore::Exception(fmt::format("Malformed scene: {}", what));
+}
+
+auto align_up(size_t offset) -> size_t
+{
+	return (offset + 3) & ~size_t{ 3 };
+}
+
+auto checked_u32(size_t value, const char* what) -> uint32_t
+{
+	if (value > UINT32_MAX) {
+		throw_malformed(fmt::format("too many {}", what));
+	}
+	return static_cast<uint32_t>(value);
+}
+
+class StringTable
+{
+  public:
+	auto add(const std::string& text) -> StringRef
+	{
+		if (text.empty()) {
+			return { 0, 0 };
+		}
+		auto [found, is_new] = refs.try_emplace(text);
+		if (is_new) {
+			found->second = {
+				checked_u32(data.size(), "string bytes"),
+				checked_u32(text.size(), "string bytes"),
+			};
+			data += text;
+		}
+		return found->second;
+	}
+	auto getData() const -> const std::string& { return data; }
+
+  protected:
+	std::string data;
+	std::unordered_map<std::string, StringRef> refs;
+};
+
+//! Calls function(name, object) for an array of named objects or a map
+template<typename TFunction>
+void for_each_named(const json& collection, const char* what,
+                    TFunction&& function)
+{
+	if (collection.is_object()) {
+		for (const auto& [name, item] : collection.items()) {
+			function(name, item);
+		}
+	} else if (collection.is_array()) {
+		for (const auto& item : collection) {
+			if (!item.is_object() || !item.contains("name")) {
+				throw_malformed(
+				    fmt::format("every {} needs a name", what)
+				);
+			}
+			function(item["name"].get<std::string>(), item);
+		}
+	} else if (!collection.is_null()) {
+		throw_malformed(fmt::format("{}s must be an array or object", what)
+		);
+	}
+}
+
+void read_pair(const json& entity, const char* key, int32_t (&out)[2])
+{
+	out[0] = out[1] = 0;
+	if (!entity.contains(key)) {
+		return;
+	}
+	const auto& pair = entity[key];
+	if (!pair.is_array() || pair.size() != 2) {
+		throw_malformed(fmt::format("{} must be [x, y]", key));
+	}
+	out[0] = pair[0].get<int32_t>();
+	out[1] = pair[1].get<int32_t>();
+}
+
+template<typename T>
+void append(std::vector<std::byte>& output, size_t offset,
+            const std::vector<T>& records)
+{
+	if (!records.empty()) {
+		std::memcpy(output.data() + offset,
+		            records.data(),
+		            records.size() * sizeof(T));
+	}
+}
+} // namespace
+
+auto compile(const json& scene) -> std::vector<std::byte>
+{
+	if (!scene.is_object()) {
+		throw_malformed("the scene must be an object");
+	}
+
+	try {
+		Header header{};
+		std::memcpy(header.magic, kMagic, sizeof(kMagic));
+		header.version = kVersion;
+		header.header_size = sizeof(Header);
+
+		if (scene.contains("dimensions")) {
+			const auto& dimensions = scene["dimensions"];
+			if (!dimensions.is_array() || dimensions.size() != 2) {
+				throw_malformed("dimensions must be [width, height]");
+			}
+			header.width = dimensions[0].get<uint32_t>();
+			header.height = dimensions[1].get<uint32_t>();
+		}
+
+		StringTable strings;
+		std::vector<StringRef> layers;
+		std::unordered_map<std::string, uint32_t> layer_indices;
+		for (const auto& layer : scene.value("layers", json::array())) {
+			auto name = layer.get<std::string>();
+			layer_indices.emplace(
+			    name, static_cast<uint32_t>(layers.size())
+			);
+			layers.push_back(strings.add(name));
+		}
+
+		std::vector<EntityRecord> entities;
+		for_each_named(
+		    scene.value("entities", json()),
+		    "entity",
+		    [&](const std::string& name, const json& entity) {
+			    EntityRecord record{};
+			    record.name = strings.add(name);
+			    record.type =
+				strings.add(entity.value("type", std::string()));
+			    record.image = strings.add(
+				entity.value("image", std::string())
+			    );
+			    record.script = strings.add(entity.value(
+				"script", entity.value("scripts", std::string())
+			    ));
+			    record.layer = kNoLayer;
+			    if (entity.contains("layer")) {
+				    auto layer = entity["layer"].get<std::string>();
+				    auto found = layer_indices.find(layer);
+				    if (found == layer_indices.end()) {
+					    throw_malformed(fmt::format(
+						"entity {} uses unknown layer {}",
+						name,
+						layer
+					    ));
+				    }
+				    record.layer = found->second;
+			    }
+			    read_pair(entity, "position", record.position);
+			    read_pair(entity, "size", record.size);
+			    entities.push_back(record);
+		    }
+		);
+
+		std::vector<ScriptRecord> scripts;
+		for_each_named(
+		    scene.value("scripts", json()),
+		    "script",
+		    [&](const std::string& name, const json& script) {
+			    scripts.push_back({
+				strings.add(name),
+				strings.add(script.value("path", name)),
+			    });
+		    }
+		);
+
+		// Sections in file order, each four-byte aligned
+		size_t offset = sizeof(Header);
+		header.layer_count = checked_u32(layers.size(), "layers");
+		header.layers_offset = checked_u32(offset, "bytes");
+		offset = align_up(offset + layers.size() * sizeof(StringRef));
+
+		header.entity_count = checked_u32(entities.size(), "entities");
+		header.entities_offset = checked_u32(offset, "bytes");
+		offset =
+		    align_up(offset + entities.size() * sizeof(EntityRecord));
+
+		header.script_count = checked_u32(scripts.size(), "scripts");
+		header.scripts_offset = checked_u32(offset, "bytes");
+		offset = align_up(offset + scripts.size() * sizeof(ScriptRecord));
+
+		header.strings_offset = checked_u32(offset, "bytes");
+		header.strings_size =
+		    checked_u32(strings.getData().size(), "string bytes");
+		offset = align_up(offset + strings.getData().size());
+		header.file_size = checked_u32(offset, "bytes");
+
+		std::vector<std::byte> output(offset);
+		std::memcpy(output.data(), &header, sizeof(Header));
+		append(output, header.layers_offset, layers);
+		append(output, header.entities_offset, entities);
+		append(output, header.scripts_offset, scripts);
+		std::memcpy(output.data() + header.strings_offset,
+		            strings.getData().data(),
+		            strings.getData().size());
+		return output;
+	} catch (const json::exception& error) {
+		throw_malformed(error.what());
+	}
+}
+
+void compile_file(const fs::path& json_path, const fs::path& output_path,
+                  std::string_view scene_key)
+{
+	json root;
+	{
+		std::ifstream input(json_path);
+		if (!input.is_open()) {
+			throw IOCore::Exception(fmt::format(
+			    "Could not open scene {}", json_path.string()
+			));
+		}
+		try {
+			root = json::parse(input);
+		} catch (const json::exception& error) {
+			throw IOCore::Exception(fmt::format(
+			    "Could not parse scene {}: {}",
+			    json_path.string(),
+			    error.what()
+			));
+		}
+	}
+
+	const json* scene = &root;
+	if (!scene_key.empty()) {
+		auto found = root.find(scene_key);
+		if (found == root.end()) {
+			throw IOCore::Exception(fmt::format(
+			    "Scene {} has no member {}",
+			    json_path.string(),
+			    scene_key
+			));
+		}
+		scene = &*found;
+	} else if (root.is_object() && !root.contains("entities") &&
+	           root.size() == 1) {
+		scene = &root.begin().value();
+	}
+
+	auto bytes = compile(*scene);
+	std::ofstream output(output_path, std::ios::binary | std::ios::trunc);
+	output.write(reinterpret_cast<const char*>(bytes.data()),
+	             static_cast<std::streamsize>(bytes.size()));
+	if (!output) {
+		throw IOCore::Exception(fmt::format(
+		    "Could not write compiled scene {}", output_path.string()
+		));
+	}
+}
+
+} // namespace elemental::scene_format
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,47 @@
+/* SceneCompiler.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "SceneFormat.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace elemental::scene_format {
+
+/*! \brief Compiles a JSON scene description into the binary format.
+ *
+ * \c scene holds \c dimensions, \c layers, \c entities and \c scripts.
+ * Entities and scripts may be arrays of objects with a \c name, or objects
+ * keyed by name. An entity's \c layer must be one of the scene's layers;
+ * its script may be given as \c script or \c scripts. A script's \c path
+ * defaults to its name. Equal strings are stored once.
+ *
+ * \throws IOCore::Exception on a malformed description */
+auto compile(const nlohmann::json& scene) -> std::vector<std::byte>;
+
+/*! \brief Reads \c json_path, compiles it and writes \c output_path.
+ *
+ * \param scene_key the member of the root object holding the scene; if
+ *        empty, the root itself, or its only member when the root has no
+ *        \c entities
+ * \throws IOCore::Exception if reading, compiling or writing fails */
+void compile_file(const std::filesystem::path& json_path,
+                  const std::filesystem::path& output_path,
+                  std::string_view scene_key = {});
+
+} // namespace elemental::scene_format
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
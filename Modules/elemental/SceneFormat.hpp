@@ -0,0 +1,87 @@
+/* SceneFormat.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+/*! \brief On-disk layout of compiled scenes.
+ *
+ * A compiled scene is a Header followed by four sections, each aligned to
+ * four bytes and located by an offset from the start of the file:
+ *
+ *   - layers:   StringRef[layer_count]
+ *   - entities: EntityRecord[entity_count]
+ *   - scripts:  ScriptRecord[script_count]
+ *   - strings:  UTF-8 text, referenced by StringRef; not NUL-terminated
+ *
+ * Every field is little-endian and naturally aligned, so a mapped file is
+ * read in place without any parsing. */
+namespace elemental::scene_format {
+
+static_assert(std::endian::native == std::endian::little,
+              "Compiled scenes are read in place as little-endian");
+
+constexpr char kMagic[4] = { 'E', 'L', 'S', 'C' };
+//! \brief Bumped on every layout change; readers reject other versions
+constexpr uint16_t kVersion = 1;
+constexpr uint32_t kNoLayer = UINT32_MAX;
+
+struct StringRef {
+	uint32_t offset; //!< from the start of the string table
+	uint32_t length;
+};
+
+struct Header {
+	char magic[4];
+	uint16_t version;
+	uint16_t header_size;
+	uint32_t file_size;
+
+	uint32_t width;
+	uint32_t height;
+
+	uint32_t layer_count;
+	uint32_t layers_offset;
+	uint32_t entity_count;
+	uint32_t entities_offset;
+	uint32_t script_count;
+	uint32_t scripts_offset;
+	uint32_t strings_offset;
+	uint32_t strings_size;
+};
+
+struct EntityRecord {
+	StringRef name;
+	StringRef type;
+	StringRef image;  //!< empty if the entity has no image
+	StringRef script; //!< empty if the entity has no script
+	uint32_t layer;   //!< index into the layers, or kNoLayer
+	int32_t position[2];
+	int32_t size[2];
+};
+
+struct ScriptRecord {
+	StringRef name;
+	StringRef path;
+};
+
+static_assert(std::is_trivially_copyable_v<Header> &&
+              std::is_standard_layout_v<Header> && sizeof(Header) == 52);
+static_assert(std::is_trivially_copyable_v<EntityRecord> &&
+              sizeof(EntityRecord) == 52);
+static_assert(std::is_trivially_copyable_v<ScriptRecord> &&
+              sizeof(ScriptRecord) == 16);
+
+} // namespace elemental::scene_format
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -14,6 +14,7 @@
 
 #include "IOCore/Exception.hpp"
 #include "IObserver.hpp"
+#include "Profiler.hpp"
 
 #include "SdlEventSource.hpp"
 #include "types/input.hpp"
@@ -67,27 +68,127 @@ SdlEventSource::SdlEventSource(InputDevices device_flags)
 
 auto SdlEventSource::pollEvents() -> void
 {
-	auto thread_lock = std::lock_guard(this->mutex);
-
+	PROFILE_FUNCTION();
 	SDL_Event event;
 
+	// SDL's own queue is always drained; events that do not fit in the
+	// ring are dropped and counted rather than blocking this thread.
 	while (SDL_PollEvent(&event)) {
-		event_queue.push(event);
+		event_queue.tryPush(event);
 	}
 }
 
 auto SdlEventSource::sendEvents() -> void
 {
-	auto thread_lock = std::lock_guard(this->mutex);
+	PROFILE_FUNCTION();
+	SDL_Event pending;
+	SDL_Event next;
+	bool has_pending = false;
+
+	// Each event is held back until the next one shows whether it can
+	// be merged, so dispatch order is preserved.
+	while (event_queue.tryPop(next)) {
+		if (has_pending && is_coalescing &&
+		    try_coalesce(pending, next)) {
+			++coalesced_count;
+			continue;
+		}
+		if (has_pending) {
+			dispatch(pending);
+		}
+		pending = next;
+		has_pending = true;
+	}
+	if (has_pending) {
+		dispatch(pending);
+	}
+}
 
-	while (!event_queue.empty()) {
-		auto& sdl_event = event_queue.front();
+void SdlEventSource::dispatch(const SDL_Event& event)
+{
+	TypedObservable<SDL_Event>::notify_all(event);
+
+	auto registry_iter = observers_by_type.find(event.type);
+	if (registry_iter != observers_by_type.end()) {
+		registry_iter->second.forEach(
+		    [&](ITypedObserver<SDL_Event>& observer) {
+			    observer.recieveMessage(*this, event);
+		    }
+		);
+	}
+
+	// Wrapping an SDL_Event in std::any allocates; skip it unless a
+	// legacy observer is listening.
+	if (!Observable::observers.empty()) {
+		Observable::notify_all(event);
+	}
+}
 
-		Observable::notify_all(sdl_event);
+auto SdlEventSource::try_coalesce(SDL_Event& pending, const SDL_Event& next)
+    -> bool
+{
+	if (pending.type != next.type) {
+		return false;
+	}
 
-		event_queue.pop();
+	switch (next.type) {
+		case SDL_MOUSEMOTION:
+			if (pending.motion.windowID != next.motion.windowID ||
+			    pending.motion.which != next.motion.which) {
+				return false;
+			}
+			// Keep the latest position and state, and the total
+			// relative motion of the run
+			pending.motion.timestamp = next.motion.timestamp;
+			pending.motion.state = next.motion.state;
+			pending.motion.x = next.motion.x;
+			pending.motion.y = next.motion.y;
+			pending.motion.xrel += next.motion.xrel;
+			pending.motion.yrel += next.motion.yrel;
+			return true;
+
+		case SDL_JOYAXISMOTION:
+			if (pending.jaxis.which != next.jaxis.which ||
+			    pending.jaxis.axis != next.jaxis.axis) {
+				return false;
+			}
+			pending.jaxis = next.jaxis;
+			return true;
+
+		case SDL_CONTROLLERAXISMOTION:
+			if (pending.caxis.which != next.caxis.which ||
+			    pending.caxis.axis != next.caxis.axis) {
+				return false;
+			}
+			pending.caxis = next.caxis;
+			return true;
+
+		default:
+			return false;
 	}
 }
 
+auto SdlEventSource::subscribe(
+    ITypedObserver<SDL_Event>& observer, SDL_EventType event_type
+) -> Subscription
+{
+	return observers_by_type[event_type].subscribe(observer);
+}
+
+void SdlEventSource::setCoalescing(bool is_enabled)
+{
+	this->is_coalescing = is_enabled;
+}
+
+auto SdlEventSource::getDroppedEventCount() const -> uint64_t
+{
+	return event_queue.getOverflowCount();
+}
+
+auto SdlEventSource::getCoalescedEventCount() const -> uint64_t
+{
+	return this->coalesced_count;
+}
+
 // clang-format off
 // vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
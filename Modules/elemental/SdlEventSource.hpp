@@ -11,40 +11,92 @@
 
 #include "SDL_Memory.hpp"
 #include "Singleton.hpp"
+#include "SpscRing.hpp"
 
 #include "IEventSource.hpp"
+#include "Observable.hpp"
 #include "types/input.hpp"
 
 #include "util/testing.hpp"
 
 #include <SDL.h>
 
+#include <cstdint>
 #include <memory>
-#include <mutex>
-#include <queue>
+#include <unordered_map>
 
 namespace elemental {
 
-class SdlEventSource : public IEventSource {
+/*! \brief Polls SDL events and forwards them to observers.
+ *
+ * ITypedObserver<SDL_Event>s receive each event by reference, either every
+ * event or only those of the SDL_EventTypes they subscribed to. Legacy
+ * IObservers still receive a std::any copy of every event.
+ *
+ * Runs of consecutive SDL_MOUSEMOTION events from the same mouse, and of
+ * joystick / controller axis events for the same axis, are coalesced into
+ * one event per run before dispatch (see setCoalescing()). */
+class SdlEventSource
+    : public IEventSource
+    , public TypedObservable<SDL_Event> {
 	TEST_INSPECTABLE(SdlEventSource);
 
     public:
 	friend class Singleton;
 
+	/* Both bases can unregister by handle; qualify those calls with the
+	 * base the handle came from, or hold a Subscription instead. */
+	using Observable::registerObserver;
+	using Observable::subscribe;
+	using TypedObservable<SDL_Event>::registerObserver;
+	using TypedObservable<SDL_Event>::subscribe;
+
 	explicit SdlEventSource(
 	    InputDevices device_flags = InputDevices::Keyboard
 	);
 
 	~SdlEventSource() override = default;
 
+	/*! \brief Moves pending SDL events into the event ring.
+	 * Must always be called from the same thread (the one that owns the
+	 * SDL video subsystem); it never waits on sendEvents(). */
 	void pollEvents() override;
+
+	/*! \brief Delivers queued events to the observers.
+	 * Must always be called from the same thread; may run concurrently
+	 * with pollEvents(). */
 	void sendEvents() override;
 
+	/*! \brief Subscribes \c observer to events of one type only.
+	 * Call once per type to receive several. */
+	[[nodiscard]] auto subscribe(ITypedObserver<SDL_Event>& observer,
+	                             SDL_EventType event_type) -> Subscription;
+
+	/*! \brief Enables or disables merging of consecutive motion / axis
+	 * events. Enabled by default. */
+	void setCoalescing(bool is_enabled);
+
+	//! \brief Events dropped by pollEvents() because the ring was full
+	auto getDroppedEventCount() const -> uint64_t;
+	//! \brief Events merged into a neighbour instead of dispatched
+	auto getCoalescedEventCount() const -> uint64_t;
+
+	static constexpr size_t kEventQueueCapacity = 1024;
+
     protected:
-	std::queue<SDL_Event> event_queue;
+	using TypedObserverRegistry =
+	    ObserverRegistry<ITypedObserver<SDL_Event>>;
+
+	void dispatch(const SDL_Event& event);
+	static auto try_coalesce(SDL_Event& pending, const SDL_Event& next)
+	    -> bool;
+
+	SpscRing<SDL_Event, kEventQueueCapacity> event_queue;
 	UniqueSdlPtr<SDL_Joystick> joydev_ptr;
 
-	std::mutex mutex;
+	std::unordered_map<Uint32, TypedObserverRegistry> observers_by_type;
+	bool is_coalescing{ true };
+	uint64_t coalesced_count{ 0 };
 };
 } // namespace elemental
   // clang-format off
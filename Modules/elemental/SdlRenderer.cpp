@@ -9,8 +9,11 @@
 
 #include "SdlRenderer.hpp"
 
+#include "Profiler.hpp"
+
 #include "types/input.hpp"
 #include "types/rendering.hpp"
+#include "util/culling.hpp"
 #include "util/debug.hpp"
 
 #include <IOCore/Exception.hpp>
@@ -20,6 +23,8 @@
 #include <fmt/core.h>
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <sstream>
 #include <utility>
@@ -106,6 +111,11 @@ void SdlRenderer::init(RendererSettings& settings)
 
 		HANDLE_SDL_ERROR("Could not set SDL_Renderer LogicalSize");
 	}
+	this->viewport = { { 0, 0 },
+		           { static_cast<uint32_t>(res_width),
+		             static_cast<uint32_t>(res_height) } };
+	this->geometry_call_count = 0;
+	this->geometry_vertex_count = 0;
 
 	this->is_initialized = true;
 }
@@ -121,6 +131,7 @@ void SdlRenderer::deactivate()
 	}
 
 	SDL_QuitSubSystem(SDL_INIT_VIDEO);
+	this->viewport = {};
 	this->is_initialized = false;
 }
 auto SdlRenderer::isInitialized() -> bool
@@ -160,8 +171,14 @@ auto SdlRenderer::getWindowSize() -> Area
 	return { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
 }
 
+auto SdlRenderer::getViewport() const -> Rectangle
+{
+	return this->viewport;
+}
+
 void SdlRenderer::clearScreen()
 {
+	PROFILE_FUNCTION();
 	ASSERT(this->sdl_renderer_ptr != nullptr);
 
 	// Set bg to black
@@ -173,6 +190,7 @@ void SdlRenderer::clearScreen()
 }
 void SdlRenderer::flip()
 {
+	PROFILE_FUNCTION();
 	ASSERT(this->sdl_renderer_ptr != nullptr);
 
 	// Set bg to black
@@ -182,9 +200,14 @@ void SdlRenderer::flip()
 /*! \todo convert this to a private method, used internally to wrap SDL_Blit */
 void SdlRenderer::blit(std::shared_ptr<void> image_data, Rectangle& placement)
 {
+	PROFILE_FUNCTION();
 	ASSERT(this->sdl_renderer_ptr != nullptr);
 	ASSERT(image_data.get() != nullptr);
 
+	if (!this->viewport.intersects(placement)) {
+		return;
+	}
+
 	try {
 		auto to_draw = std::static_pointer_cast<SDL_Texture>(image_data);
 		auto position = fromRectangle<SDL_Rect>(placement);
@@ -204,8 +227,213 @@ void SdlRenderer::blit(std::shared_ptr<void> image_data, Rectangle& placement)
 	}
 }
 
+void SdlRenderer::blit(
+    std::shared_ptr<void> image_data, const Rectangle& source,
+    Rectangle& placement
+)
+{
+	PROFILE_FUNCTION();
+	ASSERT(this->sdl_renderer_ptr != nullptr);
+	ASSERT(image_data.get() != nullptr);
+
+	if (!this->viewport.intersects(placement)) {
+		return;
+	}
+
+	auto* to_draw = static_cast<SDL_Texture*>(image_data.get());
+	auto source_rect = fromRectangle<SDL_Rect>(source);
+	auto position = fromRectangle<SDL_Rect>(placement);
+
+	if (SDL_RenderCopy(
+		this->sdl_renderer_ptr.get(), to_draw, &source_rect, &position
+	    ) < 0) {
+		HANDLE_SDL_ERROR("SDL_RenderCopy failed.");
+	}
+}
+
+void SdlRenderer::submitBatch(std::span<const SpriteInstance> sprites)
+{
+	PROFILE_FUNCTION();
+	ASSERT(this->sdl_renderer_ptr != nullptr);
+
+	if (sprites.empty()) {
+		return;
+	}
+
+	// Cull against the logical viewport first, so off-screen sprites
+	// never reach sorting or vertex generation.
+	auto& placements = this->batch_placements;
+	placements.clear();
+	for (const auto& sprite : sprites) {
+		ASSERT(sprite.texture != nullptr);
+		placements.push_back(sprite.placement);
+	}
+	this->batch_visible.resize(sprites.size());
+	this->batch_clipped.resize(sprites.size());
+	auto visible_count = culling::cull_rectangles(
+	    placements, this->viewport, this->batch_visible, this->batch_clipped
+	);
+
+	// Sort pointers rather than the sprites themselves; a stable sort
+	// keeps the submission order of sprites that share a texture.
+	auto& order = this->batch_order;
+	order.clear();
+	for (size_t index = 0; index < visible_count; ++index) {
+		order.push_back({ &sprites[this->batch_visible[index]],
+		                  this->batch_clipped[index] });
+	}
+	std::stable_sort(
+	    order.begin(),
+	    order.end(),
+	    [](const BatchItem& lhs, const BatchItem& rhs) {
+		    return std::less<void*>()(
+			lhs.sprite->texture, rhs.sprite->texture
+		    );
+	    }
+	);
+
+	auto run_begin = order.begin();
+	while (run_begin != order.end()) {
+		void* texture = run_begin->sprite->texture;
+		auto run_end = std::find_if(
+		    run_begin,
+		    order.end(),
+		    [texture](const BatchItem& item) {
+			    return item.sprite->texture != texture;
+		    }
+		);
+
+		this->draw_geometry(
+		    static_cast<SDL_Texture*>(texture),
+		    { &*run_begin, static_cast<size_t>(run_end - run_begin) }
+		);
+		run_begin = run_end;
+	}
+}
+
+void SdlRenderer::draw_geometry(
+    SDL_Texture* texture, std::span<const BatchItem> items
+)
+{
+	int texture_width, texture_height;
+	if (SDL_QueryTexture(
+		texture, nullptr, nullptr, &texture_width, &texture_height
+	    ) < 0) {
+		HANDLE_SDL_ERROR("SDL_QueryTexture failed.");
+	}
+	const auto kTexWidth = static_cast<float>(texture_width);
+	const auto kTexHeight = static_cast<float>(texture_height);
+	const SDL_Color kWhite{ 255, 255, 255, 255 };
+
+	auto& vertices = this->batch_vertices;
+	vertices.clear();
+
+	for (const auto& item : items) {
+		const auto& dest = item.sprite->placement;
+		const auto& src = item.sprite->source;
+		const auto& clipped = item.clipped;
+
+		float left = static_cast<float>(clipped.x());
+		float top = static_cast<float>(clipped.y());
+		float right = static_cast<float>(clipped.right());
+		float bottom = static_cast<float>(clipped.bottom());
+
+		float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+		if (!src.isEmpty()) {
+			u0 = static_cast<float>(src.x()) / kTexWidth;
+			v0 = static_cast<float>(src.y()) / kTexHeight;
+			u1 = static_cast<float>(src.right()) / kTexWidth;
+			v1 = static_cast<float>(src.bottom()) / kTexHeight;
+		}
+
+		// Shrink the texture coordinates by the same fraction that
+		// clipping removed from each edge of the quad.
+		if (clipped.width() != dest.width() ||
+		    clipped.height() != dest.height()) {
+			const float kUScale = (u1 - u0) / dest.width();
+			const float kVScale = (v1 - v0) / dest.height();
+			const float kU0 = u0, kV0 = v0;
+
+			u0 = kU0 + kUScale * (clipped.x() - dest.x());
+			u1 = kU0 + kUScale * (clipped.right() - dest.x());
+			v0 = kV0 + kVScale * (clipped.y() - dest.y());
+			v1 = kV0 + kVScale * (clipped.bottom() - dest.y());
+		}
+
+		vertices.push_back({ { left, top }, kWhite, { u0, v0 } });
+		vertices.push_back({ { right, top }, kWhite, { u1, v0 } });
+		vertices.push_back({ { right, bottom }, kWhite, { u1, v1 } });
+		vertices.push_back({ { left, bottom }, kWhite, { u0, v1 } });
+	}
+
+	// Every quad uses the same two-triangle pattern, so the index buffer
+	// only ever grows and is shared between draw calls.
+	auto& indices = this->batch_indices;
+	const size_t kQuadsIndexed = indices.size() / 6;
+	for (size_t quad = kQuadsIndexed; quad < items.size(); ++quad) {
+		const int kBase = static_cast<int>(quad * 4);
+		indices.insert(
+		    indices.end(),
+		    { kBase, kBase + 1, kBase + 2, kBase + 2, kBase + 3, kBase }
+		);
+	}
+
+	if (SDL_RenderGeometry(
+		this->sdl_renderer_ptr.get(),
+		texture,
+		vertices.data(),
+		static_cast<int>(vertices.size()),
+		indices.data(),
+		static_cast<int>(items.size() * 6)
+	    ) < 0) {
+		HANDLE_SDL_ERROR("SDL_RenderGeometry failed.");
+	}
+	++this->geometry_call_count;
+	this->geometry_vertex_count += vertices.size();
+}
+
+auto SdlRenderer::createTexture(SDL_Surface* surface) -> SdlPtr<SDL_Texture>
+{
+	ASSERT(this->sdl_renderer_ptr != nullptr);
+	ASSERT(surface != nullptr);
+
+	SdlPtr<SDL_Texture> texture =
+	    SDL_CreateTextureFromSurface(this->sdl_renderer_ptr.get(), surface);
+	if (nullptr == texture) {
+		HANDLE_SDL_ERROR("SDL_CreateTextureFromSurface failed.");
+	}
+	return texture;
+}
+
+auto SdlRenderer::loadTexture(const std::filesystem::path& image_path)
+    -> SdlPtr<SDL_Texture>
+{
+	ASSERT(this->sdl_renderer_ptr != nullptr);
+
+	UniqueSdlPtr<SDL_Surface> surface = nullptr;
+	surface = IMG_Load(image_path.string().c_str());
+	if (nullptr == surface) {
+		HANDLE_SDL_ERROR(fmt::format(
+				     "Could not load image {}: {}",
+				     image_path.string(),
+				     IMG_GetError()
+		)
+		                     .c_str());
+	}
+	return this->createTexture(surface);
+}
+
 SdlRenderer::SdlRenderer()
-    : IRenderer(), sdl_window_ptr(nullptr), sdl_renderer_ptr(nullptr)
+    : IRenderer()
+    , sdl_window_ptr(nullptr)
+    , sdl_renderer_ptr(nullptr)
+    , viewport()
+    , batch_placements()
+    , batch_visible()
+    , batch_clipped()
+    , batch_order()
+    , batch_vertices()
+    , batch_indices()
 {
 }
 
@@ -16,7 +16,11 @@
 
 #include "util/testing.hpp"
 
+#include <bit>
+#include <filesystem>
 #include <memory>
+#include <span>
+#include <vector>
 
 namespace elemental {
 class SdlRenderer;
@@ -36,35 +40,78 @@ struct SdlRenderer : public IRenderer
 	auto getResolution() -> Resolution override;
 	auto getWindowSize() -> Area override;
 
+	/*! \brief The logical drawing area. Draws that fall entirely
+	 * outside of it are culled before they reach SDL. */
+	auto getViewport() const -> Rectangle;
+
 	void clearScreen() override;
 	void flip() override;
 
 	void blit(std::shared_ptr<void> img_data,
 	          Rectangle& placement) override;
+	void blit(std::shared_ptr<void> img_data,
+	          const Rectangle& source,
+	          Rectangle& placement) override;
+
+	void submitBatch(std::span<const SpriteInstance> sprites) override;
+
+	/*! \name Texture creation
+	 * Both methods require an initialized renderer and throw exceptions
+	 * \{ */
+	auto createTexture(SDL_Surface* surface) -> SdlPtr<SDL_Texture>;
+	auto loadTexture(const std::filesystem::path& image_path)
+	    -> SdlPtr<SDL_Texture>;
+	/*! \} */
 
   protected:
 	bool is_initialized{ false };
 	SdlRenderer();
 
+	//! \brief A visible sprite and its placement clipped to the viewport
+	struct BatchItem {
+		const SpriteInstance* sprite;
+		Rectangle clipped;
+	};
+
+	void draw_geometry(SDL_Texture* texture,
+	                   std::span<const BatchItem> items);
+
 	SdlPtr<SDL_Window> sdl_window_ptr;
 	SdlPtr<SDL_Renderer> sdl_renderer_ptr;
+	Rectangle viewport{};
+
+	/*! \name Batch scratch buffers
+	 * Kept between frames so that steady-state batches do not allocate.
+	 * \{ */
+	std::vector<Rectangle> batch_placements;
+	std::vector<uint32_t> batch_visible;
+	std::vector<Rectangle> batch_clipped;
+	std::vector<BatchItem> batch_order;
+	std::vector<SDL_Vertex> batch_vertices;
+	std::vector<int> batch_indices;
+	/*! \} */
+
+	//! \brief SDL_RenderGeometry() calls and vertices, since init()
+	size_t geometry_call_count{ 0 };
+	size_t geometry_vertex_count{ 0 };
 };
 
+/* SDL_Rect and Rectangle are both four packed 32-bit integers, so the
+ * conversions are a bit-for-bit copy. Negative SDL coordinates wrap around,
+ * exactly as a static_cast would. */
+static_assert(sizeof(SDL_Rect) == sizeof(Rectangle));
+
 template<>
 inline auto
 IRenderer::toRectangle<SDL_Rect>(const SDL_Rect& other) -> Rectangle
 {
-	return { static_cast<uint32_t>(other.x), static_cast<uint32_t>(other.y),
-		 static_cast<uint32_t>(other.w),
-		 static_cast<uint32_t>(other.h) };
+	return std::bit_cast<Rectangle>(other);
 }
 template<>
 inline auto
 IRenderer::fromRectangle<SDL_Rect>(const Rectangle& other) -> SDL_Rect
 {
-	return { static_cast<int>(other.x), static_cast<int>(other.y),
-		 static_cast<int>(other.width),
-		 static_cast<int>(other.height) };
+	return std::bit_cast<SDL_Rect>(other);
 }
 } // namespace elemental
 
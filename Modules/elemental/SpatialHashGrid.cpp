@@ -0,0 +1,324 @@
+/* SpatialHashGrid.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "SpatialHashGrid.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <algorithm>
+
+using namespace elemental;
+
+namespace {
+constexpr uint32_t kNoCell = UINT32_MAX;
+}
+
+SpatialHashGrid::SpatialHashGrid(uint32_t cell_size)
+    : cell_size(std::max(cell_size, 1u))
+    , entries()
+    , entry_count(0)
+    , cells()
+    , occupied{ kNoCell, kNoCell, 0, 0 }
+{
+}
+
+auto SpatialHashGrid::cells_of(const Rectangle& bounds) const -> CellRange
+{
+	// An empty rectangle still sits in the cell of its corner
+	auto last_x = (bounds.right() > bounds.x()) ? bounds.right() - 1
+	                                            : bounds.x();
+	auto last_y = (bounds.bottom() > bounds.y()) ? bounds.bottom() - 1
+	                                             : bounds.y();
+	return { bounds.x() / cell_size,
+		 bounds.y() / cell_size,
+		 last_x / cell_size,
+		 last_y / cell_size };
+}
+
+auto SpatialHashGrid::find_cell(uint32_t cell_x, uint32_t cell_y) const
+    -> const std::vector<EntryID>*
+{
+	auto found = cells.find(key_of(cell_x, cell_y));
+	return (found != cells.end()) ? &found->second : nullptr;
+}
+
+void SpatialHashGrid::add_to_cells(EntryID id, const CellRange& range)
+{
+	for (auto cell_y = range.first_y; cell_y <= range.last_y; ++cell_y) {
+		for (auto cell_x = range.first_x; cell_x <= range.last_x;
+		     ++cell_x) {
+			cells[key_of(cell_x, cell_y)].push_back(id);
+		}
+	}
+	if (occupied.first_x == kNoCell) {
+		occupied = range;
+	} else {
+		occupied.first_x = std::min(occupied.first_x, range.first_x);
+		occupied.first_y = std::min(occupied.first_y, range.first_y);
+		occupied.last_x = std::max(occupied.last_x, range.last_x);
+		occupied.last_y = std::max(occupied.last_y, range.last_y);
+	}
+}
+
+void SpatialHashGrid::remove_from_cells(EntryID id, const CellRange& range)
+{
+	for (auto cell_y = range.first_y; cell_y <= range.last_y; ++cell_y) {
+		for (auto cell_x = range.first_x; cell_x <= range.last_x;
+		     ++cell_x) {
+			auto found = cells.find(key_of(cell_x, cell_y));
+			ASSERT(found != cells.end());
+			auto& ids = found->second;
+			auto position = std::find(ids.begin(), ids.end(), id);
+			ASSERT(position != ids.end());
+			*position = ids.back();
+			ids.pop_back();
+			if (ids.empty()) {
+				cells.erase(found);
+			}
+		}
+	}
+}
+
+void SpatialHashGrid::insert(EntryID id, const Rectangle& bounds)
+{
+	if (this->update(id, bounds)) {
+		return;
+	}
+	if (id >= entries.size()) {
+		entries.resize(static_cast<size_t>(id) + 1);
+	}
+	auto range = cells_of(bounds);
+	entries[id] = { bounds, range, true };
+	this->add_to_cells(id, range);
+	++entry_count;
+}
+
+auto SpatialHashGrid::update(EntryID id, const Rectangle& bounds) -> bool
+{
+	if (!this->contains(id)) {
+		return false;
+	}
+	auto& entry = entries[id];
+	auto range = cells_of(bounds);
+	if (range != entry.cells) {
+		this->remove_from_cells(id, entry.cells);
+		this->add_to_cells(id, range);
+		entry.cells = range;
+	}
+	entry.bounds = bounds;
+	return true;
+}
+
+auto SpatialHashGrid::remove(EntryID id) -> bool
+{
+	if (!this->contains(id)) {
+		return false;
+	}
+	auto& entry = entries[id];
+	this->remove_from_cells(id, entry.cells);
+	entry.is_present = false;
+	--entry_count;
+	if (entry_count == 0) {
+		occupied = { kNoCell, kNoCell, 0, 0 };
+	}
+	return true;
+}
+
+void SpatialHashGrid::clear()
+{
+	entries.clear();
+	cells.clear();
+	entry_count = 0;
+	occupied = { kNoCell, kNoCell, 0, 0 };
+}
+
+auto SpatialHashGrid::contains(EntryID id) const -> bool
+{
+	return id < entries.size() && entries[id].is_present;
+}
+
+auto SpatialHashGrid::getBounds(EntryID id) const -> const Rectangle*
+{
+	return this->contains(id) ? &entries[id].bounds : nullptr;
+}
+
+void SpatialHashGrid::queryRange(const Rectangle& area,
+                                 std::vector<EntryID>& results) const
+{
+	if (area.isEmpty() || entry_count == 0) {
+		return;
+	}
+	auto range = cells_of(area);
+	// Cells outside the occupied extent are known to be empty
+	range.first_x = std::max(range.first_x, occupied.first_x);
+	range.first_y = std::max(range.first_y, occupied.first_y);
+	range.last_x = std::min(range.last_x, occupied.last_x);
+	range.last_y = std::min(range.last_y, occupied.last_y);
+
+	for (auto cell_y = range.first_y;
+	     range.first_y <= range.last_y && cell_y <= range.last_y;
+	     ++cell_y) {
+		for (auto cell_x = range.first_x; cell_x <= range.last_x;
+		     ++cell_x) {
+			const auto* ids = find_cell(cell_x, cell_y);
+			if (ids == nullptr) {
+				continue;
+			}
+			for (auto id : *ids) {
+				const auto& bounds = entries[id].bounds;
+				if (!bounds.intersects(area)) {
+					continue;
+				}
+				// Report from one cell only: the one holding
+				// the overlap's top-left corner
+				auto corner_x = std::max(bounds.x(), area.x());
+				auto corner_y = std::max(bounds.y(), area.y());
+				if (corner_x / cell_size == cell_x &&
+				    corner_y / cell_size == cell_y) {
+					results.push_back(id);
+				}
+			}
+		}
+	}
+}
+
+void SpatialHashGrid::queryPoint(Point point,
+                                 std::vector<EntryID>& results) const
+{
+	const auto* ids = find_cell(point.x / cell_size, point.y / cell_size);
+	if (ids == nullptr) {
+		return;
+	}
+	for (auto id : *ids) {
+		if (entries[id].bounds.contains(point)) {
+			results.push_back(id);
+		}
+	}
+}
+
+auto SpatialHashGrid::queryNearest(Point point, uint32_t max_distance) const
+    -> std::optional<EntryID>
+{
+	if (entry_count == 0) {
+		return std::nullopt;
+	}
+
+	const int64_t kCenterX = point.x / cell_size;
+	const int64_t kCenterY = point.y / cell_size;
+	const int64_t kFirstX = occupied.first_x, kLastX = occupied.last_x;
+	const int64_t kFirstY = occupied.first_y, kLastY = occupied.last_y;
+	// Rings before this one lie entirely outside the occupied extent
+	const int64_t kFirstRing = std::max({ kFirstX - kCenterX,
+	                                      kCenterX - kLastX,
+	                                      kFirstY - kCenterY,
+	                                      kCenterY - kLastY,
+	                                      int64_t{ 0 } });
+	// Beyond this ring, no occupied cell is left
+	const int64_t kMaxRing = std::max({ kCenterX - kFirstX,
+	                                    kLastX - kCenterX,
+	                                    kCenterY - kFirstY,
+	                                    kLastY - kCenterY,
+	                                    int64_t{ 0 } });
+
+	const uint64_t kLimit =
+	    static_cast<uint64_t>(max_distance) * max_distance;
+	std::optional<EntryID> best;
+	uint64_t best_distance = UINT64_MAX;
+
+	auto consider = [&](const std::vector<EntryID>& ids) {
+		for (auto id : ids) {
+			auto distance = squared_distance(point, entries[id].bounds);
+			if (distance < best_distance) {
+				best_distance = distance;
+				best = id;
+			}
+		}
+	};
+	auto visit_row = [&](int64_t cell_y, int64_t first_x, int64_t last_x) {
+		if (cell_y < kFirstY || cell_y > kLastY) {
+			return;
+		}
+		for (auto cell_x = std::max(first_x, kFirstX);
+		     cell_x <= std::min(last_x, kLastX); ++cell_x) {
+			if (const auto* ids = find_cell(
+			        static_cast<uint32_t>(cell_x),
+			        static_cast<uint32_t>(cell_y)
+			    )) {
+				consider(*ids);
+			}
+		}
+	};
+	auto visit_column = [&](int64_t cell_x, int64_t first_y,
+	                        int64_t last_y) {
+		if (cell_x < kFirstX || cell_x > kLastX) {
+			return;
+		}
+		for (auto cell_y = std::max(first_y, kFirstY);
+		     cell_y <= std::min(last_y, kLastY); ++cell_y) {
+			if (const auto* ids = find_cell(
+			        static_cast<uint32_t>(cell_x),
+			        static_cast<uint32_t>(cell_y)
+			    )) {
+				consider(*ids);
+			}
+		}
+	};
+	// Cells of a ring that lie inside the occupied extent
+	auto clipped_length = [](int64_t first, int64_t last, int64_t low,
+	                         int64_t high) {
+		return std::max<int64_t>(
+		    std::min(last, high) - std::max(first, low) + 1, 0
+		);
+	};
+
+	// Walking rings only pays off while it probes fewer cells than the
+	// map holds; past that, every occupied cell is scanned once instead
+	auto probe_budget = static_cast<int64_t>(cells.size());
+	for (int64_t ring = kFirstRing; ring <= kMaxRing; ++ring) {
+		// Cells of this ring are at least (ring - 1) cells away
+		auto ring_distance = static_cast<uint64_t>(
+		    std::max<int64_t>(ring - 1, 0) * cell_size
+		);
+		if (ring_distance * ring_distance > std::min(best_distance, kLimit)) {
+			break;
+		}
+
+		auto row_length = clipped_length(kCenterX - ring,
+		                                 kCenterX + ring, kFirstX,
+		                                 kLastX);
+		auto column_length = clipped_length(kCenterY - ring + 1,
+		                                    kCenterY + ring - 1,
+		                                    kFirstY, kLastY);
+		probe_budget -= 2 * (row_length + column_length);
+		if (probe_budget < 0) {
+			for (const auto& [key, ids] : cells) {
+				consider(ids);
+			}
+			break;
+		}
+
+		visit_row(kCenterY - ring, kCenterX - ring, kCenterX + ring);
+		if (ring == 0) {
+			continue;
+		}
+		visit_row(kCenterY + ring, kCenterX - ring, kCenterX + ring);
+		visit_column(kCenterX - ring, kCenterY - ring + 1,
+		             kCenterY + ring - 1);
+		visit_column(kCenterX + ring, kCenterY - ring + 1,
+		             kCenterY + ring - 1);
+	}
+
+	if (best && best_distance > kLimit) {
+		return std::nullopt;
+	}
+	return best;
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,89 @@
+/* SpatialHashGrid.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "ISpatialIndex.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace elemental {
+
+/*! \brief Uniform grid of square cells, stored sparsely in a hash map.
+ *
+ * Every entry is listed in each cell its bounds overlap, so lookups cost
+ * one hash probe per cell covered. Best when entries are of similar size,
+ * around the cell size or smaller; huge entries cover many cells. Moving
+ * an entry within the same cells only rewrites its bounds.
+ *
+ * A range query reports an entry only from the cell holding the top-left
+ * corner of its overlap with the query, so entries spanning several cells
+ * are reported once without any per-query bookkeeping. */
+class SpatialHashGrid : public ISpatialIndex
+{
+  public:
+	explicit SpatialHashGrid(uint32_t cell_size = 128);
+	~SpatialHashGrid() override = default;
+
+	void insert(EntryID id, const Rectangle& bounds) override;
+	auto update(EntryID id, const Rectangle& bounds) -> bool override;
+	auto remove(EntryID id) -> bool override;
+	void clear() override;
+
+	auto contains(EntryID id) const -> bool override;
+	auto size() const -> size_t override { return entry_count; }
+	auto getBounds(EntryID id) const -> const Rectangle* override;
+
+	void queryRange(const Rectangle& area,
+	                std::vector<EntryID>& results) const override;
+	void queryPoint(Point point,
+	                std::vector<EntryID>& results) const override;
+	auto queryNearest(Point point, uint32_t max_distance = UINT32_MAX) const
+	    -> std::optional<EntryID> override;
+
+	auto getCellSize() const -> uint32_t { return cell_size; }
+	//! \brief Cells holding at least one entry
+	auto getCellCount() const -> size_t { return cells.size(); }
+
+  protected:
+	//! Inclusive range of cell coordinates
+	struct CellRange {
+		uint32_t first_x, first_y, last_x, last_y;
+		auto operator==(const CellRange&) const -> bool = default;
+	};
+	struct Entry {
+		Rectangle bounds;
+		CellRange cells;
+		bool is_present;
+	};
+
+	auto cells_of(const Rectangle& bounds) const -> CellRange;
+	static auto key_of(uint32_t cell_x, uint32_t cell_y) -> uint64_t
+	{
+		return (static_cast<uint64_t>(cell_y) << 32) | cell_x;
+	}
+	auto find_cell(uint32_t cell_x, uint32_t cell_y) const
+	    -> const std::vector<EntryID>*;
+	void add_to_cells(EntryID id, const CellRange& range);
+	void remove_from_cells(EntryID id, const CellRange& range);
+
+	uint32_t cell_size;
+	std::vector<Entry> entries;
+	size_t entry_count;
+	std::unordered_map<uint64_t, std::vector<EntryID>> cells;
+
+	// Every cell ever used lies inside; bounds the nearest-entry search
+	CellRange occupied;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
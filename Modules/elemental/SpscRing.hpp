@@ -0,0 +1,126 @@
+/* SpscRing.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "INonCopyable.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace elemental {
+
+/*! \brief Fixed-capacity, lock-free single-producer/single-consumer queue.
+ *
+ * One thread may push and one (other) thread may pop at the same time
+ * without locks; neither side ever waits for the other. When the ring is
+ * full, tryPush() drops the item and counts it as an overflow.
+ *
+ * \tparam Capacity number of slots; must be a power of two */
+template<typename T, size_t Capacity>
+class SpscRing : private INonCopyable
+{
+	static_assert(Capacity >= 2 && std::has_single_bit(Capacity),
+	              "SpscRing capacity must be a power of two");
+
+  public:
+	SpscRing() = default;
+
+	/*! \brief Producer side: appends \c item.
+	 * \returns false, and counts an overflow, if the ring is full */
+	auto tryPush(const T& item) -> bool
+	{
+		auto tail = tail_index.load(std::memory_order_relaxed);
+		if (tail - cached_head == Capacity) {
+			cached_head = head_index.load(std::memory_order_acquire);
+			if (tail - cached_head == Capacity) {
+				overflow_count.fetch_add(
+				    1, std::memory_order_relaxed
+				);
+				return false;
+			}
+		}
+
+		slots[tail & kIndexMask] = item;
+		tail_index.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/*! \brief Consumer side: moves the oldest item into \c item.
+	 * \returns false if the ring is empty */
+	auto tryPop(T& item) -> bool
+	{
+		auto head = head_index.load(std::memory_order_relaxed);
+		if (head == cached_tail) {
+			cached_tail = tail_index.load(std::memory_order_acquire);
+			if (head == cached_tail) {
+				return false;
+			}
+		}
+
+		item = std::move(slots[head & kIndexMask]);
+		head_index.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	//! \brief Consumer side: discards everything currently queued.
+	void clear()
+	{
+		auto tail = tail_index.load(std::memory_order_acquire);
+		cached_tail = tail;
+		head_index.store(tail, std::memory_order_release);
+	}
+
+	/*! \brief Number of queued items. Exact only when called from the
+	 * producer or consumer thread while the other side is idle. */
+	auto size() const -> size_t
+	{
+		auto head = head_index.load(std::memory_order_acquire);
+		auto tail = tail_index.load(std::memory_order_acquire);
+		return tail - head;
+	}
+	auto empty() const -> bool { return size() == 0; }
+	static constexpr auto capacity() -> size_t { return Capacity; }
+
+	//! \brief Items dropped by tryPush() because the ring was full
+	auto getOverflowCount() const -> uint64_t
+	{
+		return overflow_count.load(std::memory_order_relaxed);
+	}
+
+  protected:
+	static constexpr size_t kIndexMask = Capacity - 1;
+	// Keeps each side's hot indices on its own cache line
+	static constexpr size_t kCacheLineSize = 64;
+
+	// Indices increase monotonically and are masked on access, so a full
+	// ring (tail - head == Capacity) is distinguishable from an empty one.
+
+	//! \name Consumer-owned \{
+	alignas(kCacheLineSize) std::atomic<size_t> head_index{ 0 };
+	size_t cached_tail{ 0 };
+	//! \}
+
+	//! \name Producer-owned \{
+	alignas(kCacheLineSize) std::atomic<size_t> tail_index{ 0 };
+	size_t cached_head{ 0 };
+	std::atomic<uint64_t> overflow_count{ 0 };
+	//! \}
+
+	alignas(kCacheLineSize) std::array<T, Capacity> slots{};
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
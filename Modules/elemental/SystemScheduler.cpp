@@ -0,0 +1,170 @@
+/* SystemScheduler.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "SystemScheduler.hpp"
+
+#include "Profiler.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+
+using namespace elemental;
+using namespace std::chrono;
+
+namespace {
+auto shares_type(const std::vector<std::type_index>& lhs,
+                 const std::vector<std::type_index>& rhs) -> bool
+{
+	return std::any_of(lhs.begin(), lhs.end(), [&](const auto& type) {
+		return std::find(rhs.begin(), rhs.end(), type) != rhs.end();
+	});
+}
+} // namespace
+
+SystemScheduler::SystemScheduler(ThreadPool& pool)
+    : pool(pool), systems(), pending_dependencies(), error_mutex()
+{
+}
+
+auto SystemScheduler::add_system(System system) -> SystemID
+{
+	auto new_id = systems.size();
+
+	for (SystemID earlier = 0; earlier < new_id; ++earlier) {
+		auto& other = systems[earlier];
+		bool conflicts = shares_type(other.writes, system.writes) ||
+		                 shares_type(other.writes, system.reads) ||
+		                 shares_type(other.reads, system.writes);
+		if (conflicts) {
+			system.dependencies.push_back(earlier);
+			other.dependents.push_back(new_id);
+		}
+	}
+
+	systems.push_back(std::move(system));
+	pending_dependencies =
+	    std::make_unique<std::atomic<size_t>[]>(systems.size());
+	return new_id;
+}
+
+auto SystemScheduler::getName(SystemID system) const -> const std::string&
+{
+	if (system >= systems.size()) {
+		throw IOCore::Exception(
+		    fmt::format("Unknown system id {}", system)
+		);
+	}
+	return systems[system].name;
+}
+
+auto SystemScheduler::getDependencies(SystemID system) const
+    -> const std::vector<SystemID>&
+{
+	if (system >= systems.size()) {
+		throw IOCore::Exception(
+		    fmt::format("Unknown system id {}", system)
+		);
+	}
+	return systems[system].dependencies;
+}
+
+void SystemScheduler::run(ComponentFactory& components, nanoseconds step)
+{
+	PROFILE_FUNCTION();
+	if (systems.empty()) {
+		return;
+	}
+
+	// Pools are created up front: creating one resizes the factory's
+	// pool table, which systems running in parallel must not see.
+	for (auto& system : systems) {
+		system.prepare(components);
+	}
+
+	tick_components = &components;
+	tick_step = step;
+	has_failed.store(false);
+	first_error = nullptr;
+	remaining_systems.store(systems.size(), std::memory_order_relaxed);
+
+	std::vector<SystemID> roots;
+	for (SystemID id = 0; id < systems.size(); ++id) {
+		pending_dependencies[id].store(
+		    systems[id].dependencies.size(), std::memory_order_relaxed
+		);
+		if (systems[id].dependencies.empty()) {
+			roots.push_back(id);
+		}
+	}
+	for (auto root : roots) {
+		pool.submit([this, root]() { this->run_from(root); });
+	}
+
+	// Blocking here would starve the pool when run() is itself a task
+	pool.helpUntil([this]() {
+		return remaining_systems.load(std::memory_order_acquire) == 0;
+	});
+
+	if (first_error) {
+		std::rethrow_exception(first_error);
+	}
+}
+
+void SystemScheduler::run_from(SystemID system)
+{
+	std::vector<SystemID> ready;
+
+	// Keeps running one released dependent on this thread and hands the
+	// others to the pool, so chains of systems avoid a queue round-trip.
+	while (true) {
+		if (!has_failed.load(std::memory_order_acquire)) {
+			try {
+				systems[system].function(
+				    *tick_components, tick_step
+				);
+			} catch (...) {
+				auto lock = std::lock_guard(error_mutex);
+				if (!first_error) {
+					first_error = std::current_exception();
+				}
+				has_failed.store(true, std::memory_order_release);
+			}
+		}
+
+		ready.clear();
+		finish(system, ready);
+		if (ready.empty()) {
+			return;
+		}
+		for (size_t index = 1; index < ready.size(); ++index) {
+			auto next = ready[index];
+			pool.submit([this, next]() { this->run_from(next); });
+		}
+		system = ready.front();
+	}
+}
+
+void SystemScheduler::finish(SystemID system, std::vector<SystemID>& ready)
+{
+	for (auto dependent : systems[system].dependents) {
+		if (pending_dependencies[dependent].fetch_sub(
+			1, std::memory_order_acq_rel
+		    ) == 1) {
+			ready.push_back(dependent);
+		}
+	}
+
+	remaining_systems.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
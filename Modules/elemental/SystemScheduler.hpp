@@ -0,0 +1,132 @@
+/* SystemScheduler.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "ComponentFactory.hpp"
+#include "INonCopyable.hpp"
+#include "ThreadPool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+namespace elemental {
+
+//! \brief Component types a system only reads
+template<typename... TComponents>
+struct Reads {
+	static auto types() -> std::vector<std::type_index>
+	{
+		return { std::type_index(typeid(TComponents))... };
+	}
+	static void preparePools(ComponentFactory& components)
+	{
+		(components.getPool<TComponents>(), ...);
+	}
+};
+
+//! \brief Component types a system may modify
+template<typename... TComponents>
+struct Writes : Reads<TComponents...> {};
+
+/*! \brief Runs simulation systems in parallel where their data allows it.
+ *
+ * Each system declares the component types it reads and writes. A system
+ * depends on every earlier-registered system that writes a type it touches,
+ * or that reads a type it writes; all other systems may run at the same
+ * time. run() executes one tick: ready systems go to the thread pool, and
+ * each finished system releases its dependents.
+ *
+ * Systems must not touch component types they did not declare, nor add or
+ * remove components of the types another concurrent system uses. */
+class SystemScheduler : private INonCopyable
+{
+  public:
+	using SystemID = size_t;
+	using SystemFunction =
+	    std::function<void(ComponentFactory&, std::chrono::nanoseconds)>;
+
+	explicit SystemScheduler(ThreadPool& pool);
+
+	/*! \brief Registers a system to run every tick, after the earlier
+	 * systems it conflicts with.
+	 * \tparam TReads  Reads<...> of the types \c function only reads
+	 * \tparam TWrites Writes<...> of the types \c function modifies */
+	template<typename TReads = Reads<>, typename TWrites = Writes<>>
+	auto addSystem(std::string name, SystemFunction function) -> SystemID
+	{
+		return this->add_system({ std::move(name),
+		                          std::move(function),
+		                          TReads::types(),
+		                          TWrites::types(),
+		                          &prepare_pools<TReads, TWrites>,
+		                          {},
+		                          {} });
+	}
+
+	/*! \brief Runs every system once and waits for all of them, running
+	 * pool tasks meanwhile, so it may be called from a pool thread.
+	 * Rethrows the first exception a system threw; systems that had not
+	 * started by then are skipped for this tick. */
+	void run(ComponentFactory& components, std::chrono::nanoseconds step);
+
+	auto getSystemCount() const -> size_t { return systems.size(); }
+	auto getName(SystemID system) const -> const std::string&;
+	//! \brief The earlier systems \c system waits for each tick
+	auto getDependencies(SystemID system) const
+	    -> const std::vector<SystemID>&;
+
+  protected:
+	struct System {
+		std::string name;
+		SystemFunction function;
+		std::vector<std::type_index> reads;
+		std::vector<std::type_index> writes;
+		void (*prepare)(ComponentFactory&);
+
+		std::vector<SystemID> dependencies;
+		std::vector<SystemID> dependents;
+	};
+
+	template<typename TReads, typename TWrites>
+	static void prepare_pools(ComponentFactory& components)
+	{
+		TReads::preparePools(components);
+		TWrites::preparePools(components);
+	}
+
+	auto add_system(System system) -> SystemID;
+	void run_from(SystemID system);
+	void finish(SystemID system, std::vector<SystemID>& ready);
+
+	ThreadPool& pool;
+	std::vector<System> systems;
+
+	// State of the tick in progress
+	ComponentFactory* tick_components{ nullptr };
+	std::chrono::nanoseconds tick_step{ 0 };
+	std::unique_ptr<std::atomic<size_t>[]> pending_dependencies;
+	std::atomic<bool> has_failed{ false };
+	std::exception_ptr first_error;
+
+	std::mutex error_mutex;
+	std::atomic<size_t> remaining_systems{ 0 };
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
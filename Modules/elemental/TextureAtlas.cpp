@@ -0,0 +1,279 @@
+/* TextureAtlas.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "TextureAtlas.hpp"
+
+#include "SdlRenderer.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <SDL.h>
+#include <SDL_image.h>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <string>
+#include <utility>
+
+using namespace elemental;
+
+namespace {
+auto to_sdl_rect(const TextureAtlas::Slot& slot) -> SDL_Rect
+{
+	return { static_cast<int>(slot.position.x),
+		 static_cast<int>(slot.position.y),
+		 static_cast<int>(slot.size.width),
+		 static_cast<int>(slot.size.height) };
+}
+} // namespace
+
+TextureAtlas::TextureAtlas(Area page_size, uint32_t padding)
+    : page_size(page_size)
+    , padding(padding)
+    , pages()
+    , staged()
+    , packed()
+    , slots()
+{
+}
+
+TextureAtlas::~TextureAtlas() = default;
+
+void TextureAtlas::addSurface(
+    const std::string& name, UniqueSdlPtr<SDL_Surface>&& surface
+)
+{
+	ASSERT(surface != nullptr);
+
+	auto is_staged = std::any_of(
+	    staged.begin(),
+	    staged.end(),
+	    [&name](const StagedImage& image) { return image.name == name; }
+	);
+	if (is_staged || this->hasRegion(name)) {
+		throw IOCore::Exception(
+		    fmt::format("TextureAtlas: duplicate image name '{}'", name)
+		);
+	}
+	staged.push_back({ name, std::move(surface) });
+}
+
+void TextureAtlas::addImage(
+    const std::filesystem::path& image_path, const std::string& name
+)
+{
+	UniqueSdlPtr<SDL_Surface> surface = nullptr;
+	surface = IMG_Load(image_path.string().c_str());
+	if (nullptr == surface) {
+		throw IOCore::Exception(fmt::format(
+		    "TextureAtlas: could not load image {}: {}",
+		    image_path.string(),
+		    IMG_GetError()
+		));
+	}
+	this->addSurface(
+	    name.empty() ? image_path.string() : name, std::move(surface)
+	);
+}
+
+void TextureAtlas::pack()
+{
+	// Tallest first: the skyline packer wastes the least space that way
+	std::stable_sort(
+	    staged.begin(),
+	    staged.end(),
+	    [](const StagedImage& lhs, const StagedImage& rhs) {
+		    return lhs.surface->h > rhs.surface->h;
+	    }
+	);
+
+	for (auto image = staged.begin(); image != staged.end(); ++image) {
+		try {
+			slots.emplace(image->name, this->place(*image));
+		} catch (...) {
+			// Drop the moved-from images and the one that failed;
+			// the rest stay staged for the next pack()
+			staged.erase(staged.begin(), std::next(image));
+			throw;
+		}
+		packed.push_back(std::move(*image));
+	}
+	staged.clear();
+}
+
+auto TextureAtlas::place(const StagedImage& image) -> Slot
+{
+	const auto kWidth = static_cast<uint32_t>(image.surface->w);
+	const auto kHeight = static_cast<uint32_t>(image.surface->h);
+
+	if (kWidth + padding > page_size.width ||
+	    kHeight + padding > page_size.height) {
+		throw IOCore::Exception(fmt::format(
+		    "TextureAtlas: image '{}' ({}x{}) does not fit in a {}x{} "
+		    "page",
+		    image.name,
+		    kWidth,
+		    kHeight,
+		    page_size.width,
+		    page_size.height
+		));
+	}
+
+	for (size_t index = 0; index < pages.size(); ++index) {
+		auto position = pages[index].packer.insert(
+		    kWidth + padding, kHeight + padding
+		);
+		if (position.has_value()) {
+			return { index, *position, { kWidth, kHeight } };
+		}
+	}
+
+	pages.push_back({ RectPacker(page_size), nullptr });
+	auto position =
+	    pages.back().packer.insert(kWidth + padding, kHeight + padding);
+	ASSERT(position.has_value());
+
+	return { pages.size() - 1, *position, { kWidth, kHeight } };
+}
+
+void TextureAtlas::upload(SdlRenderer& renderer)
+{
+	if (!staged.empty()) {
+		this->pack();
+	}
+
+	for (size_t index = 0; index < pages.size(); ++index) {
+		if (pages[index].texture == nullptr) {
+			this->compose_page(renderer, index);
+		}
+	}
+
+	// Images packed into pages that already had a texture
+	for (auto& image : packed) {
+		auto& slot = slots.at(image.name);
+		auto& texture = pages[slot.page].texture;
+		auto rect = to_sdl_rect(slot);
+
+		// The renderer picked the page format when it created the
+		// texture (often ARGB8888); the pixels must match it.
+		Uint32 page_format = SDL_PIXELFORMAT_UNKNOWN;
+		UniqueSdlPtr<SDL_Surface> converted = nullptr;
+		if (SDL_QueryTexture(
+			texture, &page_format, nullptr, nullptr, nullptr
+		    ) == 0) {
+			converted = SDL_ConvertSurfaceFormat(
+			    image.surface, page_format, 0
+			);
+		}
+		if (nullptr == converted ||
+		    SDL_UpdateTexture(
+			texture, &rect, converted->pixels, converted->pitch
+		    ) < 0) {
+			throw IOCore::Exception(fmt::format(
+			    "TextureAtlas: could not update page {}: {}",
+			    slot.page,
+			    SDL_GetError()
+			));
+		}
+	}
+	packed.clear();
+}
+
+/* Builds a new page texture from every packed image that belongs to it, and
+ * drops those images from the pending list. */
+void TextureAtlas::compose_page(SdlRenderer& renderer, size_t page_index)
+{
+	UniqueSdlPtr<SDL_Surface> page_pixels = nullptr;
+	page_pixels = SDL_CreateRGBSurfaceWithFormat(
+	    0,
+	    static_cast<int>(page_size.width),
+	    static_cast<int>(page_size.height),
+	    32,
+	    SDL_PIXELFORMAT_RGBA32
+	);
+	if (nullptr == page_pixels) {
+		throw IOCore::Exception(fmt::format(
+		    "TextureAtlas: could not allocate page {}: {}",
+		    page_index,
+		    SDL_GetError()
+		));
+	}
+
+	auto is_on_page = [&](const StagedImage& image) {
+		return slots.at(image.name).page == page_index;
+	};
+	for (auto& image : packed) {
+		if (!is_on_page(image)) {
+			continue;
+		}
+		auto rect = to_sdl_rect(slots.at(image.name));
+
+		// Copy the pixels as-is, alpha channel included
+		SDL_SetSurfaceBlendMode(image.surface, SDL_BLENDMODE_NONE);
+		if (SDL_BlitSurface(image.surface, nullptr, page_pixels, &rect) <
+		    0) {
+			throw IOCore::Exception(fmt::format(
+			    "TextureAtlas: could not compose page {}: {}",
+			    page_index,
+			    SDL_GetError()
+			));
+		}
+	}
+	std::erase_if(packed, is_on_page);
+
+	auto& page = pages[page_index];
+	page.texture = renderer.createTexture(page_pixels);
+	SDL_SetTextureBlendMode(page.texture, SDL_BLENDMODE_BLEND);
+}
+
+auto TextureAtlas::hasRegion(const std::string& name) const -> bool
+{
+	return slots.contains(name);
+}
+
+auto TextureAtlas::getRegion(const std::string& name) const -> AtlasRegion
+{
+	auto slot_iter = slots.find(name);
+	if (slot_iter == slots.end()) {
+		throw IOCore::Exception(
+		    fmt::format("TextureAtlas: no image named '{}'", name)
+		);
+	}
+
+	const auto& slot = slot_iter->second;
+	const auto& texture = pages[slot.page].texture;
+	if (texture == nullptr) {
+		throw IOCore::Exception(fmt::format(
+		    "TextureAtlas: image '{}' has not been uploaded yet", name
+		));
+	}
+	return { texture, Rectangle{ slot.position, slot.size } };
+}
+
+auto TextureAtlas::getOccupancy() const -> double
+{
+	if (pages.empty()) {
+		return 0.0;
+	}
+
+	uint64_t used_area = 0;
+	for (const auto& [name, slot] : slots) {
+		used_area += static_cast<uint64_t>(slot.size.width) *
+		             slot.size.height;
+	}
+	const auto kTotalArea = static_cast<double>(page_size.width) *
+	                        page_size.height * pages.size();
+
+	return static_cast<double>(used_area) / kTotalArea;
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,114 @@
+/* TextureAtlas.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "RectPacker.hpp"
+#include "SDL_Memory.hpp"
+
+#include "types/rendering.hpp"
+
+#include <SDL.h>
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace elemental {
+
+class SdlRenderer;
+
+/*! \brief A named image inside an atlas page. \c texture and \c source can
+ * be passed straight to IRenderer::blit() or used in a SpriteInstance. */
+struct AtlasRegion {
+	SdlPtr<SDL_Texture> texture;
+	Rectangle source;
+};
+
+/*! \brief Packs many small images into a few large textures, so that
+ * drawing them needs a handful of texture switches instead of one per image.
+ *
+ * Usage: add images with addImage() / addSurface(), call pack() to lay them
+ * out, then upload() to create the page textures. Regions can be looked up
+ * by name afterwards. Images added after an upload are packed into the
+ * remaining space and copied into the existing page textures by the next
+ * upload() call. */
+class TextureAtlas
+{
+  public:
+	//! \brief Where an image landed: the page index and its rectangle.
+	struct Slot {
+		size_t page;
+		Point position;
+		Area size;
+	};
+
+	explicit TextureAtlas(Area page_size = { 2048, 2048 },
+	                      uint32_t padding = 1);
+	virtual ~TextureAtlas();
+
+	/*! \brief Stages an image for packing, taking ownership of the
+	 * surface. Throws if the name is already in use. */
+	void addSurface(const std::string& name,
+	                UniqueSdlPtr<SDL_Surface>&& surface);
+
+	/*! \brief Loads an image with SDL_image and stages it under the
+	 * given name (the file path, if empty). Throws exceptions. */
+	void addImage(const std::filesystem::path& image_path,
+	              const std::string& name = "");
+
+	/*! \brief Lays out every staged image, opening new pages as needed.
+	 * Throws if an image is larger than a page; that image is dropped,
+	 * and the ones not packed yet stay staged. */
+	void pack();
+
+	/*! \brief Creates the textures of new pages and copies images
+	 * packed since the last upload into them. Throws exceptions. */
+	void upload(SdlRenderer& renderer);
+
+	auto hasRegion(const std::string& name) const -> bool;
+	auto getRegion(const std::string& name) const -> AtlasRegion;
+
+	auto getPageCount() const -> size_t { return pages.size(); }
+	auto getPageSize() const -> Area { return page_size; }
+	auto getSlots() const -> const std::unordered_map<std::string, Slot>&
+	{
+		return slots;
+	}
+
+	//! \brief Used area divided by the area of all pages.
+	auto getOccupancy() const -> double;
+
+  protected:
+	struct Page {
+		RectPacker packer;
+		SdlPtr<SDL_Texture> texture;
+	};
+	struct StagedImage {
+		std::string name;
+		UniqueSdlPtr<SDL_Surface> surface;
+	};
+
+	auto place(const StagedImage& image) -> Slot;
+	void compose_page(SdlRenderer& renderer, size_t page_index);
+
+	Area page_size;
+	uint32_t padding;
+
+	std::vector<Page> pages;
+	std::vector<StagedImage> staged;
+	std::vector<StagedImage> packed;
+	std::unordered_map<std::string, Slot> slots;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,66 @@
+/* TextureCache.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "TextureCache.hpp"
+
+#include "SdlRenderer.hpp"
+
+#include <SDL.h>
+
+#include <filesystem>
+#include <string>
+
+using namespace elemental;
+
+TextureCache::TextureCache(SdlRenderer& renderer, size_t budget_bytes)
+    : ResourceCache(
+	  budget_bytes,
+	  [&renderer](const std::string& key) {
+		  return renderer.loadTexture(key);
+	  },
+	  &TextureCache::estimateBytes
+      )
+{
+}
+
+TextureCache::~TextureCache() = default;
+
+auto TextureCache::acquire(const std::filesystem::path& image_path)
+    -> SdlPtr<SDL_Texture>
+{
+	return ResourceCache::acquire(make_key(image_path));
+}
+
+void TextureCache::insert(
+    const std::filesystem::path& image_path, SdlPtr<SDL_Texture> texture
+)
+{
+	ResourceCache::insert(make_key(image_path), std::move(texture));
+}
+
+auto TextureCache::estimateBytes(const SdlPtr<SDL_Texture>& texture)
+    -> size_t
+{
+	int width = 0, height = 0;
+	if (texture == nullptr ||
+	    SDL_QueryTexture(texture, nullptr, nullptr, &width, &height) < 0) {
+		return 0;
+	}
+	return static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+}
+
+/* "./a/../b.png" and "b.png" refer to the same file and share an entry */
+auto TextureCache::make_key(const std::filesystem::path& image_path)
+    -> std::string
+{
+	return image_path.lexically_normal().generic_string();
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,50 @@
+/* TextureCache.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "ResourceCache.hpp"
+#include "SDL_Memory.hpp"
+
+#include <SDL.h>
+
+#include <filesystem>
+
+namespace elemental {
+
+class SdlRenderer;
+
+/*! \brief Path-keyed cache of textures loaded through an SdlRenderer.
+ *
+ * Loading the same image twice returns the same texture. Texture sizes are
+ * estimated as width × height × 4 bytes, which is what most drivers
+ * allocate regardless of the source format. */
+class TextureCache : public ResourceCache<SDL_Texture, SdlPtr<SDL_Texture>>
+{
+  public:
+	TextureCache(SdlRenderer& renderer, size_t budget_bytes);
+	~TextureCache() override;
+
+	auto acquire(const std::filesystem::path& image_path)
+	    -> SdlPtr<SDL_Texture>;
+	void insert(const std::filesystem::path& image_path,
+	            SdlPtr<SDL_Texture> texture);
+
+	//! \brief Approximate GPU memory used by a texture
+	static auto estimateBytes(const SdlPtr<SDL_Texture>& texture) -> size_t;
+
+  protected:
+	static auto make_key(const std::filesystem::path& image_path)
+	    -> std::string;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,228 @@
+/* ThreadPool.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+using namespace elemental;
+
+namespace {
+// Cheap per-thread random numbers for picking steal victims
+auto next_random() -> uint32_t
+{
+	static thread_local uint32_t state = static_cast<uint32_t>(
+	    std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1
+	);
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+} // namespace
+
+void TaskHandle::wait() const
+{
+	if (!state) {
+		return;
+	}
+	state->pool.wait_for(*state);
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+}
+
+auto TaskHandle::then(std::function<void()> task) const -> TaskHandle
+{
+	if (!state) {
+		return {};
+	}
+	auto next =
+	    std::make_shared<details::TaskState>(std::move(task), state->pool);
+	{
+		auto lock = std::lock_guard(state->continuation_mutex);
+		if (!state->is_finished) {
+			state->continuations.push_back(next);
+			return TaskHandle(next);
+		}
+	}
+	state->pool.enqueue(next);
+	return TaskHandle(next);
+}
+
+ThreadPool::ThreadPool(unsigned thread_count)
+    : workers(), injection_mutex(), injection_queue()
+{
+	if (thread_count == 0) {
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// Every deque exists before any worker may try to steal from it
+	for (unsigned index = 0; index < thread_count; ++index) {
+		workers.push_back(std::make_unique<Worker>());
+	}
+	for (unsigned index = 0; index < thread_count; ++index) {
+		workers[index]->thread = std::thread(
+		    [this, index]() { this->worker_loop(index); }
+		);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	is_stopping.store(true);
+	work_epoch.fetch_add(1);
+	work_epoch.notify_all();
+
+	for (auto& worker : workers) {
+		worker->thread.join();
+	}
+
+	// Drop whatever never ran
+	TaskState* task = nullptr;
+	for (auto& worker : workers) {
+		while (worker->deque.pop(task)) {
+			task->self.reset();
+		}
+	}
+	for (auto* queued : injection_queue) {
+		queued->self.reset();
+	}
+}
+
+auto ThreadPool::submit(Task task) -> TaskHandle
+{
+	auto state = std::make_shared<TaskState>(std::move(task), *this);
+	this->enqueue(state);
+	return TaskHandle(std::move(state));
+}
+
+void ThreadPool::enqueue(std::shared_ptr<TaskState> task)
+{
+	auto* raw = task.get();
+	raw->self = std::move(task);
+
+	if (current_pool == this) {
+		workers[current_worker]->deque.push(raw);
+	} else {
+		auto lock = std::lock_guard(injection_mutex);
+		injection_queue.push_back(raw);
+	}
+	wake_worker();
+}
+
+void ThreadPool::wake_worker()
+{
+	work_epoch.fetch_add(1);
+	if (sleeping_count.load() > 0) {
+		work_epoch.notify_one();
+	}
+}
+
+auto ThreadPool::take_task() -> TaskState*
+{
+	TaskState* task = nullptr;
+
+	if (current_pool == this && workers[current_worker]->deque.pop(task)) {
+		return task;
+	}
+	{
+		auto lock = std::lock_guard(injection_mutex);
+		if (!injection_queue.empty()) {
+			task = injection_queue.front();
+			injection_queue.pop_front();
+			return task;
+		}
+	}
+
+	const size_t kWorkerCount = workers.size();
+	auto first_victim = next_random() % kWorkerCount;
+	for (size_t offset = 0; offset < kWorkerCount; ++offset) {
+		auto victim = (first_victim + offset) % kWorkerCount;
+		if (current_pool == this && victim == current_worker) {
+			continue;
+		}
+		if (workers[victim]->deque.steal(task)) {
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+auto ThreadPool::try_run_one() -> bool
+{
+	auto* task = take_task();
+	if (task == nullptr) {
+		return false;
+	}
+	run(task);
+	return true;
+}
+
+void ThreadPool::run(TaskState* task)
+{
+	auto keep_alive = std::move(task->self);
+
+	try {
+		task->work();
+	} catch (...) {
+		task->error = std::current_exception();
+	}
+	// Releases whatever the task captured
+	task->work = nullptr;
+
+	std::vector<std::shared_ptr<TaskState>> continuations;
+	{
+		auto lock = std::lock_guard(task->continuation_mutex);
+		task->is_finished = true;
+		continuations.swap(task->continuations);
+	}
+	task->is_done.store(true, std::memory_order_release);
+
+	for (auto& continuation : continuations) {
+		this->enqueue(std::move(continuation));
+	}
+}
+
+void ThreadPool::wait_for(TaskState& task)
+{
+	this->helpUntil([&task]() {
+		return task.is_done.load(std::memory_order_acquire);
+	});
+}
+
+void ThreadPool::worker_loop(size_t worker_index)
+{
+	current_pool = this;
+	current_worker = worker_index;
+
+	while (!is_stopping.load(std::memory_order_acquire)) {
+		if (try_run_one()) {
+			continue;
+		}
+
+		// Re-check after reading the epoch: a task enqueued after this
+		// point bumps the epoch, so the wait below returns at once.
+		auto epoch = work_epoch.load();
+		if (try_run_one()) {
+			continue;
+		}
+		if (is_stopping.load(std::memory_order_acquire)) {
+			break;
+		}
+		sleeping_count.fetch_add(1);
+		work_epoch.wait(epoch);
+		sleeping_count.fetch_sub(1);
+	}
+
+	current_pool = nullptr;
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
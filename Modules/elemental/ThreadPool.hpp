@@ -0,0 +1,229 @@
+/* ThreadPool.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "INonCopyable.hpp"
+#include "WorkStealingDeque.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace elemental {
+
+class ThreadPool;
+
+namespace details {
+struct TaskState {
+	TaskState(std::function<void()> work, ThreadPool& pool)
+	    : work(std::move(work)), pool(pool)
+	{
+	}
+
+	std::function<void()> work;
+	ThreadPool& pool;
+	std::atomic<bool> is_done{ false };
+	std::exception_ptr error;
+
+	std::mutex continuation_mutex;
+	bool is_finished{ false };
+	std::vector<std::shared_ptr<TaskState>> continuations;
+
+	// Keeps a queued task alive; released when it runs
+	std::shared_ptr<TaskState> self;
+};
+} // namespace details
+
+/*! \brief Refers to a task submitted to a ThreadPool.
+ *
+ * Copies refer to the same task. A default-constructed handle refers to
+ * nothing and counts as done. */
+class TaskHandle
+{
+  public:
+	TaskHandle() = default;
+
+	auto isValid() const -> bool { return state != nullptr; }
+	auto isDone() const -> bool
+	{
+		return !state || state->is_done.load(std::memory_order_acquire);
+	}
+
+	/*! \brief Blocks until the task has run, running other tasks of the
+	 * pool in the meantime. Rethrows what the task threw. */
+	void wait() const;
+
+	/*! \brief Queues \c task to run once this task has finished, whether
+	 * or not it threw. */
+	auto then(std::function<void()> task) const -> TaskHandle;
+
+  protected:
+	friend class ThreadPool;
+	explicit TaskHandle(std::shared_ptr<details::TaskState> state)
+	    : state(std::move(state))
+	{
+	}
+
+	std::shared_ptr<details::TaskState> state;
+};
+
+/*! \brief Work-stealing pool of worker threads.
+ *
+ * Each worker owns a WorkStealingDeque: tasks it submits go to the bottom
+ * of its own deque, and it pops from there first. Tasks from other threads
+ * go to a shared injection queue. An idle worker takes from the injection
+ * queue, then steals from a random other worker, and parks once there is
+ * nothing left anywhere.
+ *
+ * Threads waiting on a TaskHandle run queued tasks instead of blocking,
+ * so tasks may wait on tasks they spawned (fork-join). Tasks still queued
+ * when the pool is destroyed are dropped. */
+class ThreadPool : private INonCopyable
+{
+  public:
+	using Task = std::function<void()>;
+
+	//! \param thread_count 0 picks one per hardware thread
+	explicit ThreadPool(unsigned thread_count = 0);
+	virtual ~ThreadPool();
+
+	auto submit(Task task) -> TaskHandle;
+
+	/*! \brief Calls \c function(chunk_begin, chunk_end) over [begin, end)
+	 * in chunks of \c grain indices, on the workers and the calling
+	 * thread, and returns once every chunk has run. Rethrows the first
+	 * exception thrown by \c function.
+	 * \param grain 0 picks about four chunks per thread */
+	template<typename TFunction>
+	void parallelFor(size_t begin, size_t end, TFunction&& function,
+	                 size_t grain = 0);
+
+	/*! \brief Runs queued tasks on the calling thread until \c is_done()
+	 * holds, like TaskHandle::wait(). Safe to call from a worker. */
+	template<typename TPredicate>
+	void helpUntil(TPredicate&& is_done)
+	{
+		while (!is_done()) {
+			if (!try_run_one()) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	auto getThreadCount() const -> unsigned
+	{
+		return static_cast<unsigned>(workers.size());
+	}
+
+  protected:
+	friend class TaskHandle;
+	using TaskState = details::TaskState;
+
+	void enqueue(std::shared_ptr<TaskState> task);
+	void wait_for(TaskState& task);
+	//! \brief Runs one queued task, if there is one.
+	auto try_run_one() -> bool;
+	void run(TaskState* task);
+	auto take_task() -> TaskState*;
+	void wake_worker();
+	void worker_loop(size_t worker_index);
+
+	struct Worker {
+		std::thread thread;
+		WorkStealingDeque<TaskState*> deque;
+	};
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::atomic<bool> is_stopping{ false };
+
+	std::mutex injection_mutex;
+	std::deque<TaskState*> injection_queue;
+
+	// Event count: bumped on every new task, waited on by idle workers
+	std::atomic<uint32_t> work_epoch{ 0 };
+	std::atomic<uint32_t> sleeping_count{ 0 };
+
+	// Which pool and deque the current thread works for, if any
+	static inline thread_local ThreadPool* current_pool = nullptr;
+	static inline thread_local size_t current_worker = 0;
+};
+
+template<typename TFunction>
+void ThreadPool::parallelFor(size_t begin, size_t end, TFunction&& function,
+                             size_t grain)
+{
+	if (begin >= end) {
+		return;
+	}
+	const size_t kCount = end - begin;
+	if (grain == 0) {
+		grain = std::max<size_t>(
+		    1, kCount / (std::max(1u, getThreadCount()) * 4)
+		);
+	}
+	const size_t kChunkCount = (kCount + grain - 1) / grain;
+
+	std::atomic<size_t> next_chunk{ 0 };
+	auto claim_chunks = [&]() {
+		try {
+			size_t chunk;
+			while ((chunk = next_chunk.fetch_add(
+			            1, std::memory_order_relaxed
+			        )) < kChunkCount) {
+				auto chunk_begin = begin + chunk * grain;
+				function(chunk_begin,
+				         std::min(chunk_begin + grain, end));
+			}
+		} catch (...) {
+			// Stop handing out chunks, then report
+			next_chunk.store(kChunkCount);
+			throw;
+		}
+	};
+
+	const size_t kHelperCount =
+	    std::min<size_t>(getThreadCount(), kChunkCount - 1);
+	std::vector<TaskHandle> helpers;
+	helpers.reserve(kHelperCount);
+	for (size_t index = 0; index < kHelperCount; ++index) {
+		helpers.push_back(this->submit(claim_chunks));
+	}
+
+	// Helpers reference this frame, so all of them must finish before
+	// any exception leaves it.
+	std::exception_ptr first_error;
+	try {
+		claim_chunks();
+	} catch (...) {
+		first_error = std::current_exception();
+	}
+	for (auto& helper : helpers) {
+		try {
+			helper.wait();
+		} catch (...) {
+			if (!first_error) {
+				first_error = std::current_exception();
+			}
+		}
+	}
+	if (first_error) {
+		std::rethrow_exception(first_error);
+	}
+}
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
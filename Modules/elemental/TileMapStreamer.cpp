@@ -0,0 +1,48 @@
+/* TileMapStreamer.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "TileMapStreamer.hpp"
+
+#include "TextureCache.hpp"
+
+#include <fmt/core.h>
+
+#include <filesystem>
+#include <string>
+
+using namespace elemental;
+
+TileMapStreamer::TileMapStreamer(AssetLoader& loader,
+                                 const std::filesystem::path& chunk_directory,
+                                 Area map_size,
+                                 const StreamingSettings& settings,
+                                 const std::string& file_pattern)
+    : ChunkStreamer(
+	  map_size, settings,
+	  [this, &loader](ChunkCoord coord, const Rectangle&) {
+		  return loader.loadTexture(getChunkPath(coord));
+	  },
+	  &TextureCache::estimateBytes
+      )
+    , chunk_directory(chunk_directory)
+    , file_pattern(file_pattern)
+{
+}
+
+TileMapStreamer::~TileMapStreamer() = default;
+
+auto TileMapStreamer::getChunkPath(ChunkCoord coord) const
+    -> std::filesystem::path
+{
+	return chunk_directory /
+	       fmt::format(fmt::runtime(file_pattern), coord.column, coord.row);
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
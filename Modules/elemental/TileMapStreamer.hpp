@@ -0,0 +1,50 @@
+/* TileMapStreamer.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "AssetLoader.hpp"
+#include "ChunkStreamer.hpp"
+#include "SDL_Memory.hpp"
+
+#include <SDL.h>
+
+#include <filesystem>
+#include <string>
+
+namespace elemental {
+
+/*! \brief Streams the texture chunks of a large tile map through an
+ * AssetLoader.
+ *
+ * Chunk images live in one directory and are named after their column and
+ * row with \c file_pattern, "{}_{}.png" by default: chunk (3, 1) loads
+ * "3_1.png". Decoding happens on the loader's workers; the textures only
+ * appear once AssetLoader::processUploads() has run, so call it every frame
+ * alongside update(). Resident memory is estimated like TextureCache does. */
+class TileMapStreamer : public ChunkStreamer<SdlPtr<SDL_Texture>>
+{
+  public:
+	TileMapStreamer(AssetLoader& loader,
+	                const std::filesystem::path& chunk_directory,
+	                Area map_size, const StreamingSettings& settings,
+	                const std::string& file_pattern = "{}_{}.png");
+	~TileMapStreamer() override;
+
+	auto getChunkPath(ChunkCoord coord) const -> std::filesystem::path;
+
+  protected:
+	std::filesystem::path chunk_directory;
+	std::string file_pattern;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
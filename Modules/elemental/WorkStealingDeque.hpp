@@ -0,0 +1,183 @@
+/* WorkStealingDeque.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "INonCopyable.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace elemental {
+
+/*! \brief Chase-Lev work-stealing deque.
+ *
+ * One owner thread pushes and pops at the bottom (LIFO, for locality);
+ * any number of other threads steal from the top (FIFO, taking the oldest
+ * and usually largest work). Neither side locks. The buffer grows as
+ * needed; outgrown buffers are kept until the deque is destroyed, since a
+ * thief may still be reading one.
+ *
+ * Follows Lê et al., "Correct and Efficient Work-Stealing for Weak Memory
+ * Models" (PPoPP 2013).
+ *
+ * \tparam T a trivially copyable item type, typically a pointer */
+template<typename T>
+class WorkStealingDeque : private INonCopyable
+{
+	static_assert(std::is_trivially_copyable_v<T>,
+	              "WorkStealingDeque items must be trivially copyable");
+
+  public:
+	explicit WorkStealingDeque(size_t initial_capacity = 256)
+	    : top(0), bottom(0), buffer(nullptr), buffers()
+	{
+		buffers.push_back(std::make_unique<Buffer>(
+		    std::bit_ceil(std::max<size_t>(initial_capacity, 2))
+		));
+		buffer.store(buffers.back().get(), std::memory_order_relaxed);
+	}
+
+	//! \brief Owner only: adds \c item at the bottom.
+	void push(T item)
+	{
+		auto bottom_index = bottom.load(std::memory_order_relaxed);
+		auto top_index = top.load(std::memory_order_acquire);
+		auto* current = buffer.load(std::memory_order_relaxed);
+
+		if (bottom_index - top_index >= current->capacity()) {
+			current = grow(current, top_index, bottom_index);
+		}
+		current->put(bottom_index, item);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(bottom_index + 1, std::memory_order_relaxed);
+	}
+
+	//! \brief Owner only: takes the newest item.
+	auto pop(T& item) -> bool
+	{
+		auto bottom_index = bottom.load(std::memory_order_relaxed) - 1;
+		auto* current = buffer.load(std::memory_order_relaxed);
+		bottom.store(bottom_index, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto top_index = top.load(std::memory_order_relaxed);
+
+		if (top_index > bottom_index) {
+			// Empty
+			bottom.store(bottom_index + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		item = current->get(bottom_index);
+		if (top_index == bottom_index) {
+			// Last item: race the thieves for it
+			bool won = top.compare_exchange_strong(
+			    top_index,
+			    top_index + 1,
+			    std::memory_order_seq_cst,
+			    std::memory_order_relaxed
+			);
+			bottom.store(bottom_index + 1, std::memory_order_relaxed);
+			return won;
+		}
+		return true;
+	}
+
+	//! \brief Any thread: takes the oldest item.
+	auto steal(T& item) -> bool
+	{
+		auto top_index = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto bottom_index = bottom.load(std::memory_order_acquire);
+
+		if (top_index >= bottom_index) {
+			return false;
+		}
+
+		auto* current = buffer.load(std::memory_order_acquire);
+		auto stolen = current->get(top_index);
+		if (!top.compare_exchange_strong(top_index,
+		                                 top_index + 1,
+		                                 std::memory_order_seq_cst,
+		                                 std::memory_order_relaxed)) {
+			return false;
+		}
+		item = stolen;
+		return true;
+	}
+
+	//! \brief Approximate unless called by the owner while no one steals
+	auto size() const -> size_t
+	{
+		auto bottom_index = bottom.load(std::memory_order_relaxed);
+		auto top_index = top.load(std::memory_order_relaxed);
+		return (bottom_index > top_index)
+		           ? static_cast<size_t>(bottom_index - top_index)
+		           : 0;
+	}
+	auto empty() const -> bool { return size() == 0; }
+
+  protected:
+	class Buffer
+	{
+	  public:
+		explicit Buffer(size_t capacity)
+		    : mask(static_cast<int64_t>(capacity) - 1)
+		    , items(std::make_unique<std::atomic<T>[]>(capacity))
+		{
+		}
+
+		auto capacity() const -> int64_t { return mask + 1; }
+		auto get(int64_t index) const -> T
+		{
+			return items[index & mask].load(std::memory_order_relaxed);
+		}
+		void put(int64_t index, T item)
+		{
+			items[index & mask].store(item, std::memory_order_relaxed);
+		}
+
+	  protected:
+		int64_t mask;
+		std::unique_ptr<std::atomic<T>[]> items;
+	};
+
+	auto grow(Buffer* current, int64_t top_index, int64_t bottom_index)
+	    -> Buffer*
+	{
+		auto next = std::make_unique<Buffer>(
+		    static_cast<size_t>(current->capacity()) * 2
+		);
+		for (auto index = top_index; index < bottom_index; ++index) {
+			next->put(index, current->get(index));
+		}
+
+		auto* raw = next.get();
+		buffers.push_back(std::move(next));
+		buffer.store(raw, std::memory_order_release);
+		return raw;
+	}
+
+	// Indices only grow; they are masked on access
+	alignas(64) std::atomic<int64_t> top;
+	alignas(64) std::atomic<int64_t> bottom;
+	std::atomic<Buffer*> buffer;
+
+	// Owner-only: every buffer ever used, newest last
+	std::vector<std::unique_ptr<Buffer>> buffers;
+};
+
+} // namespace elemental
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
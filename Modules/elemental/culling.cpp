@@ -0,0 +1,384 @@
+/* culling.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "util/culling.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <cstdint>
+#include <span>
+
+#if defined(__x86_64__) || defined(_M_X64) ||                                  \
+    (defined(__i386__) && defined(__SSE2__))
+#define ELEMENTAL_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/* The AVX2 kernel is compiled with a function-level target attribute and
+ * picked at runtime, so the rest of the engine keeps the baseline ISA. */
+#if defined(ELEMENTAL_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define ELEMENTAL_HAS_AVX2 1
+#include <immintrin.h>
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace elemental::culling {
+
+namespace {
+
+/* Emits one rectangle. The output slot is written unconditionally and only
+ * kept when the rectangle is visible, which keeps the loops branch-free. */
+inline void emit(
+    size_t& count, uint32_t index, bool is_visible, const Rectangle& rect,
+    std::span<uint32_t> visible_indices, std::span<Rectangle> clipped
+)
+{
+	visible_indices[count] = index;
+	clipped[count] = rect;
+	count += is_visible ? 1 : 0;
+}
+
+auto cull_range_scalar(
+    std::span<const Rectangle> rectangles, size_t begin,
+    const Rectangle& viewport, size_t count,
+    std::span<uint32_t> visible_indices, std::span<Rectangle> clipped
+) -> size_t
+{
+	for (size_t index = begin; index < rectangles.size(); ++index) {
+		const auto& rect = rectangles[index];
+		emit(count,
+		     static_cast<uint32_t>(index),
+		     viewport.intersects(rect),
+		     rect.intersection(viewport),
+		     visible_indices,
+		     clipped);
+	}
+	return count;
+}
+
+#ifdef ELEMENTAL_HAS_SSE2
+/* SSE2 has no unsigned 32-bit compares or min/max: flipping the sign bit
+ * maps unsigned order onto signed order. */
+inline auto sse2_less_u32(__m128i lhs, __m128i rhs) -> __m128i
+{
+	const __m128i kSignBit = _mm_set1_epi32(INT32_MIN);
+	return _mm_cmplt_epi32(
+	    _mm_xor_si128(lhs, kSignBit), _mm_xor_si128(rhs, kSignBit)
+	);
+}
+inline auto sse2_select(__m128i mask, __m128i if_set, __m128i if_clear)
+    -> __m128i
+{
+	return _mm_or_si128(
+	    _mm_and_si128(mask, if_set), _mm_andnot_si128(mask, if_clear)
+	);
+}
+inline auto sse2_min_u32(__m128i lhs, __m128i rhs) -> __m128i
+{
+	return sse2_select(sse2_less_u32(lhs, rhs), lhs, rhs);
+}
+inline auto sse2_max_u32(__m128i lhs, __m128i rhs) -> __m128i
+{
+	return sse2_select(sse2_less_u32(lhs, rhs), rhs, lhs);
+}
+
+/* One Rectangle is exactly one 128-bit register (x, y, w, h). Four of them
+ * are transposed into x/y/w/h vectors, tested and clipped four at a time,
+ * then transposed back. */
+auto cull_sse2(
+    std::span<const Rectangle> rectangles, const Rectangle& viewport,
+    std::span<uint32_t> visible_indices, std::span<Rectangle> clipped
+) -> size_t
+{
+	const __m128i kViewLeft = _mm_set1_epi32(viewport.x());
+	const __m128i kViewTop = _mm_set1_epi32(viewport.y());
+	const __m128i kViewRight = _mm_set1_epi32(viewport.right());
+	const __m128i kViewBottom = _mm_set1_epi32(viewport.bottom());
+	const __m128i kZero = _mm_setzero_si128();
+
+	const auto* source =
+	    reinterpret_cast<const __m128i*>(rectangles.data());
+	size_t count = 0;
+	size_t index = 0;
+
+	for (; index + 4 <= rectangles.size(); index += 4) {
+		__m128i rect0 = _mm_loadu_si128(source + index);
+		__m128i rect1 = _mm_loadu_si128(source + index + 1);
+		__m128i rect2 = _mm_loadu_si128(source + index + 2);
+		__m128i rect3 = _mm_loadu_si128(source + index + 3);
+
+		__m128i xy01 = _mm_unpacklo_epi32(rect0, rect1);
+		__m128i xy23 = _mm_unpacklo_epi32(rect2, rect3);
+		__m128i wh01 = _mm_unpackhi_epi32(rect0, rect1);
+		__m128i wh23 = _mm_unpackhi_epi32(rect2, rect3);
+
+		__m128i left = _mm_unpacklo_epi64(xy01, xy23);
+		__m128i top = _mm_unpackhi_epi64(xy01, xy23);
+		__m128i width = _mm_unpacklo_epi64(wh01, wh23);
+		__m128i height = _mm_unpackhi_epi64(wh01, wh23);
+		__m128i right = _mm_add_epi32(left, width);
+		__m128i bottom = _mm_add_epi32(top, height);
+
+		__m128i is_empty = _mm_or_si128(
+		    _mm_cmpeq_epi32(width, kZero), _mm_cmpeq_epi32(height, kZero)
+		);
+		__m128i overlaps = _mm_and_si128(
+		    _mm_and_si128(
+			sse2_less_u32(left, kViewRight),
+			sse2_less_u32(kViewLeft, right)
+		    ),
+		    _mm_and_si128(
+			sse2_less_u32(top, kViewBottom),
+			sse2_less_u32(kViewTop, bottom)
+		    )
+		);
+		int visible_mask = _mm_movemask_ps(
+		    _mm_castsi128_ps(_mm_andnot_si128(is_empty, overlaps))
+		);
+
+		__m128i clip_left = sse2_max_u32(left, kViewLeft);
+		__m128i clip_top = sse2_max_u32(top, kViewTop);
+		__m128i clip_width = _mm_sub_epi32(
+		    sse2_min_u32(right, kViewRight), clip_left
+		);
+		__m128i clip_height = _mm_sub_epi32(
+		    sse2_min_u32(bottom, kViewBottom), clip_top
+		);
+
+		__m128i lt01 = _mm_unpacklo_epi32(clip_left, clip_top);
+		__m128i wh01_out = _mm_unpacklo_epi32(clip_width, clip_height);
+		__m128i lt23 = _mm_unpackhi_epi32(clip_left, clip_top);
+		__m128i wh23_out = _mm_unpackhi_epi32(clip_width, clip_height);
+
+		__m128i results[4] = { _mm_unpacklo_epi64(lt01, wh01_out),
+			               _mm_unpackhi_epi64(lt01, wh01_out),
+			               _mm_unpacklo_epi64(lt23, wh23_out),
+			               _mm_unpackhi_epi64(lt23, wh23_out) };
+
+		auto* destination = reinterpret_cast<__m128i*>(clipped.data());
+		for (int lane = 0; lane < 4; ++lane) {
+			_mm_storeu_si128(destination + count, results[lane]);
+			visible_indices[count] =
+			    static_cast<uint32_t>(index + lane);
+			count += (visible_mask >> lane) & 1;
+		}
+	}
+
+	return cull_range_scalar(
+	    rectangles, index, viewport, count, visible_indices, clipped
+	);
+}
+#endif
+
+#ifdef ELEMENTAL_HAS_AVX2
+TARGET_AVX2 inline auto avx2_less_u32(__m256i lhs, __m256i rhs) -> __m256i
+{
+	const __m256i kSignBit = _mm256_set1_epi32(INT32_MIN);
+	return _mm256_cmpgt_epi32(
+	    _mm256_xor_si256(rhs, kSignBit), _mm256_xor_si256(lhs, kSignBit)
+	);
+}
+
+/* Same scheme as cull_sse2(), eight rectangles at a time. Each 256-bit load
+ * holds two rectangles, and the in-lane transpose leaves the vector lanes in
+ * the order 0 2 4 6 | 1 3 5 7, which kLaneOfRect undoes. */
+TARGET_AVX2 auto cull_avx2(
+    std::span<const Rectangle> rectangles, const Rectangle& viewport,
+    std::span<uint32_t> visible_indices, std::span<Rectangle> clipped
+) -> size_t
+{
+	static constexpr int kLaneOfRect[8] = { 0, 4, 1, 5, 2, 6, 3, 7 };
+
+	const __m256i kViewLeft = _mm256_set1_epi32(viewport.x());
+	const __m256i kViewTop = _mm256_set1_epi32(viewport.y());
+	const __m256i kViewRight = _mm256_set1_epi32(viewport.right());
+	const __m256i kViewBottom = _mm256_set1_epi32(viewport.bottom());
+	const __m256i kZero = _mm256_setzero_si256();
+
+	// Each __m256i spans two rectangles
+	const auto* source =
+	    reinterpret_cast<const __m256i*>(rectangles.data());
+	size_t count = 0;
+	size_t index = 0;
+
+	for (; index + 8 <= rectangles.size(); index += 8) {
+		__m256i rect01 = _mm256_loadu_si256(source + index / 2);
+		__m256i rect23 = _mm256_loadu_si256(source + index / 2 + 1);
+		__m256i rect45 = _mm256_loadu_si256(source + index / 2 + 2);
+		__m256i rect67 = _mm256_loadu_si256(source + index / 2 + 3);
+
+		__m256i xy_a = _mm256_unpacklo_epi32(rect01, rect23);
+		__m256i xy_b = _mm256_unpacklo_epi32(rect45, rect67);
+		__m256i wh_a = _mm256_unpackhi_epi32(rect01, rect23);
+		__m256i wh_b = _mm256_unpackhi_epi32(rect45, rect67);
+
+		__m256i left = _mm256_unpacklo_epi64(xy_a, xy_b);
+		__m256i top = _mm256_unpackhi_epi64(xy_a, xy_b);
+		__m256i width = _mm256_unpacklo_epi64(wh_a, wh_b);
+		__m256i height = _mm256_unpackhi_epi64(wh_a, wh_b);
+		__m256i right = _mm256_add_epi32(left, width);
+		__m256i bottom = _mm256_add_epi32(top, height);
+
+		__m256i is_empty = _mm256_or_si256(
+		    _mm256_cmpeq_epi32(width, kZero),
+		    _mm256_cmpeq_epi32(height, kZero)
+		);
+		__m256i overlaps = _mm256_and_si256(
+		    _mm256_and_si256(
+			avx2_less_u32(left, kViewRight),
+			avx2_less_u32(kViewLeft, right)
+		    ),
+		    _mm256_and_si256(
+			avx2_less_u32(top, kViewBottom),
+			avx2_less_u32(kViewTop, bottom)
+		    )
+		);
+		int visible_mask = _mm256_movemask_ps(
+		    _mm256_castsi256_ps(_mm256_andnot_si256(is_empty, overlaps))
+		);
+
+		__m256i clip_left = _mm256_max_epu32(left, kViewLeft);
+		__m256i clip_top = _mm256_max_epu32(top, kViewTop);
+		__m256i clip_width = _mm256_sub_epi32(
+		    _mm256_min_epu32(right, kViewRight), clip_left
+		);
+		__m256i clip_height = _mm256_sub_epi32(
+		    _mm256_min_epu32(bottom, kViewBottom), clip_top
+		);
+
+		__m256i lt_a = _mm256_unpacklo_epi32(clip_left, clip_top);
+		__m256i wh_a_out = _mm256_unpacklo_epi32(clip_width, clip_height);
+		__m256i lt_b = _mm256_unpackhi_epi32(clip_left, clip_top);
+		__m256i wh_b_out = _mm256_unpackhi_epi32(clip_width, clip_height);
+
+		__m256i pairs[4] = { _mm256_unpacklo_epi64(lt_a, wh_a_out),
+			             _mm256_unpackhi_epi64(lt_a, wh_a_out),
+			             _mm256_unpacklo_epi64(lt_b, wh_b_out),
+			             _mm256_unpackhi_epi64(lt_b, wh_b_out) };
+
+		auto* destination = reinterpret_cast<__m128i*>(clipped.data());
+		for (int rect = 0; rect < 8; ++rect) {
+			const auto& pair = pairs[rect / 2];
+			__m128i result = (rect % 2 == 0)
+			                     ? _mm256_castsi256_si128(pair)
+			                     : _mm256_extracti128_si256(pair, 1);
+
+			_mm_storeu_si128(destination + count, result);
+			visible_indices[count] =
+			    static_cast<uint32_t>(index + rect);
+			count += (visible_mask >> kLaneOfRect[rect]) & 1;
+		}
+	}
+
+	return cull_range_scalar(
+	    rectangles, index, viewport, count, visible_indices, clipped
+	);
+}
+#endif
+
+auto detect_kernel() -> Kernel
+{
+#if defined(ELEMENTAL_HAS_AVX2)
+	if (__builtin_cpu_supports("avx2")) {
+		return Kernel::AVX2;
+	}
+#endif
+#if defined(ELEMENTAL_HAS_SSE2)
+	return Kernel::SSE2;
+#else
+	return Kernel::Scalar;
+#endif
+}
+} // namespace
+
+auto active_kernel() -> Kernel
+{
+	static const Kernel kDetected = detect_kernel();
+	return kDetected;
+}
+
+auto cull_rectangles_scalar(
+    std::span<const Rectangle> rectangles, const Rectangle& viewport,
+    std::span<uint32_t> visible_indices, std::span<Rectangle> clipped
+) -> size_t
+{
+	ASSERT(visible_indices.size() >= rectangles.size());
+	ASSERT(clipped.size() >= rectangles.size());
+
+	return cull_range_scalar(
+	    rectangles, 0, viewport, 0, visible_indices, clipped
+	);
+}
+
+auto is_supported(Kernel kernel) -> bool
+{
+	switch (kernel) {
+#ifdef ELEMENTAL_HAS_AVX2
+		case Kernel::AVX2:
+			return __builtin_cpu_supports("avx2");
+#endif
+#ifdef ELEMENTAL_HAS_SSE2
+		case Kernel::SSE2:
+			return true;
+#endif
+		case Kernel::Scalar:
+			return true;
+		default:
+			return false;
+	}
+}
+
+auto cull_rectangles(
+    std::span<const Rectangle> rectangles, const Rectangle& viewport,
+    std::span<uint32_t> visible_indices, std::span<Rectangle> clipped
+) -> size_t
+{
+	return cull_rectangles_with(
+	    active_kernel(), rectangles, viewport, visible_indices, clipped
+	);
+}
+
+auto cull_rectangles_with(
+    Kernel kernel, std::span<const Rectangle> rectangles,
+    const Rectangle& viewport, std::span<uint32_t> visible_indices,
+    std::span<Rectangle> clipped
+) -> size_t
+{
+	ASSERT(is_supported(kernel));
+	ASSERT(visible_indices.size() >= rectangles.size());
+	ASSERT(clipped.size() >= rectangles.size());
+
+	if (viewport.isEmpty()) {
+		return 0;
+	}
+
+	switch (kernel) {
+#ifdef ELEMENTAL_HAS_AVX2
+		case Kernel::AVX2:
+			return cull_avx2(
+			    rectangles, viewport, visible_indices, clipped
+			);
+#endif
+#ifdef ELEMENTAL_HAS_SSE2
+		case Kernel::SSE2:
+			return cull_sse2(
+			    rectangles, viewport, visible_indices, clipped
+			);
+#endif
+		default:
+			return cull_range_scalar(
+			    rectangles, 0, viewport, 0, visible_indices, clipped
+			);
+	}
+}
+
+} // namespace elemental::culling
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -10,49 +10,100 @@
 #pragma once
 
 #include "Component.hpp"
-#include "Exception.hpp"
+#include "ComponentPool.hpp"
+#include "ComponentView.hpp"
 
 #ifndef COMP_FACTORY_DECL
 #include "ComponentFactory.hpp"
 #endif
 
-#include <unordered_map>
+#include <memory>
 #include <vector>
 
 namespace elemental {
 
-using ComponentVector = ComponentFactory::ComponentVector;
+template<typename TComponent>
+auto ComponentFactory::type_slot() -> size_t
+{
+	// Assigned once per type, on first use, for the whole program
+	static const size_t kSlot =
+	    next_type_slot.fetch_add(1, std::memory_order_relaxed);
+	return kSlot;
+}
 
 template<typename TComponent, typename... TArgs>
-std::shared_ptr<TComponent>
-ComponentFactory::createComponent(const Component::InstanceID& id,
-                                  TArgs&&... args)
+auto ComponentFactory::createComponent(InstanceID id, TArgs&&... args)
+    -> TComponent&
 {
+	return this->getPool<TComponent>().emplace(
+	    id, std::forward<TArgs>(args)...
+	);
+}
 
-	auto new_object =
-	    std::make_shared<TComponent>(std::forward<TArgs>(args)...);
+template<typename TComponent>
+auto ComponentFactory::getComponent(InstanceID id) -> TComponent*
+{
+	auto slot = type_slot<TComponent>();
+	if (slot >= pools.size() || !pools[slot]) {
+		return nullptr;
+	}
+	return static_cast<ComponentPool<TComponent>&>(*pools[slot]).get(id);
+}
 
-	auto component_type = std::type_index(typeid(TComponent));
-	auto& component_vector = component_pool[component_type];
+template<typename TComponent>
+auto ComponentFactory::hasComponent(InstanceID id) const -> bool
+{
+	auto* pool = this->findPool<TComponent>();
+	return pool != nullptr && pool->has(id);
+}
 
-	component_vector.push_back(new_object);
+template<typename TComponent>
+auto ComponentFactory::removeComponent(InstanceID id) -> bool
+{
+	auto slot = type_slot<TComponent>();
+	if (slot >= pools.size() || !pools[slot]) {
+		return false;
+	}
+	return pools[slot]->remove(id);
+}
 
-	return new_object;
+inline void ComponentFactory::removeAll(InstanceID id)
+{
+	for (auto& pool : pools) {
+		if (pool) {
+			pool->remove(id);
+		}
+	}
 }
 
 template<typename TComponent>
-std::shared_ptr<TComponent>
-ComponentFactory::getComponent(const Component::InstanceID& id)
+auto ComponentFactory::getPool() -> ComponentPool<TComponent>&
 {
-	return nullptr;
+	auto slot = type_slot<TComponent>();
+	if (slot >= pools.size()) {
+		pools.resize(slot + 1);
+	}
+	if (!pools[slot]) {
+		pools[slot] =
+		    std::make_unique<ComponentPool<TComponent>>(resource);
+	}
+	return static_cast<ComponentPool<TComponent>&>(*pools[slot]);
 }
 
-ComponentVector&
-ComponentFactory::getComponentVector(const TypeInfo& type)
+template<typename... TComponents>
+auto ComponentFactory::view() -> ComponentView<TComponents...>
 {
-	auto& pool = this->component_pool;
+	return ComponentView<TComponents...>(this->getPool<TComponents>()...);
+}
 
-	return pool.at(type);
+template<typename TComponent>
+auto ComponentFactory::findPool() const -> const ComponentPool<TComponent>*
+{
+	auto slot = type_slot<TComponent>();
+	if (slot >= pools.size() || !pools[slot]) {
+		return nullptr;
+	}
+	return static_cast<const ComponentPool<TComponent>*>(pools[slot].get());
 }
 
 } // namespace elemental
@@ -13,6 +13,7 @@
 
 #include <cstdint>
 #include <string>
+#include <type_traits>
 
 namespace elemental {
 
@@ -28,17 +29,121 @@ struct Area {
 };
 using Resolution = Area;
 
+/*! \brief An axis-aligned rectangle: four packed uint32_t, 16 bytes.
+ *
+ * Trivially copyable, so arrays of rectangles can be memcpy'd, stored
+ * contiguously and loaded straight into SIMD registers. Right and bottom
+ * edges are exclusive. */
 struct Rectangle {
 	Point position;
 	Area size;
 
-	uint32_t& x = position.x;
-	uint32_t& y = position.y;
-
-	uint32_t& width = size.width;
-	uint32_t& height = size.height;
+	/*! \name Accessors \{ */
+	constexpr auto x() const -> uint32_t { return position.x; }
+	constexpr auto y() const -> uint32_t { return position.y; }
+	constexpr auto width() const -> uint32_t { return size.width; }
+	constexpr auto height() const -> uint32_t { return size.height; }
+	constexpr auto right() const -> uint32_t { return x() + width(); }
+	constexpr auto bottom() const -> uint32_t { return y() + height(); }
+	/*! \} */
+
+	constexpr auto isEmpty() const -> bool
+	{
+		return width() == 0 || height() == 0;
+	}
+
+	constexpr auto contains(const Point& point) const -> bool
+	{
+		return point.x >= x() && point.x < right() && point.y >= y() &&
+		       point.y < bottom();
+	}
+	constexpr auto contains(const Rectangle& other) const -> bool
+	{
+		return other.x() >= x() && other.right() <= right() &&
+		       other.y() >= y() && other.bottom() <= bottom();
+	}
+	constexpr auto intersects(const Rectangle& other) const -> bool
+	{
+		return !isEmpty() && !other.isEmpty() && x() < other.right() &&
+		       other.x() < right() && y() < other.bottom() &&
+		       other.y() < bottom();
+	}
+
+	//! \brief The overlapping area, or an all-zero rectangle if none.
+	constexpr auto intersection(const Rectangle& other) const -> Rectangle
+	{
+		if (!intersects(other)) {
+			return {};
+		}
+		return from_edges(
+		    max_of(x(), other.x()),
+		    max_of(y(), other.y()),
+		    min_of(right(), other.right()),
+		    min_of(bottom(), other.bottom())
+		);
+	}
+
+	//! \brief The smallest rectangle containing both rectangles.
+	constexpr auto unite(const Rectangle& other) const -> Rectangle
+	{
+		if (isEmpty()) {
+			return other;
+		}
+		if (other.isEmpty()) {
+			return *this;
+		}
+		return from_edges(
+		    min_of(x(), other.x()),
+		    min_of(y(), other.y()),
+		    max_of(right(), other.right()),
+		    max_of(bottom(), other.bottom())
+		);
+	}
+
+	/*! \brief The part of this rectangle inside \c bounds. Unlike
+	 * intersection(), a rectangle outside the bounds keeps a position
+	 * clamped to them, with zero size. */
+	constexpr auto clip(const Rectangle& bounds) const -> Rectangle
+	{
+		auto left = min_of(max_of(x(), bounds.x()), bounds.right());
+		auto top = min_of(max_of(y(), bounds.y()), bounds.bottom());
+		auto clipped_right = max_of(min_of(right(), bounds.right()), left);
+		auto clipped_bottom = max_of(min_of(bottom(), bounds.bottom()), top);
+
+		return from_edges(left, top, clipped_right, clipped_bottom);
+	}
 
 	TOML_CLASS(Rectangle, position, size);
+
+  private:
+	static constexpr auto from_edges(
+	    uint32_t left, uint32_t top, uint32_t right, uint32_t bottom
+	) -> Rectangle
+	{
+		return { { left, top }, { right - left, bottom - top } };
+	}
+	static constexpr auto min_of(uint32_t lhs, uint32_t rhs) -> uint32_t
+	{
+		return (lhs < rhs) ? lhs : rhs;
+	}
+	static constexpr auto max_of(uint32_t lhs, uint32_t rhs) -> uint32_t
+	{
+		return (lhs > rhs) ? lhs : rhs;
+	}
+};
+static_assert(sizeof(Rectangle) == 4 * sizeof(uint32_t));
+static_assert(std::is_trivially_copyable_v<Rectangle>);
+static_assert(std::is_standard_layout_v<Rectangle>);
+
+/*! \brief One textured quad, as submitted to IRenderer::submitBatch().
+ *
+ * \c texture is a non-owning native handle (an SDL_Texture* for the
+ * SdlRenderer); the caller keeps it alive until the batch is submitted.
+ * A \c source with zero width or height selects the whole texture. */
+struct SpriteInstance {
+	void* texture;
+	Rectangle source;
+	Rectangle placement;
 };
 
 enum class WindowMode {
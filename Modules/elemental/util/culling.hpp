@@ -0,0 +1,60 @@
+/* culling.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "types/rendering.hpp"
+
+#include <cstdint>
+#include <span>
+
+namespace elemental::culling {
+
+enum class Kernel { Scalar, SSE2, AVX2 };
+
+/*! \brief Finds the rectangles that overlap \c viewport and clips them to it.
+ *
+ * For every visible rectangle, in input order, its index is written to
+ * \c visible_indices and its clipped rectangle to \c clipped. Both output
+ * spans must hold at least \c rectangles.size() elements. Empty rectangles
+ * are never visible.
+ *
+ * Uses the fastest kernel the CPU supports (see active_kernel()).
+ * Rectangles must not extend past UINT32_MAX on either axis.
+ *
+ * \returns the number of visible rectangles */
+auto cull_rectangles(
+    std::span<const Rectangle> rectangles, const Rectangle& viewport,
+    std::span<uint32_t> visible_indices, std::span<Rectangle> clipped
+) -> size_t;
+
+//! \brief Portable reference implementation of cull_rectangles()
+auto cull_rectangles_scalar(
+    std::span<const Rectangle> rectangles, const Rectangle& viewport,
+    std::span<uint32_t> visible_indices, std::span<Rectangle> clipped
+) -> size_t;
+
+//! \brief The kernel cull_rectangles() dispatches to on this machine
+auto active_kernel() -> Kernel;
+
+//! \brief Whether this build and CPU can run \c kernel
+auto is_supported(Kernel kernel) -> bool;
+
+/*! \brief cull_rectangles() on a fixed kernel, for tests and benchmarks.
+ * \c kernel must be supported (see is_supported()). */
+auto cull_rectangles_with(
+    Kernel kernel, std::span<const Rectangle> rectangles,
+    const Rectangle& viewport, std::span<uint32_t> visible_indices,
+    std::span<Rectangle> clipped
+) -> size_t;
+
+} // namespace elemental::culling
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,187 @@
+/* AsyncFileWriter.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "AsyncFileWriter.hpp"
+#include "AtomicFile.hpp"
+
+#include "test-utils/common.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+BEGIN_TEST_SUITE("elemental::AsyncFileWriter")
+{
+	using namespace elemental;
+	using namespace std::chrono;
+	namespace fs = std::filesystem;
+
+	auto read_file(const fs::path& file_path) -> std::string
+	{
+		std::ifstream file(file_path, std::ios::binary);
+		std::stringstream contents;
+		contents << file.rdbuf();
+		return contents.str();
+	}
+
+	struct TestFixture {
+		TestFixture()
+		    : directory(fs::temp_directory_path() /
+		                "elemental-file-writer-test")
+		{
+			fs::remove_all(directory);
+			fs::create_directories(directory);
+		}
+		~TestFixture() { fs::remove_all(directory); }
+
+		auto count_files() const -> size_t
+		{
+			return static_cast<size_t>(std::distance(
+			    fs::directory_iterator(directory),
+			    fs::directory_iterator()
+			));
+		}
+
+		fs::path directory;
+	};
+
+	FIXTURE_TEST("elemental::write_file_atomically - replaces the target")
+	{
+		auto target = directory / "settings.json";
+		write_file_atomically(target, "first");
+		write_file_atomically(target, "second, and longer");
+
+		CHECK(read_file(target) == "second, and longer");
+		// No temporary files are left behind
+		CHECK(count_files() == 1);
+	}
+
+	FIXTURE_TEST("elemental::write_file_atomically - failures leave the "
+	             "target untouched")
+	{
+		auto target = directory / "settings.json";
+		write_file_atomically(target, "original");
+
+		// Renaming a file over a directory fails after the data is
+		// written; the temporary must be cleaned up.
+		fs::create_directories(directory / "blocked");
+		CHECK_THROWS_AS(
+		    write_file_atomically(directory / "blocked", "replacement"),
+		    IOCore::Exception
+		);
+		CHECK_THROWS_AS(write_file_atomically(
+				    directory / "missing" / "file.txt", "text"
+				),
+		                IOCore::Exception);
+
+		CHECK(read_file(target) == "original");
+		CHECK(count_files() == 2);
+	}
+
+	FIXTURE_TEST("elemental::AsyncFileWriter - flush waits for the write")
+	{
+		AsyncFileWriter writer;
+		auto target = directory / "stats.txt";
+
+		writer.submit(target, "frame stats");
+		writer.flush();
+
+		CHECK(read_file(target) == "frame stats");
+		CHECK(writer.getWriteCount() == 1);
+	}
+
+	FIXTURE_TEST("elemental::AsyncFileWriter - repeated saves coalesce")
+	{
+		const int kSubmitCount = 200;
+		AsyncFileWriter writer;
+		auto target = directory / "autosave.json";
+
+		for (int i = 0; i < kSubmitCount; ++i) {
+			writer.submit(target, "save " + std::to_string(i));
+		}
+		writer.submit(directory / "other.json", "other");
+		writer.flush();
+
+		CHECK(read_file(target) ==
+		      "save " + std::to_string(kSubmitCount - 1));
+		CHECK(read_file(directory / "other.json") == "other");
+		CHECK(writer.getWriteCount() < kSubmitCount);
+		CHECK(count_files() == 2);
+	}
+
+	FIXTURE_TEST("elemental::AsyncFileWriter - flush reports errors once")
+	{
+		AsyncFileWriter writer;
+		writer.submit(directory / "missing" / "file.txt", "text");
+		writer.submit(directory / "fine.txt", "text");
+
+		CHECK_THROWS_AS(writer.flush(), IOCore::Exception);
+		CHECK_NOTHROW(writer.flush());
+		CHECK(read_file(directory / "fine.txt") == "text");
+	}
+
+	FIXTURE_TEST("elemental::AsyncFileWriter - destruction finishes pending "
+	             "writes")
+	{
+		auto target = directory / "late.txt";
+		{
+			AsyncFileWriter writer;
+			writer.submit(target, "written on exit");
+		}
+		CHECK(read_file(target) == "written on exit");
+	}
+
+	BENCHMARK_TEST("elemental::AsyncFileWriter - caller-side save cost")
+	{
+		const int kSaveCount = 50;
+		fs::path directory =
+		    fs::temp_directory_path() / "elemental-file-writer-bench";
+		fs::create_directories(directory);
+		std::string contents(64 * 1024, 'x');
+
+		auto time_us = [](auto save) {
+			auto start = steady_clock::now();
+			save();
+			return duration<double, std::micro>(
+			           steady_clock::now() - start
+			)
+			    .count();
+		};
+
+		auto sync_us = time_us([&]() {
+			for (int i = 0; i < kSaveCount; ++i) {
+				write_file_atomically(directory / "sync.json",
+				                      contents);
+			}
+		});
+
+		AsyncFileWriter writer;
+		auto async_us = time_us([&]() {
+			for (int i = 0; i < kSaveCount; ++i) {
+				writer.submit(directory / "async.json", contents);
+			}
+		});
+		writer.flush();
+
+		std::cout << "64 KiB save, per call: atomic " << sync_us / kSaveCount
+			  << " us, async submit " << async_us / kSaveCount
+			  << " us (" << writer.getWriteCount() << " of "
+			  << kSaveCount << " saves written)" << std::endl;
+		CHECK(async_us < sync_us);
+		fs::remove_all(directory);
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,133 @@
+/* BlockPool.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "BlockPool.hpp"
+#include "ComponentPool.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+#include <set>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::BlockPool")
+{
+	using namespace elemental;
+
+	//! Counts what reaches the upstream resource
+	class CountingResource : public std::pmr::memory_resource
+	{
+	  public:
+		size_t allocations = 0;
+		size_t deallocations = 0;
+
+	  protected:
+		auto do_allocate(size_t bytes, size_t alignment)
+		    -> void* override
+		{
+			++allocations;
+			return std::pmr::new_delete_resource()->allocate(
+			    bytes, alignment
+			);
+		}
+		void do_deallocate(void* memory, size_t bytes,
+		                   size_t alignment) override
+		{
+			++deallocations;
+			std::pmr::new_delete_resource()->deallocate(
+			    memory, bytes, alignment
+			);
+		}
+		auto do_is_equal(const std::pmr::memory_resource& other)
+		    const noexcept -> bool override
+		{
+			return this == &other;
+		}
+	};
+
+	TEST("elemental::BlockPool - recycles freed blocks")
+	{
+		CountingResource upstream;
+		BlockPool pool(24, 8, &upstream);
+
+		auto* first = pool.allocate(24);
+		pool.deallocate(first, 24);
+		auto* second = pool.allocate(16);
+
+		CHECK(first == second);
+		CHECK(pool.getLiveCount() == 1);
+		CHECK(upstream.allocations == 1);
+		pool.deallocate(second, 16);
+	}
+
+	TEST("elemental::BlockPool - adds chunks only when exhausted")
+	{
+		CountingResource upstream;
+		{
+			BlockPool pool(32, 4, &upstream);
+			std::set<void*> blocks;
+			for (int i = 0; i < 9; ++i) {
+				blocks.insert(pool.allocate(32));
+			}
+			CHECK(blocks.size() == 9);
+			CHECK(pool.getChunkCount() == 3);
+			CHECK(upstream.allocations == 3);
+
+			for (auto* block : blocks) {
+				CHECK(reinterpret_cast<uintptr_t>(block) %
+				          alignof(std::max_align_t) ==
+				      0);
+				pool.deallocate(block, 32);
+			}
+			CHECK(pool.getLiveCount() == 0);
+		}
+		CHECK(upstream.deallocations == 3);
+	}
+
+	TEST("elemental::BlockPool - oversized requests go upstream")
+	{
+		CountingResource upstream;
+		BlockPool pool(16, 4, &upstream);
+
+		auto* large = pool.allocate(64);
+		CHECK(upstream.allocations == 1);
+		CHECK(pool.getChunkCount() == 0);
+		pool.deallocate(large, 64);
+		CHECK(upstream.deallocations == 1);
+	}
+
+	TEST("elemental::BlockPool - ComponentPool churn stays off upstream")
+	{
+		struct Position {
+			float x, y;
+		};
+		CountingResource upstream;
+		ComponentPool<Position> components(&upstream);
+
+		for (unsigned id = 0; id < 10'000; ++id) {
+			components.emplace(id, 0.0f, 0.0f);
+		}
+		auto after_fill = upstream.allocations;
+
+		for (unsigned round = 0; round < 100; ++round) {
+			for (unsigned id = 0; id < 100; ++id) {
+				components.remove(id * 97);
+			}
+			for (unsigned id = 0; id < 100; ++id) {
+				components.emplace(id * 97, 1.0f, 1.0f);
+			}
+		}
+		CHECK(upstream.allocations == after_fill);
+		CHECK(components.size() == 10'000);
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,238 @@
+/* ChunkStreamer.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "ChunkStreamer.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <future>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::ChunkStreamer")
+{
+	using namespace elemental;
+
+	using Chunk = std::shared_ptr<std::vector<char>>;
+	using Streamer = ChunkStreamer<Chunk>;
+
+	const Area kMapSize{ 10 * 256, 8 * 256 };
+
+	// Hands out futures and completes them when the test says so
+	struct TestFixture {
+		std::map<std::pair<uint32_t, uint32_t>, std::promise<Chunk>>
+		    pending;
+		std::vector<ChunkCoord> requests;
+
+		auto makeStreamer(const StreamingSettings& settings) -> Streamer
+		{
+			return Streamer(
+			    kMapSize, settings,
+			    [this](ChunkCoord coord, const Rectangle& bounds) {
+				    requests.push_back(coord);
+				    auto& promise =
+					pending[{ coord.column, coord.row }];
+				    promise = {};
+				    (void)bounds;
+				    return promise.get_future().share();
+			    },
+			    [](const Chunk& chunk) { return chunk->size(); }
+			);
+		}
+
+		void completeAll(size_t bytes = 1024)
+		{
+			for (auto& [coord, promise] : pending) {
+				promise.set_value(
+				    std::make_shared<std::vector<char>>(bytes)
+				);
+			}
+			pending.clear();
+		}
+	};
+
+	auto settings_with(uint32_t load_radius, uint32_t hysteresis)
+	    -> StreamingSettings
+	{
+		return { { 256, 256 }, load_radius, hysteresis, 0 };
+	}
+
+	TEST("elemental::ChunkStreamer - maps points and chunks")
+	{
+		Streamer streamer(
+		    { 1000, 600 }, settings_with(1, 1),
+		    [](ChunkCoord, const Rectangle&) {
+			    return Streamer::ChunkFuture();
+		    },
+		    [](const Chunk&) { return size_t{ 0 }; }
+		);
+
+		CHECK(streamer.getChunkCounts().width == 4);
+		CHECK(streamer.getChunkCounts().height == 3);
+		CHECK(streamer.chunkAt({ 0, 0 }) == ChunkCoord{ 0, 0 });
+		CHECK(streamer.chunkAt({ 256, 511 }) == ChunkCoord{ 1, 1 });
+		// Points beyond the map clamp to the edge chunks
+		CHECK(streamer.chunkAt({ 5000, 5000 }) == ChunkCoord{ 3, 2 });
+
+		auto edge = streamer.chunkBounds({ 3, 2 });
+		CHECK(edge.x() == 768);
+		CHECK(edge.y() == 512);
+		CHECK(edge.width() == 232);
+		CHECK(edge.height() == 88);
+	}
+
+	FIXTURE_TEST("elemental::ChunkStreamer - loads only around the focus")
+	{
+		auto streamer = makeStreamer(settings_with(1, 1));
+
+		CHECK(streamer.update({ 1300, 1300 }) == 0);
+		// A 3 x 3 block, nearest chunk first
+		REQUIRE(requests.size() == 9);
+		CHECK(requests.front() == ChunkCoord{ 5, 5 });
+		CHECK(streamer.getStats().loading_count == 9);
+		CHECK_FALSE(streamer.isResident({ 5, 5 }));
+		CHECK(streamer.isRequested({ 4, 6 }));
+		CHECK_FALSE(streamer.isRequested({ 7, 5 }));
+
+		completeAll(1000);
+		CHECK(streamer.update({ 1300, 1300 }) == 9);
+		CHECK(streamer.isResident({ 5, 5 }));
+		CHECK(streamer.getResidentBytes() == 9 * 1000);
+		CHECK(streamer.getStats().loading_count == 0);
+		CHECK(requests.size() == 9);
+	}
+
+	FIXTURE_TEST("elemental::ChunkStreamer - corners clamp to the map")
+	{
+		auto streamer = makeStreamer(settings_with(2, 0));
+
+		streamer.update({ 0, 0 });
+		CHECK(requests.size() == 9);
+		for (auto coord : requests) {
+			CHECK(coord.column <= 2);
+			CHECK(coord.row <= 2);
+		}
+	}
+
+	FIXTURE_TEST("elemental::ChunkStreamer - hysteresis delays unloading")
+	{
+		auto streamer = makeStreamer(settings_with(1, 1));
+		streamer.update({ 128, 128 });
+		completeAll();
+		streamer.update({ 128, 128 });
+		REQUIRE(streamer.isResident({ 0, 0 }));
+
+		// Two chunks over: column 0 is two away, within 1 + 1
+		streamer.update({ 2 * 256 + 128, 128 });
+		CHECK(streamer.isResident({ 0, 0 }));
+		CHECK(streamer.getStats().unloads == 0);
+
+		// Back again: nothing is reloaded, and only the loads in
+		// column 3, now three away, are dropped
+		auto request_count = requests.size();
+		streamer.update({ 128, 128 });
+		CHECK(requests.size() == request_count);
+		CHECK(streamer.isResident({ 0, 0 }));
+		CHECK(streamer.getStats().unloads == 2);
+
+		// Three over: column 0 drops out, column 1 stays
+		streamer.update({ 3 * 256 + 128, 128 });
+		CHECK_FALSE(streamer.isRequested({ 0, 0 }));
+		CHECK_FALSE(streamer.isRequested({ 0, 1 }));
+		CHECK(streamer.isResident({ 1, 0 }));
+		CHECK(streamer.getStats().unloads == 4);
+		CHECK(streamer.getStats().resident_count == 2);
+		CHECK(streamer.getResidentBytes() == 2 * 1024);
+	}
+
+	FIXTURE_TEST("elemental::ChunkStreamer - dropping in-flight loads")
+	{
+		auto streamer = makeStreamer(settings_with(0, 0));
+		streamer.update({ 0, 0 });
+		streamer.update({ 2000, 0 });
+
+		CHECK_FALSE(streamer.isRequested({ 0, 0 }));
+		CHECK(streamer.getStats().loading_count == 1);
+
+		// The abandoned load completing later changes nothing
+		completeAll();
+		streamer.update({ 2000, 0 });
+		CHECK(streamer.getStats().resident_count == 1);
+		CHECK(streamer.isResident({ 7, 0 }));
+	}
+
+	FIXTURE_TEST("elemental::ChunkStreamer - failed loads are not retried")
+	{
+		auto streamer = makeStreamer(settings_with(0, 0));
+		streamer.update({ 0, 0 });
+		pending.begin()->second.set_exception(
+		    std::make_exception_ptr(std::runtime_error("missing"))
+		);
+		pending.clear();
+
+		streamer.update({ 0, 0 });
+		streamer.update({ 0, 0 });
+		CHECK(requests.size() == 1);
+		CHECK(streamer.getStats().failures == 1);
+		CHECK_FALSE(streamer.isResident({ 0, 0 }));
+
+		// Leaving and coming back tries again
+		streamer.update({ 2000, 2000 });
+		streamer.update({ 0, 0 });
+		CHECK(requests.size() == 3);
+	}
+
+	FIXTURE_TEST("elemental::ChunkStreamer - request limit per update")
+	{
+		auto settings = settings_with(2, 0);
+		settings.max_requests_per_update = 4;
+		auto streamer = makeStreamer(settings);
+
+		streamer.update({ 1300, 1000 });
+		REQUIRE(requests.size() == 4);
+		CHECK(requests.front() == ChunkCoord{ 5, 3 });
+
+		while (streamer.getStats().loading_count +
+		           streamer.getStats().resident_count <
+		       25) {
+			streamer.update({ 1300, 1000 });
+		}
+		CHECK(requests.size() == 25);
+	}
+
+	FIXTURE_TEST("elemental::ChunkStreamer - visits resident chunks in view")
+	{
+		auto streamer = makeStreamer(settings_with(1, 0));
+		streamer.update({ 600, 600 });
+		completeAll();
+		streamer.update({ 600, 600 });
+
+		std::vector<ChunkCoord> visited;
+		streamer.forEachResident(
+		    { { 300, 300 }, { 300, 10 } },
+		    [&](ChunkCoord coord, const Rectangle& bounds, const Chunk&) {
+			    CHECK(bounds.x() == coord.column * 256);
+			    CHECK(bounds.y() == coord.row * 256);
+			    visited.push_back(coord);
+		    }
+		);
+		CHECK(visited ==
+		      std::vector<ChunkCoord>{ { 1, 1 }, { 2, 1 } });
+
+		streamer.clear();
+		CHECK(streamer.getResidentBytes() == 0);
+		CHECK_FALSE(streamer.isResident({ 1, 1 }));
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,284 @@
+/* ComponentFactory.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "ComponentFactory.hpp"
+#include "ComponentPool.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::ComponentFactory")
+{
+	using namespace elemental;
+	using InstanceID = Component::InstanceID;
+
+	struct Position {
+		float x, y;
+	};
+	struct Velocity {
+		float dx, dy;
+	};
+	// Throws from its constructor when given a negative value
+	struct Checked {
+		explicit Checked(int value) : value(value)
+		{
+			if (value < 0) {
+				throw std::invalid_argument("negative");
+			}
+		}
+		int value;
+	};
+
+	TEST("elemental::ComponentPool - add, get and remove by id")
+	{
+		ComponentPool<Position> pool;
+
+		pool.emplace(10, 1.0f, 2.0f);
+		pool.emplace(20, 3.0f, 4.0f);
+		pool.emplace(30, 5.0f, 6.0f);
+		REQUIRE(pool.size() == 3);
+
+		REQUIRE(pool.get(20) != nullptr);
+		CHECK(pool.get(20)->x == 3.0f);
+		CHECK(pool.get(25) == nullptr);
+		CHECK_FALSE(pool.has(25));
+
+		CHECK(pool.remove(10));
+		CHECK_FALSE(pool.remove(10));
+		CHECK_FALSE(pool.has(10));
+		CHECK(pool.size() == 2);
+
+		// The last component moved into the freed position
+		REQUIRE(pool.get(30) != nullptr);
+		CHECK(pool.get(30)->y == 6.0f);
+		CHECK(pool.getIds()[0] == 30);
+	}
+
+	TEST("elemental::ComponentPool - emplacing an existing id replaces it")
+	{
+		ComponentPool<Position> pool;
+		pool.emplace(7, 1.0f, 1.0f);
+		pool.emplace(7, 9.0f, 9.0f);
+
+		CHECK(pool.size() == 1);
+		CHECK(pool.get(7)->x == 9.0f);
+	}
+
+	TEST("elemental::ComponentPool - a throwing constructor adds nothing")
+	{
+		ComponentPool<Checked> pool;
+		pool.emplace(1, 1);
+
+		REQUIRE_THROWS_AS(pool.emplace(2, -1), std::invalid_argument);
+		CHECK_FALSE(pool.has(2));
+		CHECK(pool.get(2) == nullptr);
+		CHECK(pool.size() == 1);
+
+		// The id can still be added afterwards
+		pool.emplace(2, 2);
+		REQUIRE(pool.get(2) != nullptr);
+		CHECK(pool.get(2)->value == 2);
+		CHECK(pool.getIds().size() == 2);
+	}
+
+	TEST("elemental::ComponentPool - ids and components stay paired")
+	{
+		ComponentPool<Position> pool;
+		std::mt19937 generator(5);
+		std::vector<InstanceID> live;
+
+		for (InstanceID id = 0; id < 2000; ++id) {
+			// Spread ids over several sparse pages
+			auto spread_id = id * 37;
+			pool.emplace(spread_id, static_cast<float>(spread_id), 0.0f);
+			live.push_back(spread_id);
+		}
+		std::shuffle(live.begin(), live.end(), generator);
+		for (size_t i = 0; i < 1000; ++i) {
+			REQUIRE(pool.remove(live[i]));
+		}
+
+		REQUIRE(pool.size() == 1000);
+		bool paired = true;
+		pool.forEach([&](InstanceID id, Position& position) {
+			paired = paired && position.x == static_cast<float>(id);
+		});
+		CHECK(paired);
+		for (size_t i = 1000; i < live.size(); ++i) {
+			CHECK(pool.has(live[i]));
+		}
+
+		pool.clear();
+		CHECK(pool.empty());
+		CHECK_FALSE(pool.has(live.back()));
+	}
+
+	TEST("elemental::ComponentFactory - keeps one pool per type")
+	{
+		ComponentFactory factory;
+
+		factory.createComponent<Position>(1, 1.0f, 2.0f);
+		factory.createComponent<Velocity>(1, 0.5f, 0.5f);
+		factory.createComponent<Position>(2, 3.0f, 4.0f);
+
+		CHECK(factory.getPool<Position>().size() == 2);
+		CHECK(factory.getPool<Velocity>().size() == 1);
+
+		REQUIRE(factory.getComponent<Velocity>(1) != nullptr);
+		CHECK(factory.getComponent<Velocity>(1)->dx == 0.5f);
+		CHECK(factory.getComponent<Velocity>(2) == nullptr);
+		CHECK(factory.hasComponent<Position>(2));
+		CHECK_FALSE(factory.hasComponent<Velocity>(2));
+
+		CHECK(factory.removeComponent<Position>(2));
+		CHECK_FALSE(factory.hasComponent<Position>(2));
+	}
+
+	TEST("elemental::ComponentFactory - removeAll drops every type")
+	{
+		ComponentFactory factory;
+		factory.createComponent<Position>(4, 0.0f, 0.0f);
+		factory.createComponent<Velocity>(4, 0.0f, 0.0f);
+		factory.createComponent<Position>(5, 0.0f, 0.0f);
+
+		factory.removeAll(4);
+
+		CHECK_FALSE(factory.hasComponent<Position>(4));
+		CHECK_FALSE(factory.hasComponent<Velocity>(4));
+		CHECK(factory.hasComponent<Position>(5));
+	}
+
+	TEST("elemental::ComponentFactory - unknown types have no pool")
+	{
+		struct Unused {
+			int value;
+		};
+		ComponentFactory factory;
+
+		CHECK(factory.findPool<Unused>() == nullptr);
+		CHECK(factory.getComponent<Unused>(0) == nullptr);
+		CHECK_FALSE(factory.removeComponent<Unused>(0));
+		CHECK(factory.findPool<Unused>() == nullptr);
+	}
+
+	BENCHMARK_TEST("elemental::ComponentFactory - sparse set vs. pointer "
+	               "pool")
+	{
+		using namespace std::chrono;
+
+		// The previous layout: one heap object per component, reached
+		// through a type map and a vector of shared_ptrs.
+		struct LegacyComponent {
+			virtual ~LegacyComponent() = default;
+			InstanceID id;
+		};
+		struct LegacyPosition : LegacyComponent {
+			float x, y;
+		};
+		using LegacyPool = std::unordered_map<
+		    std::type_index,
+		    std::vector<std::shared_ptr<LegacyComponent>>>;
+
+		auto elapsed_ms = [](auto start) {
+			return duration<double, std::milli>(
+			           steady_clock::now() - start
+			)
+			    .count();
+		};
+
+		for (InstanceID count : { 100'000u, 1'000'000u }) {
+			std::vector<InstanceID> lookups(count);
+			std::iota(lookups.begin(), lookups.end(), 0);
+			std::shuffle(
+			    lookups.begin(), lookups.end(), std::mt19937(3)
+			);
+
+			// Legacy pool
+			auto start = steady_clock::now();
+			LegacyPool legacy_pool;
+			std::unordered_map<InstanceID,
+			                   std::shared_ptr<LegacyComponent>>
+			    legacy_index;
+			auto& legacy_vector =
+			    legacy_pool[std::type_index(typeid(LegacyPosition))];
+			for (InstanceID id = 0; id < count; ++id) {
+				auto component =
+				    std::make_shared<LegacyPosition>();
+				component->id = id;
+				component->x = 1.0f;
+				legacy_vector.push_back(component);
+				legacy_index[id] = component;
+			}
+			auto legacy_create = elapsed_ms(start);
+
+			start = steady_clock::now();
+			float legacy_sum = 0;
+			for (auto& component :
+			     legacy_pool[std::type_index(typeid(LegacyPosition))]) {
+				legacy_sum += static_cast<LegacyPosition&>(
+				                  *component
+				)
+				                  .x;
+			}
+			auto legacy_iterate = elapsed_ms(start);
+
+			start = steady_clock::now();
+			for (auto id : lookups) {
+				legacy_sum += static_cast<LegacyPosition&>(
+				                  *legacy_index[id]
+				)
+				                  .y;
+			}
+			auto legacy_lookup = elapsed_ms(start);
+
+			// Sparse set
+			start = steady_clock::now();
+			ComponentFactory factory;
+			for (InstanceID id = 0; id < count; ++id) {
+				factory.createComponent<Position>(id, 1.0f, 0.0f);
+			}
+			auto dense_create = elapsed_ms(start);
+
+			start = steady_clock::now();
+			float dense_sum = 0;
+			for (auto& position : factory.getPool<Position>()) {
+				dense_sum += position.x;
+			}
+			auto dense_iterate = elapsed_ms(start);
+
+			start = steady_clock::now();
+			for (auto id : lookups) {
+				dense_sum += factory.getComponent<Position>(id)->y;
+			}
+			auto dense_lookup = elapsed_ms(start);
+
+			CHECK(legacy_sum == dense_sum);
+			std::cout << count << " components (ms)\n"
+				  << "  create:  pointer pool " << legacy_create
+				  << ", sparse set " << dense_create << "\n"
+				  << "  iterate: pointer pool " << legacy_iterate
+				  << ", sparse set " << dense_iterate << "\n"
+				  << "  lookup:  pointer pool " << legacy_lookup
+				  << ", sparse set " << dense_lookup << "\n";
+		}
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,207 @@
+/* ComponentView.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "ComponentFactory.hpp"
+#include "ComponentView.hpp"
+#include "ThreadPool.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::ComponentView")
+{
+	using namespace elemental;
+	using InstanceID = Component::InstanceID;
+
+	struct Position {
+		float x, y;
+	};
+	struct Velocity {
+		float dx, dy;
+	};
+	struct Sprite {
+		int frame;
+	};
+
+	struct TestFixture {
+		ComponentFactory factory;
+
+		TestFixture() : factory()
+		{
+			// Every id has a Position, even ids a Velocity, and
+			// every tenth id a Sprite.
+			for (InstanceID id = 0; id < 1000; ++id) {
+				factory.createComponent<Position>(
+				    id, static_cast<float>(id), 0.0f
+				);
+				if (id % 2 == 0) {
+					factory.createComponent<Velocity>(
+					    id, 1.0f, 2.0f
+					);
+				}
+				if (id % 10 == 0) {
+					factory.createComponent<Sprite>(
+					    id, static_cast<int>(id)
+					);
+				}
+			}
+		}
+	};
+
+	FIXTURE_TEST("elemental::ComponentView - visits ids with every type")
+	{
+		std::set<InstanceID> visited;
+		bool consistent = true;
+
+		factory.view<Position, Velocity, Sprite>().forEach(
+		    [&](InstanceID id,
+		        Position& position,
+		        Velocity& velocity,
+		        Sprite& sprite) {
+			    visited.insert(id);
+			    consistent = consistent &&
+			                 position.x == static_cast<float>(id) &&
+			                 velocity.dy == 2.0f &&
+			                 sprite.frame == static_cast<int>(id);
+		    }
+		);
+
+		CHECK(visited.size() == 100);
+		CHECK(consistent);
+		for (auto id : visited) {
+			CHECK(id % 10 == 0);
+		}
+	}
+
+	FIXTURE_TEST("elemental::ComponentView - drives from the smallest pool")
+	{
+		auto view = factory.view<Position, Velocity, Sprite>();
+		CHECK(view.sizeHint() == 100);
+
+		factory.removeComponent<Velocity>(10);
+		size_t visited = 0;
+		factory.view<Velocity, Sprite>().forEach(
+		    [&](InstanceID id, Velocity&, Sprite&) { ++visited; }
+		);
+		CHECK(visited == 99);
+	}
+
+	FIXTURE_TEST("elemental::ComponentView - writes reach the pools")
+	{
+		factory.view<Position, Velocity>().forEach(
+		    [](InstanceID, Position& position, Velocity& velocity) {
+			    position.x += velocity.dx;
+			    position.y += velocity.dy;
+		    }
+		);
+
+		CHECK(factory.getComponent<Position>(4)->x == 5.0f);
+		CHECK(factory.getComponent<Position>(4)->y == 2.0f);
+		CHECK(factory.getComponent<Position>(5)->y == 0.0f);
+	}
+
+	TEST("elemental::ComponentView - a missing type yields nothing")
+	{
+		struct Unused {};
+		ComponentFactory factory;
+		factory.createComponent<Position>(1, 0.0f, 0.0f);
+
+		size_t visited = 0;
+		factory.view<Position, Unused>().forEach(
+		    [&](InstanceID, Position&, Unused&) { ++visited; }
+		);
+		CHECK(visited == 0);
+	}
+
+	FIXTURE_TEST("elemental::ComponentView - parallelEach visits each match "
+	             "once")
+	{
+		std::vector<std::atomic<int>> visits(1000);
+		ThreadPool pool(3);
+
+		factory.view<Position, Velocity>().parallelEach(
+		    pool,
+		    [&](InstanceID id, Position&, Velocity&) {
+			    visits[id].fetch_add(1);
+		    },
+		    16
+		);
+
+		bool exact = true;
+		for (InstanceID id = 0; id < visits.size(); ++id) {
+			exact = exact && visits[id].load() == ((id % 2) ? 0 : 1);
+		}
+		CHECK(exact);
+	}
+
+	FIXTURE_TEST("elemental::ComponentView - parallelEach rethrows")
+	{
+		auto view = factory.view<Position>();
+		ThreadPool pool(3);
+		REQUIRE_THROWS_AS(view.parallelEach(
+				      pool,
+				      [](InstanceID id, Position&) {
+					      if (id == 500) {
+						      throw std::runtime_error(
+							  "boom"
+						      );
+					      }
+				      },
+				      8
+				  ),
+		                  std::runtime_error);
+	}
+
+	BENCHMARK_TEST("elemental::ComponentView - serial vs. parallel")
+	{
+		using namespace std::chrono;
+		ComponentFactory factory;
+		const InstanceID kCount = 1'000'000;
+
+		for (InstanceID id = 0; id < kCount; ++id) {
+			factory.createComponent<Position>(id, 0.0f, 0.0f);
+			factory.createComponent<Velocity>(id, 1.0f, 1.0f);
+		}
+
+		auto integrate = [](InstanceID,
+		                    Position& position,
+		                    Velocity& velocity) {
+			position.x += velocity.dx * 0.016f;
+			position.y += velocity.dy * 0.016f;
+		};
+		auto measure = [&](auto run) {
+			auto start = steady_clock::now();
+			run();
+			return duration<double, std::milli>(
+			           steady_clock::now() - start
+			)
+			    .count();
+		};
+
+		auto view = factory.view<Position, Velocity>();
+		ThreadPool pool;
+		auto serial_ms = measure([&]() { view.forEach(integrate); });
+		auto parallel_ms =
+		    measure([&]() { view.parallelEach(pool, integrate); });
+
+		CHECK(factory.getComponent<Position>(kCount - 1)->x > 0.0f);
+		std::cout << kCount << " entities: serial " << serial_ms
+			  << " ms, parallel " << parallel_ms << " ms ("
+			  << pool.getThreadCount() + 1 << " threads)\n";
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,224 @@
+/* EntityAllocator.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "EntityAllocator.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::EntityAllocator")
+{
+	using namespace elemental;
+	using namespace std::chrono;
+
+	struct TestFixture {
+		EntityAllocator entities;
+	};
+
+	FIXTURE_TEST("elemental::EntityAllocator - fresh handles are distinct")
+	{
+		std::set<uint32_t> indices;
+		for (int i = 0; i < 100; ++i) {
+			auto entity = entities.create();
+			CHECK(entity.isValid());
+			CHECK(entities.isAlive(entity));
+			indices.insert(entity.index);
+		}
+		CHECK(indices.size() == 100);
+		CHECK(entities.getLiveCount() == 100);
+		CHECK(entities.getSlotCount() == 100);
+	}
+
+	FIXTURE_TEST("elemental::EntityAllocator - indices are recycled with a "
+	             "new generation")
+	{
+		auto first = entities.create();
+		REQUIRE(entities.destroy(first));
+		CHECK_FALSE(entities.isAlive(first));
+
+		auto second = entities.create();
+		CHECK(second.index == first.index);
+		CHECK(second.generation != first.generation);
+		CHECK(entities.isAlive(second));
+		CHECK_FALSE(entities.isAlive(first));
+		CHECK(entities.getSlotCount() == 1);
+	}
+
+	FIXTURE_TEST("elemental::EntityAllocator - stale handles are rejected")
+	{
+		auto entity = entities.create();
+		REQUIRE(entities.destroy(entity));
+		CHECK_FALSE(entities.destroy(entity));
+
+		auto replacement = entities.create();
+		// The stale handle must not destroy the slot's new occupant
+		CHECK_FALSE(entities.destroy(entity));
+		CHECK(entities.isAlive(replacement));
+		CHECK(entities.getLiveCount() == 1);
+	}
+
+	FIXTURE_TEST("elemental::EntityAllocator - invalid handles are never "
+	             "alive")
+	{
+		EntityHandle nothing;
+		CHECK_FALSE(nothing.isValid());
+		CHECK_FALSE(entities.isAlive(nothing));
+		CHECK_FALSE(entities.destroy(nothing));
+		CHECK_FALSE(entities.isAlive({ 12345, 0 }));
+	}
+
+	FIXTURE_TEST("elemental::EntityAllocator - never-issued handles are "
+	             "rejected")
+	{
+		// Index 5 shares the page of index 0 but was never handed out;
+		// 1 is the generation its first occupant will get
+		auto first = entities.create();
+		EntityHandle forged{ 5, 1 };
+		CHECK_FALSE(entities.isAlive(forged));
+		CHECK_FALSE(entities.destroy(forged));
+		CHECK(entities.getLiveCount() == 1);
+
+		// Nothing was pushed on the free stack, so indices stay unique
+		std::set<uint32_t> indices{ first.index };
+		for (int i = 0; i < 10; ++i) {
+			auto entity = entities.create();
+			CHECK(entity.generation == 1);
+			indices.insert(entity.index);
+		}
+		CHECK(indices.size() == 11);
+		CHECK(entities.isAlive(forged));
+		CHECK(entities.getLiveCount() == 11);
+	}
+
+	FIXTURE_TEST("elemental::EntityAllocator - forged handles cannot free "
+	             "a free slot")
+	{
+		auto entity = entities.create();
+		REQUIRE(entities.destroy(entity));
+
+		// The generation the slot's next occupant would get
+		EntityHandle forged{ entity.index, entity.generation + 1 };
+		CHECK_FALSE(entities.isAlive(forged));
+		CHECK_FALSE(entities.destroy(forged));
+		CHECK(entities.getLiveCount() == 0);
+
+		// A second push of the index would hand it out twice
+		auto first = entities.create();
+		auto second = entities.create();
+		CHECK(first.index != second.index);
+		CHECK(entities.isAlive(first));
+		CHECK(entities.isAlive(second));
+	}
+
+	FIXTURE_TEST("elemental::EntityAllocator - concurrent churn never hands "
+	             "out a live index twice")
+	{
+		const int kThreadCount = 4;
+		const int kRounds = 20'000;
+		const size_t kMaxIndices = kThreadCount * 64;
+
+		// Which thread currently holds each index, 0 for none
+		auto owners = std::make_unique<std::atomic<int>[]>(kMaxIndices);
+		std::atomic<int> collisions{ 0 };
+
+		auto churn = [&](int thread_id) {
+			std::vector<EntityHandle> held;
+			for (int round = 0; round < kRounds; ++round) {
+				if (held.size() < 32 && (round % 3) != 2) {
+					auto entity = entities.create();
+					int expected = 0;
+					if (entity.index >= kMaxIndices ||
+					    !owners[entity.index]
+						 .compare_exchange_strong(
+						     expected, thread_id
+						 )) {
+						++collisions;
+						continue;
+					}
+					held.push_back(entity);
+				} else if (!held.empty()) {
+					auto entity = held.back();
+					held.pop_back();
+					owners[entity.index].store(0);
+					if (!entities.destroy(entity)) {
+						++collisions;
+					}
+				}
+			}
+			for (auto& entity : held) {
+				owners[entity.index].store(0);
+				entities.destroy(entity);
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (int id = 1; id <= kThreadCount; ++id) {
+			threads.emplace_back(churn, id);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		CHECK(collisions.load() == 0);
+		CHECK(entities.getLiveCount() == 0);
+		CHECK(entities.getSlotCount() <= kThreadCount * 32);
+	}
+
+	BENCHMARK_TEST("elemental::EntityAllocator - create/destroy throughput")
+	{
+		const int kOperations = 1'000'000;
+		auto hardware_threads =
+		    std::max(1u, std::thread::hardware_concurrency());
+
+		for (unsigned thread_count = 1; thread_count <= hardware_threads;
+		     thread_count *= 2) {
+			EntityAllocator entities;
+			auto churn = [&]() {
+				EntityHandle held[16];
+				for (int i = 0; i < kOperations / 16; ++i) {
+					for (auto& entity : held) {
+						entity = entities.create();
+					}
+					for (auto& entity : held) {
+						entities.destroy(entity);
+					}
+				}
+			};
+
+			auto start = steady_clock::now();
+			std::vector<std::thread> threads;
+			for (unsigned index = 0; index < thread_count; ++index) {
+				threads.emplace_back(churn);
+			}
+			for (auto& thread : threads) {
+				thread.join();
+			}
+			auto elapsed_ns =
+			    duration<double, std::nano>(steady_clock::now() - start)
+				.count();
+
+			std::cout << "EntityAllocator " << thread_count
+				  << " thread(s): "
+				  << elapsed_ns / (kOperations * thread_count)
+				  << " ns per create+destroy" << std::endl;
+			CHECK(entities.getLiveCount() == 0);
+		}
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
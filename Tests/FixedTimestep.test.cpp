@@ -0,0 +1,94 @@
+/* FixedTimestep.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "FixedTimestep.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+BEGIN_TEST_SUITE("elemental::FixedTimestep")
+{
+	using namespace elemental;
+	using namespace std::chrono;
+
+	TEST("elemental::FixedTimestep - runs two 120Hz ticks per 60Hz frame")
+	{
+		FixedTimestep timestep(120_Hz);
+		const auto kFrame = duration_cast<nanoseconds>(
+		    duration<double>(1.0 / 60)
+		);
+
+		unsigned total_ticks = 0;
+		nanoseconds simulated(0);
+		for (int frame = 0; frame < 60; ++frame) {
+			total_ticks += timestep.advance(
+			    kFrame, [&](nanoseconds step) { simulated += step; }
+			);
+		}
+
+		// Rounding of the two periods may leave the last tick pending
+		CHECK(total_ticks >= 119);
+		CHECK(total_ticks <= 120);
+		CHECK(timestep.getTickCount() == total_ticks);
+		CHECK(simulated == total_ticks * timestep.getStep());
+		CHECK(timestep.getDroppedTime() == 0ns);
+	}
+
+	TEST("elemental::FixedTimestep - leftover time becomes the alpha")
+	{
+		FixedTimestep timestep(100_Hz); // 10ms ticks
+		auto no_op = [](nanoseconds) {};
+
+		CHECK(timestep.advance(25ms, no_op) == 2);
+		CHECK(std::abs(timestep.getAlpha() - 0.5) < 1e-9);
+
+		CHECK(timestep.advance(4ms, no_op) == 0);
+		CHECK(std::abs(timestep.getAlpha() - 0.9) < 1e-9);
+
+		CHECK(timestep.advance(1ms, no_op) == 1);
+		CHECK(timestep.getAlpha() < 1e-9);
+	}
+
+	TEST("elemental::FixedTimestep - caps catch-up steps")
+	{
+		FixedTimestep timestep(100_Hz, 4);
+		unsigned ticks = 0;
+
+		// A 1s hitch would need 100 ticks; only 4 run
+		CHECK(timestep.advance(1005ms, [&](nanoseconds) { ++ticks; }) ==
+		      4);
+		CHECK(ticks == 4);
+		CHECK(timestep.getDroppedTime() == 960ms);
+		CHECK(std::abs(timestep.getAlpha() - 0.5) < 1e-9);
+
+		// The next frame is back to normal
+		CHECK(timestep.advance(10ms, [&](nanoseconds) { ++ticks; }) ==
+		      1);
+	}
+
+	TEST("elemental::FixedTimestep - measures real time between frames")
+	{
+		FixedTimestep timestep(1000_Hz);
+		unsigned ticks = 0;
+		auto count_tick = [&](nanoseconds) { ++ticks; };
+
+		CHECK(timestep.advance(count_tick) == 0); // starts the clock
+		std::this_thread::sleep_for(5ms);
+		timestep.advance(count_tick);
+
+		CHECK(ticks >= 5);
+		CHECK(ticks <= 8);
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
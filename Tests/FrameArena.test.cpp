@@ -0,0 +1,165 @@
+/* FrameArena.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "ComponentFactory.hpp"
+#include "FrameArena.hpp"
+#include "FrameStats.hpp"
+
+#include "test-utils/AllocationCounter.hpp"
+#include "test-utils/common.hpp"
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::FrameArena")
+{
+	using namespace elemental;
+	using test::AllocationCounter;
+	using InstanceID = Component::InstanceID;
+
+	struct Position {
+		float x, y;
+	};
+	struct Velocity {
+		float dx, dy;
+	};
+
+	auto is_aligned(void* pointer, size_t alignment) -> bool
+	{
+		return reinterpret_cast<uintptr_t>(pointer) % alignment == 0;
+	}
+
+	TEST("elemental::FrameArena - allocations are aligned and packed")
+	{
+		FrameArena arena(1024);
+
+		auto* first = arena.allocate(3, 1);
+		auto* second = arena.allocate(8, 8);
+		auto* third = arena.allocate(16, 64);
+
+		CHECK(is_aligned(second, 8));
+		CHECK(is_aligned(third, 64));
+		CHECK(static_cast<std::byte*>(second) >
+		      static_cast<std::byte*>(first));
+		CHECK(static_cast<std::byte*>(second) -
+		          static_cast<std::byte*>(first) <=
+		      8);
+		CHECK(arena.getUsed() >= 27);
+	}
+
+	TEST("elemental::FrameArena - reset reuses the same memory")
+	{
+		FrameArena arena(1024);
+
+		auto* before = arena.allocate(100, 16);
+		arena.reset();
+		auto* after = arena.allocate(100, 16);
+
+		CHECK(before == after);
+		CHECK(arena.getUsed() == 100);
+		CHECK(arena.getHighWaterMark() == 100);
+	}
+
+	TEST("elemental::FrameArena - an overflowing frame grows the arena")
+	{
+		FrameArena arena(256);
+
+		for (int i = 0; i < 10; ++i) {
+			auto* memory = arena.allocate(100, 8);
+			REQUIRE(memory != nullptr);
+		}
+		CHECK(arena.getCapacity() == 256);
+		CHECK(arena.getUsed() >= 1000);
+
+		arena.reset();
+		CHECK(arena.getCapacity() >= 1000);
+		CHECK(arena.getUsed() == 0);
+	}
+
+	TEST("elemental::FrameArena - backs std::pmr containers")
+	{
+		FrameArena arena(4096);
+		{
+			std::pmr::vector<int> numbers(&arena);
+			for (int i = 0; i < 100; ++i) {
+				numbers.push_back(i);
+			}
+			CHECK(numbers[99] == 99);
+		}
+		CHECK(arena.getUsed() >= 100 * sizeof(int));
+	}
+
+	TEST("elemental::FrameArena - steady-state frames allocate nothing")
+	{
+		FrameArena arena(64 * 1024);
+		ComponentFactory components;
+		FrameStats frame_stats;
+
+		for (InstanceID id = 0; id < 1000; ++id) {
+			components.createComponent<Position>(id, 0.0f, 0.0f);
+			components.createComponent<Velocity>(id, 1.0f, 1.0f);
+		}
+
+		auto run_frame = [&](int frame) {
+			frame_stats.beginFrame();
+
+			// Scratch data that only lives for this frame
+			std::pmr::vector<InstanceID> moved(&arena);
+			std::pmr::string label(
+			    "scratch text too long for the small-string buffer",
+			    &arena
+			);
+			components.view<Position, Velocity>().forEach(
+			    [&](InstanceID id,
+			        Position& position,
+			        Velocity& velocity) {
+				    position.x += velocity.dx;
+				    moved.push_back(id);
+			    }
+			);
+			frame_stats.mark(FramePhase::Update);
+
+			// Component churn at a constant population
+			for (InstanceID offset = 0; offset < 10; ++offset) {
+				auto id = static_cast<InstanceID>(
+				    (frame * 10 + offset) % 1000
+				);
+				components.removeComponent<Velocity>(id);
+				components.createComponent<Velocity>(
+				    id, 1.0f, 1.0f
+				);
+			}
+			frame_stats.mark(FramePhase::Render);
+			frame_stats.endFrame();
+
+			REQUIRE(moved.size() == 1000);
+			arena.reset();
+		};
+
+		// Warm-up frames size the arena and the pools
+		for (int frame = 0; frame < 3; ++frame) {
+			run_frame(frame);
+		}
+
+		size_t allocations = 0;
+		{
+			AllocationCounter counter;
+			for (int frame = 3; frame < 103; ++frame) {
+				run_frame(frame);
+			}
+			allocations = counter.getCount();
+		}
+		CHECK(allocations == 0);
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,180 @@
+/* FrameStats.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "FrameStats.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+BEGIN_TEST_SUITE("elemental::FrameStats")
+{
+	using namespace elemental;
+	using namespace std::chrono;
+
+	auto uniform_frame(nanoseconds phase_time) -> FrameTiming
+	{
+		FrameTiming timing{};
+		timing.phases.fill(phase_time);
+		return timing;
+	}
+
+	TEST("elemental::FrameStats - percentiles of a known distribution")
+	{
+		FrameStats stats;
+		// Frames of 1..100 microseconds per phase, recorded out of order
+		for (int i = 100; i >= 1; --i) {
+			stats.record(uniform_frame(microseconds(i)));
+		}
+
+		auto report = stats.summarize();
+		REQUIRE(report.frame_count == 100);
+
+		const auto& update =
+		    report.phases[static_cast<size_t>(FramePhase::Update)];
+		CHECK(update.min == microseconds(1));
+		CHECK(update.max == microseconds(100));
+		CHECK(update.p50 == microseconds(50));
+		CHECK(update.p95 == microseconds(95));
+		CHECK(update.p99 == microseconds(99));
+		CHECK(update.avg == nanoseconds(50'500));
+
+		CHECK(report.frame.min == microseconds(4));
+		CHECK(report.frame.max == microseconds(400));
+	}
+
+	TEST("elemental::FrameStats - percentiles use the nearest rank")
+	{
+		FrameStats stats;
+		for (int i = 1; i <= 10; ++i) {
+			stats.record(uniform_frame(microseconds(i)));
+		}
+
+		// ceil(p% * 10)-th smallest sample, as LoopRegulator reports
+		auto report = stats.summarize();
+		const auto& update =
+		    report.phases[static_cast<size_t>(FramePhase::Update)];
+		CHECK(update.p50 == microseconds(5));
+		CHECK(update.p95 == microseconds(10));
+		CHECK(update.p99 == microseconds(10));
+	}
+
+	TEST("elemental::FrameStats - keeps only the most recent window")
+	{
+		FrameStats stats;
+		const size_t kExtra = 10;
+		for (size_t i = 0; i < FrameStats::kWindowSize + kExtra; ++i) {
+			stats.record(uniform_frame(nanoseconds(i)));
+		}
+
+		CHECK(stats.getRecordedCount() ==
+		      FrameStats::kWindowSize + kExtra);
+
+		auto frames = stats.snapshot();
+		REQUIRE(frames.size() == FrameStats::kWindowSize);
+		CHECK(frames.front().phases[0] == nanoseconds(kExtra));
+		CHECK(frames.back().phases[0] ==
+		      nanoseconds(FrameStats::kWindowSize + kExtra - 1));
+	}
+
+	TEST("elemental::FrameStats - histogram buckets by whole milliseconds")
+	{
+		FrameStats stats;
+		FrameTiming fast{}, slow{}, stalled{};
+		fast[FramePhase::Render] = microseconds(16'600);
+		slow[FramePhase::Render] = microseconds(33'300);
+		stalled[FramePhase::Sleep] = seconds(2);
+
+		stats.record(fast);
+		stats.record(fast);
+		stats.record(slow);
+		stats.record(stalled);
+
+		auto report = stats.summarize();
+		CHECK(report.histogram[16] == 2);
+		CHECK(report.histogram[33] == 1);
+		CHECK(report.histogram.back() == 1);
+	}
+
+	TEST("elemental::FrameStats - phases are measured between marks")
+	{
+		FrameStats stats;
+		stats.beginFrame();
+		std::this_thread::sleep_for(milliseconds(2));
+		stats.mark(FramePhase::Update);
+		stats.mark(FramePhase::Render);
+		stats.endFrame();
+
+		auto frames = stats.snapshot();
+		REQUIRE(frames.size() == 1);
+		CHECK(frames[0][FramePhase::Update] >= milliseconds(2));
+		CHECK(frames[0][FramePhase::Render] < milliseconds(2));
+		CHECK(frames[0][FramePhase::Present] == nanoseconds(0));
+	}
+
+	TEST("elemental::FrameStats - report lists every phase")
+	{
+		FrameStats stats("loop");
+		stats.record(uniform_frame(milliseconds(1)));
+
+		std::ostringstream output;
+		stats.writeReport(output);
+		auto text = output.str();
+
+		CHECK(text.find("loop stats over the last 1 frames") !=
+		      std::string::npos);
+		for (auto label :
+		     { "update", "render", "present", "sleep", "frame" }) {
+			CHECK(text.find(label) != std::string::npos);
+		}
+		CHECK(text.find("4  ms: 1") != std::string::npos);
+	}
+
+	TEST("elemental::FrameStats - snapshots never contain torn frames")
+	{
+		FrameStats stats;
+		std::atomic<bool> done{ false };
+
+		// Every recorded frame has all phases equal; a torn read would
+		// mix phases from two different frames.
+		std::thread writer([&]() {
+			for (int64_t i = 1; i <= 200'000; ++i) {
+				stats.record(uniform_frame(nanoseconds(i)));
+			}
+			done.store(true);
+		});
+
+		bool consistent = true;
+		bool ordered = true;
+		while (!done.load()) {
+			for (const auto& frame : stats.snapshot()) {
+				for (auto phase : frame.phases) {
+					consistent = consistent &&
+					             (phase == frame.phases[0]);
+				}
+			}
+			auto frames = stats.snapshot();
+			for (size_t i = 1; i < frames.size(); ++i) {
+				ordered = ordered && (frames[i].phases[0] ==
+				                      frames[i - 1].phases[0] +
+				                          nanoseconds(1));
+			}
+		}
+		writer.join();
+
+		CHECK(consistent);
+		CHECK(ordered);
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
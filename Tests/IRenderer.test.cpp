@@ -15,6 +15,7 @@
 #include "IOCore/TomlTable.hpp"
 
 #include <any>
+#include <type_traits>
 #include <utility>
 
 BEGIN_TEST_SUITE("elemental::IRenderer")
@@ -39,6 +40,16 @@ BEGIN_TEST_SUITE("elemental::IRenderer")
 		{
 			return;
 		}
+		void blit(std::shared_ptr<void> image_data,
+		          const Rectangle& source,
+		          Rectangle& placement) override
+		{
+			return;
+		}
+		void submitBatch(std::span<const SpriteInstance> sprites) override
+		{
+			return;
+		}
 
 	    protected:
 		DummyRenderer() : IRenderer() {}
@@ -116,6 +127,79 @@ BEGIN_TEST_SUITE("elemental::IRenderer")
 		REQUIRE(deserialized_rectangle.size.width == 30);
 		REQUIRE(deserialized_rectangle.size.height == 40);
 	}
+
+	TEST("elemental::Rectangle is a trivially-copyable value type")
+	{
+		static_assert(sizeof(Rectangle) == 16);
+		static_assert(std::is_trivially_copyable_v<Rectangle>);
+
+		Rectangle original{ 1, 2, 3, 4 };
+		Rectangle copy = original;
+		copy.position.x = 100;
+
+		// Copies must not alias the original
+		CHECK(original.x() == 1);
+		CHECK(copy.x() == 100);
+		CHECK(copy.y() == 2);
+		CHECK(copy.width() == 3);
+		CHECK(copy.height() == 4);
+		CHECK(copy.right() == 103);
+		CHECK(copy.bottom() == 6);
+	}
+
+	TEST("elemental::Rectangle geometry helpers")
+	{
+		constexpr Rectangle kViewport{ 0, 0, 100, 100 };
+		constexpr Rectangle kInside{ 10, 10, 20, 20 };
+		constexpr Rectangle kStraddling{ 90, 80, 20, 40 };
+		constexpr Rectangle kOutside{ 200, 200, 10, 10 };
+
+		// The helpers are usable at compile time
+		static_assert(kViewport.contains(kInside));
+		static_assert(kViewport.intersects(kStraddling));
+		static_assert(!kViewport.intersects(kOutside));
+
+		SECTION("contains")
+		{
+			CHECK(kViewport.contains(Point{ 0, 0 }));
+			CHECK(kViewport.contains(Point{ 99, 99 }));
+			CHECK_FALSE(kViewport.contains(Point{ 100, 50 }));
+			CHECK_FALSE(kViewport.contains(kStraddling));
+		}
+		SECTION("intersection")
+		{
+			auto overlap = kViewport.intersection(kStraddling);
+			CHECK(overlap.x() == 90);
+			CHECK(overlap.y() == 80);
+			CHECK(overlap.width() == 10);
+			CHECK(overlap.height() == 20);
+
+			CHECK(kViewport.intersection(kOutside).isEmpty());
+			CHECK_FALSE(kViewport.intersects(Rectangle{ 5, 5, 0, 0 }));
+		}
+		SECTION("unite")
+		{
+			auto bounds = kInside.unite(kOutside);
+			CHECK(bounds.x() == 10);
+			CHECK(bounds.y() == 10);
+			CHECK(bounds.right() == 210);
+			CHECK(bounds.bottom() == 210);
+
+			CHECK(Rectangle{}.unite(kInside).x() == kInside.x());
+		}
+		SECTION("clip")
+		{
+			auto clipped = kStraddling.clip(kViewport);
+			CHECK(clipped.x() == 90);
+			CHECK(clipped.width() == 10);
+			CHECK(clipped.height() == 20);
+
+			auto outside = kOutside.clip(kViewport);
+			CHECK(outside.isEmpty());
+			CHECK(outside.x() == 100);
+			CHECK(outside.y() == 100);
+		}
+	}
 }
 
 // clang-format off
@@ -0,0 +1,239 @@
+/* JsonPathStream.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "JsonPathStream.hpp"
+
+#include "test-utils/common.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::JsonPathStream")
+{
+	using namespace elemental;
+	using namespace std::chrono;
+	using nlohmann::json;
+
+	const std::string kDocument = R"({
+		"dimensions": [ 1280, 720 ],
+		"layers": [ "background", "foreground" ],
+		"entities": {
+			"Ball": { "position": [ 640, 360 ], "tags": [ "round" ] },
+			"Player": { "position": [ 0, 296 ] }
+		},
+		"scripts": [
+			{ "name": "Score.js" },
+			{ "name": "Match.js" }
+		],
+		"odd/key~": 7
+	})";
+
+	TEST("elemental::JsonPathStream - selects values by exact path")
+	{
+		std::vector<int> dimensions;
+		int calls = 0;
+
+		JsonPathStream paths;
+		paths.on("/dimensions",
+		         [&](const std::string& path, json& value) {
+			         CHECK(path == "/dimensions");
+			         dimensions = value.get<std::vector<int>>();
+			         ++calls;
+		         })
+		    .on("/layers/1", [&](const std::string&, json& value) {
+			    CHECK(value == "foreground");
+			    ++calls;
+		    });
+		paths.parse(kDocument);
+
+		CHECK(calls == 2);
+		CHECK(dimensions == std::vector<int>{ 1280, 720 });
+	}
+
+	TEST("elemental::JsonPathStream - wildcards match keys and indices")
+	{
+		std::vector<std::string> entity_paths;
+		std::vector<std::string> script_names;
+
+		JsonPathStream paths;
+		paths.on("/entities/*",
+		         [&](const std::string& path, json& entity) {
+			         CHECK(entity.contains("position"));
+			         entity_paths.push_back(path);
+		         })
+		    .on("/scripts/*", [&](const std::string& path, json& script) {
+			    script_names.push_back(script["name"]);
+			    CHECK(path.rfind("/scripts/", 0) == 0);
+		    });
+		paths.parse(kDocument);
+
+		CHECK(entity_paths ==
+		      std::vector<std::string>{ "/entities/Ball",
+		                                "/entities/Player" });
+		CHECK(script_names ==
+		      std::vector<std::string>{ "Score.js", "Match.js" });
+	}
+
+	TEST("elemental::JsonPathStream - captured values are complete and "
+	     "not matched again inside")
+	{
+		json ball;
+		int inner_calls = 0;
+
+		JsonPathStream paths;
+		paths.on("/entities/Ball",
+		         [&](const std::string&, json& value) { ball = value; })
+		    .on("/entities/Ball/tags",
+		        [&](const std::string&, json&) { ++inner_calls; });
+		paths.parse(kDocument);
+
+		CHECK(ball == json::parse(R"({
+			"position": [ 640, 360 ], "tags": [ "round" ]
+		})"));
+		CHECK(inner_calls == 0);
+	}
+
+	TEST("elemental::JsonPathStream - escaped keys round-trip")
+	{
+		int odd_value = 0;
+		std::string odd_path;
+
+		JsonPathStream paths;
+		paths.on("/odd~1key~0", [&](const std::string& path, json& value) {
+			odd_path = path;
+			odd_value = value;
+		});
+		paths.parse(kDocument);
+
+		CHECK(odd_value == 7);
+		CHECK(odd_path == "/odd~1key~0");
+	}
+
+	TEST("elemental::JsonPathStream - splitPath() unescapes each key")
+	{
+		CHECK(JsonPathStream::splitPath("").empty());
+		CHECK(JsonPathStream::splitPath("/odd~1key~0/3") ==
+		      std::vector<std::string>{ "odd/key~", "3" });
+		CHECK(JsonPathStream::splitPath("/a//b") ==
+		      std::vector<std::string>{ "a", "", "b" });
+		REQUIRE_THROWS_AS(JsonPathStream::splitPath("a/b"),
+		                  IOCore::Exception);
+	}
+
+	TEST("elemental::JsonPathStream - the empty pattern captures the "
+	     "document")
+	{
+		json root;
+		int inner_calls = 0;
+
+		JsonPathStream paths;
+		paths.on("", [&](const std::string& path, json& value) {
+			     CHECK(path.empty());
+			     root = std::move(value);
+		     })
+		    .on("/layers", [&](const std::string&, json&) {
+			    ++inner_calls;
+		    });
+		paths.parse(kDocument);
+
+		CHECK(root == json::parse(kDocument));
+		CHECK(inner_calls == 0);
+	}
+
+	TEST("elemental::JsonPathStream - reports malformed input")
+	{
+		JsonPathStream paths;
+		paths.on("/a", [](const std::string&, json&) {});
+
+		CHECK_THROWS_AS(paths.parse(R"({ "a": [ 1, 2 )"),
+		                IOCore::Exception);
+		CHECK_THROWS_AS(paths.on("no-slash", {}), IOCore::Exception);
+	}
+
+	TEST("elemental::JsonPathStream - streams from std::istream")
+	{
+		std::istringstream input(kDocument);
+		size_t layer_count = 0;
+
+		JsonPathStream paths;
+		paths.on("/layers", [&](const std::string&, json& value) {
+			layer_count = value.size();
+		});
+		paths.parse(input);
+		CHECK(layer_count == 2);
+	}
+
+	BENCHMARK_TEST("elemental::JsonPathStream - streaming against DOM load")
+	{
+		const int kEntityCount = 200'000;
+
+		std::string document = R"({"dimensions":[8192,8192],"entities":{)";
+		for (int i = 0; i < kEntityCount; ++i) {
+			document += (i ? "," : "");
+			document += R"("entity_)" + std::to_string(i) +
+			            R"(":{"type":"Tile","position":[)" +
+			            std::to_string(i % 1000) + "," +
+			            std::to_string(i / 1000) +
+			            R"(],"size":[32,32],"layer":"foreground"})";
+		}
+		document += "}}";
+
+		auto time_ms = [](auto load) {
+			auto start = steady_clock::now();
+			load();
+			return duration<double, std::milli>(
+			           steady_clock::now() - start
+			)
+			    .count();
+		};
+
+		int64_t dom_sum = 0;
+		auto dom_ms = time_ms([&]() {
+			auto parsed = json::parse(document);
+			for (const auto& [name, entity] :
+			     parsed["entities"].items()) {
+				dom_sum += entity["position"][0].get<int64_t>();
+			}
+		});
+
+		int64_t stream_sum = 0;
+		auto stream_ms = time_ms([&]() {
+			JsonPathStream paths;
+			paths.on("/entities/*",
+			         [&](const std::string&, json& entity) {
+				         stream_sum +=
+				             entity["position"][0].get<int64_t>();
+			         });
+			paths.parse(document);
+		});
+
+		// Only the two numbers are built
+		auto selective_ms = time_ms([&]() {
+			JsonPathStream paths;
+			paths.on("/dimensions", [&](const std::string&, json&) {});
+			paths.parse(document);
+		});
+
+		CHECK(stream_sum == dom_sum);
+		std::cout << "JSON load, " << document.size() / 1024
+			  << " KiB: DOM " << dom_ms << " ms, per-entity stream "
+			  << stream_ms << " ms, selective stream "
+			  << selective_ms << " ms" << std::endl;
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -17,6 +17,7 @@
 
 #include <chrono>
 #include <cmath>
+#include <iostream>
 #include <random>
 #include <thread>
 
@@ -31,8 +32,16 @@ BEGIN_TEST_SUITE("elemental::LoopRegulator")
 	};
 	FIXTURE_TEST("elemental::LoopRegulator - Initialization")
 	{
-		CHECK(test_object.elapsed_ms.count() == 0);
+		CHECK(test_object.elapsed_time.count() == 0);
 		CHECK(test_object.start_time == steady_clock::time_point());
+		CHECK(test_object.getJitterStats().sample_count == 0);
+	}
+	TEST("elemental::LoopRegulator - Period keeps sub-millisecond precision")
+	{
+		LoopRegulator regulator(60_Hz);
+		// 1/60 s truncated to whole milliseconds would be 16ms (62.5Hz)
+		CHECK(regulator.getPeriod() > 16'666'000ns);
+		CHECK(regulator.getPeriod() < 16'667'000ns);
 	}
 	FIXTURE_TEST(
 	    "elemental::LoopRegulator - Time calculations work properly")
@@ -43,7 +52,7 @@ BEGIN_TEST_SUITE("elemental::LoopRegulator")
 		auto elapsed_time = test_object.endUpdate();
 		auto timestamp2 = test_object.end_time;
 		CHECK(timestamp1 < timestamp2);
-		REQUIRE(test_object.elapsed_ms.count() > 900);
+		REQUIRE(test_object.elapsed_time > 900ms);
 	};
 
 	FIXTURE_TEST(
@@ -70,16 +79,27 @@ BEGIN_TEST_SUITE("elemental::LoopRegulator")
 		std::uniform_int_distribution<int> delay_generator(
 		    0, static_cast<int>(1000.0 / 60));
 
+		/* Deadlines are absolute: frame i must end at
+		 * first_start + (i + 1) * period, whatever the work took. A
+		 * frame that wakes late is made up for by the next one, so the
+		 * error is measured against the schedule, not per frame. */
+		const auto& kPeriod = test_object.desired_period;
+		steady_clock::time_point first_start;
+
 		for (unsigned i = 0; i < 100; ++i) {
 			auto random_delay = milliseconds(delay_generator(gen));
 
 			test_object.startUpdate();
+			if (i == 0) {
+				first_start = test_object.start_time;
+			}
 			this_thread::sleep_for(random_delay);
-			auto time_delayed_ms = test_object.delay();
-			auto& expected_delay = test_object.desired_delay_ms;
+			test_object.delay();
 
-			auto margin_error_ms =
-			    (expected_delay - (time_delayed_ms + random_delay));
+			auto expected_end = first_start + (i + 1) * kPeriod;
+			auto margin_error_ms = duration_cast<milliseconds>(
+			    steady_clock::now() - expected_end
+			);
 
 			if (margin_error_ms.count() < 0) {
 				CHECK(margin_error_ms >
@@ -92,6 +112,57 @@ BEGIN_TEST_SUITE("elemental::LoopRegulator")
 		}
 	}
 #endif
+
+	// Wall-clock bound, so it runs with the benchmarks rather than in
+	// every unit test run
+	BENCHMARK_TEST("elemental::LoopRegulator - Achieved rate and p99 jitter")
+	{
+		const int kFrames = 120;
+		const double kRate = 60.0;
+
+		LoopRegulator regulator(60_Hz);
+		std::default_random_engine gen(12345);
+		std::uniform_int_distribution<int> work_us(0, 8000);
+
+		auto start = steady_clock::now();
+		for (int frame = 0; frame < kFrames; ++frame) {
+			regulator.startUpdate();
+			this_thread::sleep_for(microseconds(work_us(gen)));
+			regulator.delay();
+		}
+		duration<double> elapsed = steady_clock::now() - start;
+
+		auto achieved_rate = kFrames / elapsed.count();
+		auto jitter = regulator.getJitterStats();
+
+		std::cout << "LoopRegulator: " << achieved_rate
+			  << " Hz achieved, jitter mean "
+			  << duration<double, std::micro>(jitter.mean).count()
+			  << "us, p99 "
+			  << duration<double, std::micro>(jitter.p99).count()
+			  << "us, max "
+			  << duration<double, std::micro>(jitter.max).count()
+			  << "us\n";
+
+		CHECK(jitter.sample_count == kFrames);
+		// Absolute deadlines: no per-frame rounding or drift
+		CHECK(std::abs(achieved_rate - kRate) < kRate * 0.01);
+		CHECK(jitter.p99 < 1ms);
+	}
+
+	TEST("elemental::LoopRegulator - Late frames do not trigger catch-up")
+	{
+		LoopRegulator regulator(100_Hz);
+
+		regulator.startUpdate();
+		this_thread::sleep_for(35ms); // three and a half periods late
+		CHECK(regulator.delay() == 0ns);
+
+		// The next frame gets a full period, not a burst of short ones
+		regulator.startUpdate();
+		auto waited = regulator.delay();
+		CHECK(waited > 8ms);
+	}
 };
 // clang-format off
 // vim: set foldmethod=marker foldmarker=#region,#endregion textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -8,6 +8,9 @@
  */
 
 #include <any>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <list>
 #include <string>
@@ -19,7 +22,9 @@
 #include "test-utils/common.hpp"
 #include <fakeit.hpp>
 
+using elemental::ITypedObserver;
 using elemental::Observable;
+using elemental::TypedObservable;
 using fakeit::Mock;
 using fakeit::When;
 
@@ -83,6 +88,93 @@ BEGIN_TEST_SUITE("elemental::Observable")
 		CHECK(buffer.at(0) == "First Observer");
 		CHECK(buffer.at(1) == "Second Observer");
 	}
+
+	// Same size as an SDL_Event, too large for std::any's inline buffer
+	struct Payload {
+		std::array<uint8_t, 56> bytes;
+	};
+
+	class TypedSubject : public TypedObservable<Payload>
+	{
+	  public:
+		void notify(const Payload& payload) { notify_all(payload); }
+	};
+	class AnySubject : public Observable
+	{
+	  public:
+		void notify(const Payload& payload) { notify_all(payload); }
+	};
+
+	class PayloadRecorder
+	    : public ITypedObserver<Payload>
+	    , public elemental::IObserver
+	{
+	  public:
+		void recieveMessage(const TypedObservable<Payload>& sender,
+		                    const Payload& payload) override
+		{
+			last_address = &payload;
+			checksum += payload.bytes[0];
+		}
+		void recieveMessage(const Observable& sender,
+		                    std::any message) override
+		{
+			checksum += std::any_cast<Payload&>(message).bytes[0];
+		}
+
+		const Payload* last_address = nullptr;
+		uint64_t checksum = 0;
+	};
+
+	TEST("elemental::TypedObservable - delivers messages by reference")
+	{
+		TypedSubject subject;
+		PayloadRecorder first, second;
+		Payload payload{};
+		payload.bytes[0] = 7;
+
+		subject.registerObserver(first);
+		subject.registerObserver(second);
+		subject.notify(payload);
+
+		CHECK(first.last_address == &payload);
+		CHECK(second.last_address == &payload);
+		CHECK(first.checksum == 7);
+		CHECK(second.checksum == 7);
+	}
+
+	BENCHMARK_TEST("elemental::Observable - dispatch cost per event")
+	{
+		using namespace std::chrono;
+		const int kEventCount = 1'000'000;
+
+		TypedSubject typed_subject;
+		AnySubject any_subject;
+		PayloadRecorder recorder;
+		typed_subject.registerObserver(recorder);
+		any_subject.registerObserver(recorder);
+
+		Payload payload{};
+		payload.bytes[0] = 1;
+
+		auto measure = [&](auto& subject) {
+			auto start = steady_clock::now();
+			for (int i = 0; i < kEventCount; ++i) {
+				subject.notify(payload);
+			}
+			duration<double, std::nano> elapsed =
+			    steady_clock::now() - start;
+			return elapsed.count() / kEventCount;
+		};
+
+		auto any_cost = measure(any_subject);
+		auto typed_cost = measure(typed_subject);
+
+		CHECK(recorder.checksum == 2 * kEventCount);
+		std::cout << "std::any dispatch: " << any_cost
+			  << " ns/event, typed dispatch: " << typed_cost
+			  << " ns/event\n";
+	}
 }
 
 // clang-format off
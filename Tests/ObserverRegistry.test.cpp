@@ -0,0 +1,146 @@
+/* ObserverRegistry.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "ObserverRegistry.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <memory>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::ObserverRegistry")
+{
+	using namespace elemental;
+
+	struct Counter {
+		int calls = 0;
+	};
+
+	auto visit_all(ObserverRegistry<Counter>& registry)
+	    -> std::vector<Counter*>
+	{
+		std::vector<Counter*> visited;
+		registry.forEach([&](Counter& counter) {
+			++counter.calls;
+			visited.push_back(&counter);
+		});
+		return visited;
+	}
+
+	TEST("elemental::ObserverRegistry - add and remove by handle")
+	{
+		ObserverRegistry<Counter> registry;
+		Counter first, second, third;
+
+		auto first_handle = registry.add(first);
+		auto second_handle = registry.add(second);
+		registry.add(third);
+		REQUIRE(registry.size() == 3);
+		CHECK(visit_all(registry) ==
+		      std::vector<Counter*>{ &first, &second, &third });
+
+		CHECK(registry.remove(second_handle));
+		CHECK_FALSE(registry.remove(second_handle));
+		CHECK_FALSE(registry.contains(second_handle));
+		CHECK(registry.contains(first_handle));
+
+		auto visited = visit_all(registry);
+		REQUIRE(visited.size() == 2);
+		CHECK(second.calls == 1);
+	}
+
+	TEST("elemental::ObserverRegistry - stale handles do not match reused "
+	     "slots")
+	{
+		ObserverRegistry<Counter> registry;
+		Counter first, second;
+
+		auto stale_handle = registry.add(first);
+		registry.remove(stale_handle);
+		auto fresh_handle = registry.add(second);
+
+		CHECK(fresh_handle.slot == stale_handle.slot);
+		CHECK_FALSE(registry.remove(stale_handle));
+		CHECK(registry.size() == 1);
+		CHECK(registry.contains(fresh_handle));
+	}
+
+	TEST("elemental::ObserverRegistry - removal during iteration is "
+	     "deferred")
+	{
+		ObserverRegistry<Counter> registry;
+		Counter first, second, third;
+
+		auto first_handle = registry.add(first);
+		auto second_handle = registry.add(second);
+		registry.add(third);
+
+		std::vector<Counter*> visited;
+		registry.forEach([&](Counter& counter) {
+			visited.push_back(&counter);
+			if (&counter == &first) {
+				// Removing itself and a later observer
+				registry.remove(first_handle);
+				registry.remove(second_handle);
+			}
+		});
+
+		CHECK(visited == std::vector<Counter*>{ &first, &third });
+		CHECK(registry.size() == 1);
+		CHECK(visit_all(registry) == std::vector<Counter*>{ &third });
+	}
+
+	TEST("elemental::ObserverRegistry - Subscription unregisters on "
+	     "destruction")
+	{
+		ObserverRegistry<Counter> registry;
+		Counter counter;
+
+		{
+			auto subscription = registry.subscribe(counter);
+			CHECK(subscription.isActive());
+			CHECK(registry.size() == 1);
+
+			auto moved = std::move(subscription);
+			CHECK_FALSE(subscription.isActive());
+			CHECK(registry.size() == 1);
+		}
+		CHECK(registry.empty());
+	}
+
+	TEST("elemental::ObserverRegistry - Subscription may outlive the "
+	     "registry")
+	{
+		Counter counter;
+		Subscription subscription;
+		{
+			ObserverRegistry<Counter> registry;
+			subscription = registry.subscribe(counter);
+		}
+		CHECK_FALSE(subscription.isActive());
+		REQUIRE_NOTHROW(subscription.reset());
+	}
+
+	TEST("elemental::ObserverRegistry - clear invalidates every handle")
+	{
+		ObserverRegistry<Counter> registry;
+		Counter first, second;
+
+		auto first_handle = registry.add(first);
+		registry.add(second);
+		registry.clear();
+
+		CHECK(registry.empty());
+		CHECK_FALSE(registry.contains(first_handle));
+		CHECK(visit_all(registry).empty());
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
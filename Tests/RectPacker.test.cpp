@@ -0,0 +1,97 @@
+/* RectPacker.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "RectPacker.hpp"
+#include "types/rendering.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <random>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::RectPacker")
+{
+	using namespace elemental;
+
+	struct Placed {
+		Point position;
+		Area size;
+	};
+
+	auto overlaps(const Placed& lhs, const Placed& rhs) -> bool
+	{
+		return lhs.position.x < rhs.position.x + rhs.size.width &&
+		       rhs.position.x < lhs.position.x + lhs.size.width &&
+		       lhs.position.y < rhs.position.y + rhs.size.height &&
+		       rhs.position.y < lhs.position.y + lhs.size.height;
+	}
+
+	TEST("elemental::RectPacker - first rectangle goes in the corner")
+	{
+		RectPacker packer({ 256, 256 });
+		auto position = packer.insert(32, 16);
+
+		REQUIRE(position.has_value());
+		CHECK(position->x == 0);
+		CHECK(position->y == 0);
+		CHECK(packer.getUsedArea() == 32 * 16);
+	}
+
+	TEST("elemental::RectPacker - rejects rectangles that do not fit")
+	{
+		RectPacker packer({ 64, 64 });
+
+		CHECK_FALSE(packer.insert(65, 1).has_value());
+		CHECK_FALSE(packer.insert(1, 65).has_value());
+		CHECK_FALSE(packer.insert(0, 10).has_value());
+
+		REQUIRE(packer.insert(64, 64).has_value());
+		CHECK_FALSE(packer.insert(1, 1).has_value());
+		CHECK(packer.getOccupancy() == 1.0);
+
+		packer.reset();
+		CHECK(packer.getUsedArea() == 0);
+		CHECK(packer.insert(64, 64).has_value());
+	}
+
+	TEST("elemental::RectPacker - placements stay in bounds and never "
+	     "overlap")
+	{
+		const Area kBinSize{ 512, 512 };
+		RectPacker packer(kBinSize);
+		std::mt19937 generator(1234);
+		std::uniform_int_distribution<uint32_t> side(4, 64);
+
+		std::vector<Placed> placed;
+		for (unsigned attempt = 0; attempt < 500; ++attempt) {
+			Area size{ side(generator), side(generator) };
+			auto position = packer.insert(size.width, size.height);
+			if (position.has_value()) {
+				placed.push_back({ *position, size });
+			}
+		}
+		REQUIRE(placed.size() > 50);
+
+		for (size_t i = 0; i < placed.size(); ++i) {
+			const auto& rect = placed[i];
+			REQUIRE(rect.position.x + rect.size.width <=
+			        kBinSize.width);
+			REQUIRE(rect.position.y + rect.size.height <=
+			        kBinSize.height);
+
+			for (size_t j = i + 1; j < placed.size(); ++j) {
+				REQUIRE_FALSE(overlaps(rect, placed[j]));
+			}
+		}
+		CHECK(packer.getOccupancy() > 0.5);
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,138 @@
+/* ResourceCache.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "ResourceCache.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <memory>
+#include <string>
+
+BEGIN_TEST_SUITE("elemental::ResourceCache")
+{
+	using namespace elemental;
+
+	/* Resources are strings; each one "costs" as many bytes as it has
+	 * characters. */
+	struct TestFixture {
+		TestFixture()
+		    : load_count(0)
+		    , test_object(
+			  100,
+			  [this](const std::string& key) {
+				  ++load_count;
+				  return std::make_shared<std::string>(key);
+			  },
+			  [](const std::shared_ptr<std::string>& resource) {
+				  return resource->size();
+			  }
+		      )
+		{
+		}
+
+		unsigned load_count;
+		ResourceCache<std::string> test_object;
+	};
+
+	FIXTURE_TEST("elemental::ResourceCache - repeated loads are deduplicated")
+	{
+		auto first = test_object.acquire("skull.png");
+		auto second = test_object.acquire("skull.png");
+
+		CHECK(first == second);
+		CHECK(load_count == 1);
+
+		auto stats = test_object.getStats();
+		CHECK(stats.hits == 1);
+		CHECK(stats.misses == 1);
+		CHECK(stats.resident_count == 1);
+		CHECK(stats.resident_bytes == std::string("skull.png").size());
+	}
+
+	FIXTURE_TEST("elemental::ResourceCache - evicts least-recently-used "
+	             "resources over budget")
+	{
+		const std::string kFirst(40, 'a');
+		const std::string kSecond(40, 'b');
+		const std::string kThird(40, 'c');
+
+		test_object.acquire(kFirst);
+		test_object.acquire(kSecond);
+		test_object.acquire(kFirst); // kSecond is now the oldest
+		test_object.acquire(kThird);
+
+		CHECK(test_object.contains(kFirst));
+		CHECK_FALSE(test_object.contains(kSecond));
+		CHECK(test_object.contains(kThird));
+
+		auto stats = test_object.getStats();
+		CHECK(stats.evictions == 1);
+		CHECK(stats.resident_bytes == 80);
+	}
+
+	FIXTURE_TEST("elemental::ResourceCache - referenced resources are "
+	             "never evicted")
+	{
+		const std::string kFirst(60, 'a');
+		const std::string kSecond(60, 'b');
+
+		auto held = test_object.acquire(kFirst);
+		auto also_held = test_object.acquire(kSecond);
+
+		// Over budget, but everything is still in use
+		CHECK(test_object.getStats().resident_bytes == 120);
+		CHECK(test_object.getStats().evictions == 0);
+
+		held.reset();
+		test_object.trim();
+		CHECK_FALSE(test_object.contains(kFirst));
+		CHECK(test_object.contains(kSecond));
+
+		also_held.reset();
+		test_object.purgeUnused();
+		CHECK(test_object.getStats().resident_count == 0);
+		CHECK(test_object.getStats().resident_bytes == 0);
+	}
+
+	FIXTURE_TEST("elemental::ResourceCache - lowering the budget evicts")
+	{
+		test_object.acquire(std::string(30, 'a'));
+		test_object.acquire(std::string(30, 'b'));
+		test_object.setBudget(30);
+
+		CHECK(test_object.getBudget() == 30);
+		CHECK(test_object.getStats().resident_bytes == 30);
+		CHECK(test_object.contains(std::string(30, 'b')));
+	}
+
+	FIXTURE_TEST("elemental::ResourceCache - insert adds external resources")
+	{
+		auto resource = std::make_shared<std::string>("preloaded");
+		test_object.insert("key", resource);
+
+		CHECK(test_object.acquire("key") == resource);
+		CHECK(load_count == 0);
+	}
+
+	FIXTURE_TEST("elemental::ResourceCache - clear drops referenced "
+	             "resources")
+	{
+		auto held = test_object.acquire("held");
+		test_object.acquire("loose");
+		test_object.clear();
+
+		CHECK_FALSE(test_object.contains("held"));
+		CHECK(test_object.getStats().resident_count == 0);
+		CHECK(test_object.getStats().resident_bytes == 0);
+		CHECK(*held == "held");
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,206 @@
+/* Scene.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "AssetLoader.hpp"
+#include "JsonConfigFile.hpp"
+#include "Scene.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::Scene")
+{
+	using namespace elemental;
+	using configuration::JsonConfigFile;
+	namespace fs = std::filesystem;
+
+	// The layout of Apps/Demos/phong/Assets/MainScene.json
+	const char* kNestedScene = R"({
+	  "main" : {
+	    "dimensions": [ 1280, 720 ],
+	    "layers": [ "background", "foreground" ],
+	    "entities": {
+	      "Player" : { "position": [ 0, 296 ], "size": [ 64, 128 ] },
+	      "Enemy" : { "position": [ 656, 296 ], "size": [ 64, 128 ] },
+	      "Ball" : { "position": [ 640, 360 ], "size": [ 32, 32 ] }
+	    },
+	    "scripts": { "Score.js" : {} }
+	  }
+	})";
+
+	// 8 × 4 chunks; no chunk files exist, so every load fails
+	const char* kTileMapScene = R"({
+	  "dimensions": [ 2048, 1024 ],
+	  "tilemap": {
+	    "directory": "data/tests/no-such-tilemap",
+	    "size": [ 2048, 1024 ],
+	    "chunk_size": [ 256, 256 ],
+	    "load_radius": 1,
+	    "hysteresis": 2,
+	    "max_requests_per_update": 16
+	  }
+	})";
+
+	struct TestFixture {
+		fs::path scene_path;
+
+		TestFixture()
+		    : scene_path(fs::temp_directory_path() /
+		                 "elemental-scene-test.json")
+		{
+		}
+		~TestFixture() { fs::remove(scene_path); }
+
+		auto withScene(const std::string& text) -> JsonConfigFile
+		{
+			std::ofstream(scene_path) << text;
+			return JsonConfigFile(scene_path);
+		}
+	};
+
+	auto sorted(std::vector<std::string> names) -> std::vector<std::string>
+	{
+		std::sort(names.begin(), names.end());
+		return names;
+	}
+
+	FIXTURE_TEST("elemental::Scene - loads a scene nested under one key")
+	{
+		auto config = withScene(kNestedScene);
+		Scene scene(nullptr, config);
+
+		CHECK(sorted(scene.queryEntities({ { 0, 0 }, { 1280, 720 } })) ==
+		      std::vector<std::string>{ "Ball", "Enemy", "Player" });
+		CHECK(scene.pickEntities({ 650, 370 }) ==
+		      std::vector<std::string>{ "Ball" });
+		CHECK(scene.getTileMap() == nullptr);
+	}
+
+	FIXTURE_TEST("elemental::Scene - loads a top-level scene")
+	{
+		auto config = withScene(R"({
+		  "dimensions": [ 100, 100 ],
+		  "entities": [ { "name": "Only", "position": [ 10, 10 ],
+		                  "size": [ 5, 5 ] } ]
+		})");
+		Scene scene(nullptr, config);
+
+		CHECK(scene.nearestEntity({ 90, 90 }) == "Only");
+	}
+
+	FIXTURE_TEST("elemental::Scene - keys with '/' and '~' name entities")
+	{
+		// JSON pointers escape these characters; names must not be
+		auto config = withScene(R"({
+		  "odd/scene": {
+		    "dimensions": [ 64, 64 ],
+		    "entities": {
+		      "a/b": { "position": [ 0, 0 ], "size": [ 8, 8 ] },
+		      "x~y": { "position": [ 32, 32 ], "size": [ 8, 8 ] }
+		    }
+		  }
+		})");
+		Scene scene(nullptr, config, "odd/scene");
+
+		CHECK(scene.pickEntities({ 1, 1 }) ==
+		      std::vector<std::string>{ "a/b" });
+		CHECK(scene.pickEntities({ 33, 33 }) ==
+		      std::vector<std::string>{ "x~y" });
+	}
+
+	FIXTURE_TEST("elemental::Scene - picks one of several scenes by key")
+	{
+		auto config = withScene(R"({
+		  "menu": { "dimensions": [ 64, 64 ],
+		            "entities": { "Button": { "position": [ 0, 0 ],
+		                                      "size": [ 8, 8 ] } } },
+		  "game": { "dimensions": [ 64, 64 ],
+		            "entities": { "Hero": { "position": [ 0, 0 ],
+		                                    "size": [ 8, 8 ] } } }
+		})");
+
+		Scene game(nullptr, config, "game");
+		CHECK(game.pickEntities({ 1, 1 }) ==
+		      std::vector<std::string>{ "Hero" });
+
+		REQUIRE_THROWS_AS(Scene(nullptr, config), IOCore::Exception);
+		REQUIRE_THROWS_AS(Scene(nullptr, config, "credits"),
+		                  IOCore::Exception);
+	}
+
+	FIXTURE_TEST("elemental::Scene - a file without a scene is an error")
+	{
+		auto config = withScene(R"({ "version": 2 })");
+		REQUIRE_THROWS_AS(Scene(nullptr, config), IOCore::Exception);
+	}
+
+	FIXTURE_TEST("elemental::Scene - streams the tile map around the spawn")
+	{
+		auto config = withScene(kTileMapScene);
+		AssetLoader loader(1);
+		Scene scene(nullptr, config);
+		REQUIRE(scene.getTileMap() == nullptr);
+
+		scene.loadResources(loader);
+		const auto* tile_map = scene.getTileMap();
+		REQUIRE(tile_map != nullptr);
+
+		const auto& settings = tile_map->getSettings();
+		CHECK(settings.chunk_size.width == 256);
+		CHECK(settings.chunk_size.height == 256);
+		CHECK(settings.load_radius == 1);
+		CHECK(settings.hysteresis == 2);
+		CHECK(settings.max_requests_per_update == 16);
+		CHECK(tile_map->getWorldSize().width == 2048);
+		CHECK(tile_map->getWorldSize().height == 1024);
+
+		// Without a "spawn", streaming starts at the map centre,
+		// which lies in chunk (4, 2)
+		REQUIRE(tile_map->chunkAt({ 1024, 512 }) == ChunkCoord{ 4, 2 });
+		auto counts = tile_map->getChunkCounts();
+		for (uint32_t row = 0; row < counts.height; ++row) {
+			for (uint32_t column = 0; column < counts.width;
+			     ++column) {
+				bool is_near = column >= 3 && column <= 5 &&
+				               row >= 1 && row <= 3;
+				CHECK(tile_map->isRequested({ column, row }) ==
+				      is_near);
+			}
+		}
+	}
+
+	FIXTURE_TEST("elemental::Scene - moved entities are found at their new "
+	             "position")
+	{
+		auto config = withScene(kNestedScene);
+		Scene scene(nullptr, config);
+
+		for (auto kind : { SpatialIndexKind::HashGrid,
+		                   SpatialIndexKind::LooseQuadtree }) {
+			scene.setSpatialIndex(kind);
+			scene.moveEntity("Ball", { 1000, 100 });
+
+			CHECK(scene.pickEntities({ 650, 370 }).empty());
+			CHECK(scene.pickEntities({ 1010, 110 }) ==
+			      std::vector<std::string>{ "Ball" });
+			CHECK(scene.nearestEntity({ 1200, 50 }) == "Ball");
+			scene.moveEntity("Ball", { 640, 360 });
+		}
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
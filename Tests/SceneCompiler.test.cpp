@@ -0,0 +1,314 @@
+/* SceneCompiler.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "CompiledScene.hpp"
+#include "SceneCompiler.hpp"
+
+#include "test-utils/common.hpp"
+
+#include "IOCore/Exception.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::SceneCompiler")
+{
+	using namespace elemental;
+	using namespace std::chrono;
+	using nlohmann::json;
+	namespace fs = std::filesystem;
+
+	const json kScene = json::parse(R"({
+		"dimensions": [ 1280, 720 ],
+		"layers": [ "background", "foreground" ],
+		"entities": {
+			"backdrop": {
+				"type": "Image",
+				"position": [ 0, 0 ],
+				"size": [ 1280, 720 ],
+				"layer": "background",
+				"image": "background.png"
+			},
+			"Ball": {
+				"position": [ 640, 360 ],
+				"size": [ 32, 32 ],
+				"layer": "foreground",
+				"scripts": "Ball.js"
+			}
+		},
+		"scripts": {
+			"Score.js": { "layer": "foreground" }
+		}
+	})");
+
+	//! The compiled bytes, copied to suitably aligned storage
+	struct AlignedBytes {
+		explicit AlignedBytes(const std::vector<std::byte>& bytes)
+		    : storage((bytes.size() + 7) / 8)
+		{
+			std::memcpy(storage.data(), bytes.data(), bytes.size());
+			size = bytes.size();
+		}
+		auto span() const -> std::span<const std::byte>
+		{
+			return { reinterpret_cast<const std::byte*>(
+				     storage.data()
+				 ),
+				 size };
+		}
+
+		std::vector<uint64_t> storage;
+		size_t size;
+	};
+
+	auto find_entity(const CompiledScene& scene, std::string_view name)
+	    -> const CompiledScene::EntityRecord*
+	{
+		for (const auto& entity : scene.getEntities()) {
+			if (scene.getString(entity.name) == name) {
+				return &entity;
+			}
+		}
+		return nullptr;
+	}
+
+	TEST("elemental::SceneCompiler - compiled scenes read back in place")
+	{
+		AlignedBytes bytes(scene_format::compile(kScene));
+		CompiledScene scene(bytes.span());
+
+		CHECK(scene.getWidth() == 1280);
+		CHECK(scene.getHeight() == 720);
+		REQUIRE(scene.getLayerCount() == 2);
+		CHECK(scene.getLayer(1) == "foreground");
+		REQUIRE(scene.getEntities().size() == 2);
+
+		auto* ball = find_entity(scene, "Ball");
+		REQUIRE(ball != nullptr);
+		CHECK(ball->position[0] == 640);
+		CHECK(ball->size[1] == 32);
+		CHECK(scene.getLayer(ball->layer) == "foreground");
+		CHECK(scene.getString(ball->script) == "Ball.js");
+		CHECK(scene.getString(ball->image).empty());
+
+		auto* backdrop = find_entity(scene, "backdrop");
+		REQUIRE(backdrop != nullptr);
+		CHECK(scene.getString(backdrop->type) == "Image");
+		CHECK(scene.getString(backdrop->image) == "background.png");
+
+		REQUIRE(scene.getScripts().size() == 1);
+		CHECK(scene.getString(scene.getScripts()[0].path) == "Score.js");
+	}
+
+	TEST("elemental::SceneCompiler - accepts arrays of named entities")
+	{
+		auto description = json::parse(R"({
+			"layers": [ "main" ],
+			"entities": [
+				{ "name": "a", "layer": "main", "type": "Box" },
+				{ "name": "b", "type": "Box" }
+			],
+			"scripts": [ { "name": "Main", "path": "main.js" } ]
+		})");
+		AlignedBytes bytes(scene_format::compile(description));
+		CompiledScene scene(bytes.span());
+
+		REQUIRE(scene.getEntities().size() == 2);
+		CHECK(scene.getEntities()[1].layer == scene_format::kNoLayer);
+		// "Box" is stored once and shared
+		CHECK(scene.getEntities()[0].type.offset ==
+		      scene.getEntities()[1].type.offset);
+		CHECK(scene.getString(scene.getScripts()[0].path) == "main.js");
+	}
+
+	TEST("elemental::SceneCompiler - rejects malformed descriptions")
+	{
+		auto unknown_layer = json::parse(R"({
+			"layers": [ "main" ],
+			"entities": { "a": { "layer": "missing" } }
+		})");
+		CHECK_THROWS_AS(scene_format::compile(unknown_layer),
+		                IOCore::Exception);
+
+		auto bad_position = json::parse(R"({
+			"entities": { "a": { "position": [ 1 ] } }
+		})");
+		CHECK_THROWS_AS(scene_format::compile(bad_position),
+		                IOCore::Exception);
+		CHECK_THROWS_AS(scene_format::compile(json::array()),
+		                IOCore::Exception);
+	}
+
+	TEST("elemental::CompiledScene - rejects corrupt data")
+	{
+		auto compiled = scene_format::compile(kScene);
+
+		auto bad_magic = compiled;
+		bad_magic[0] = std::byte{ 'X' };
+		CHECK_THROWS_AS(CompiledScene(AlignedBytes(bad_magic).span()),
+		                IOCore::Exception);
+
+		auto bad_version = compiled;
+		bad_version[4] = std::byte{ 99 };
+		CHECK_THROWS_AS(CompiledScene(AlignedBytes(bad_version).span()),
+		                IOCore::Exception);
+
+		auto truncated = compiled;
+		truncated.resize(truncated.size() - 8);
+		CHECK_THROWS_AS(CompiledScene(AlignedBytes(truncated).span()),
+		                IOCore::Exception);
+
+		// A string reaching past the table
+		auto bad_string = compiled;
+		scene_format::Header header;
+		std::memcpy(&header, bad_string.data(), sizeof(header));
+		scene_format::EntityRecord entity;
+		std::memcpy(&entity,
+		            bad_string.data() + header.entities_offset,
+		            sizeof(entity));
+		entity.name.length = header.strings_size + 1;
+		std::memcpy(bad_string.data() + header.entities_offset,
+		            &entity,
+		            sizeof(entity));
+		CHECK_THROWS_AS(CompiledScene(AlignedBytes(bad_string).span()),
+		                IOCore::Exception);
+	}
+
+	TEST("elemental::CompiledScene - maps compiled files")
+	{
+		auto directory = fs::temp_directory_path();
+		auto json_path = directory / "elemental-scene-test.json";
+		auto scene_path = directory / "elemental-scene-test.scene";
+		{
+			std::ofstream output(json_path);
+			output << json{ { "main", kScene } }.dump();
+		}
+
+		scene_format::compile_file(json_path, scene_path);
+		{
+			CompiledScene scene(scene_path);
+			CHECK(scene.getEntities().size() == 2);
+			CHECK(find_entity(scene, "backdrop") != nullptr);
+		}
+		CHECK_THROWS_AS(CompiledScene(directory / "missing.scene"),
+		                IOCore::Exception);
+
+		fs::remove(json_path);
+		fs::remove(scene_path);
+	}
+
+	BENCHMARK_TEST("elemental::CompiledScene - load time against JSON")
+	{
+		const int kEntityCount = 100'000;
+
+		// Stands in for the demo's Entity, which Scene builds per entry
+		struct LoadedEntity {
+			std::string type;
+			std::vector<int> position;
+			std::vector<int> size;
+			std::string layer;
+		};
+		using EntityMap =
+		    std::unordered_map<std::string, std::shared_ptr<LoadedEntity>>;
+
+		json description{ { "dimensions", { 8192, 8192 } },
+			          { "layers", { "background", "foreground" } } };
+		auto& entities = description["entities"];
+		for (int i = 0; i < kEntityCount; ++i) {
+			entities["entity_" + std::to_string(i)] = {
+				{ "type", (i % 2) ? "Tile" : "Prop" },
+				{ "position", { i % 1000, i / 1000 } },
+				{ "size", { 32, 32 } },
+				{ "layer", (i % 3) ? "foreground" : "background" },
+			};
+		}
+
+		auto directory = fs::temp_directory_path();
+		auto json_path = directory / "elemental-scene-bench.json";
+		auto scene_path = directory / "elemental-scene-bench.scene";
+		{
+			std::ofstream output(json_path);
+			output << description.dump();
+		}
+		scene_format::compile_file(json_path, scene_path);
+
+		auto time_ms = [](auto load) {
+			auto start = steady_clock::now();
+			load();
+			return duration<double, std::milli>(
+			           steady_clock::now() - start
+			)
+			    .count();
+		};
+
+		// What Scene does today: parse everything, then copy it out
+		auto json_ms = time_ms([&]() {
+			std::ifstream input(json_path);
+			auto parsed = json::parse(input);
+			EntityMap loaded;
+			for (const auto& [name, entity] :
+			     parsed["entities"].items()) {
+				loaded[name] = std::make_shared<LoadedEntity>(
+				    LoadedEntity{ entity["type"],
+				                  entity["position"],
+				                  entity["size"],
+				                  entity["layer"] }
+				);
+			}
+			REQUIRE(loaded.size() == kEntityCount);
+		});
+
+		// Same objects, built from the mapped records
+		auto compiled_ms = time_ms([&]() {
+			CompiledScene scene(scene_path);
+			EntityMap loaded;
+			loaded.reserve(scene.getEntities().size());
+			for (const auto& record : scene.getEntities()) {
+				loaded[std::string(scene.getString(record.name))] =
+				    std::make_shared<LoadedEntity>(LoadedEntity{
+					std::string(scene.getString(record.type)),
+					{ record.position[0], record.position[1] },
+					{ record.size[0], record.size[1] },
+					std::string(scene.getLayer(record.layer)) });
+			}
+			REQUIRE(loaded.size() == kEntityCount);
+		});
+
+		// Reading the records in place, with no per-entity objects
+		int64_t checksum = 0;
+		auto in_place_ms = time_ms([&]() {
+			CompiledScene scene(scene_path);
+			for (const auto& record : scene.getEntities()) {
+				checksum += record.position[0] + record.size[0];
+			}
+		});
+		CHECK(checksum > 0);
+
+		std::cout << "Scene load, " << kEntityCount << " entities: JSON "
+			  << json_ms << " ms, compiled " << compiled_ms
+			  << " ms, in place " << in_place_ms << " ms"
+			  << std::endl;
+		CHECK(compiled_ms < json_ms);
+
+		fs::remove(json_path);
+		fs::remove(scene_path);
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
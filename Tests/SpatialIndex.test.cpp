@@ -0,0 +1,367 @@
+/* SpatialIndex.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "ISpatialIndex.hpp"
+#include "LooseQuadtree.hpp"
+#include "SpatialHashGrid.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::ISpatialIndex")
+{
+	using namespace elemental;
+	using namespace std::chrono;
+	using EntryID = ISpatialIndex::EntryID;
+
+	const Rectangle kWorld{ { 0, 0 }, { 4096, 4096 } };
+	const SpatialIndexKind kKinds[] = { SpatialIndexKind::HashGrid,
+		                            SpatialIndexKind::LooseQuadtree };
+
+	auto kind_name(SpatialIndexKind kind) -> const char*
+	{
+		return kind == SpatialIndexKind::HashGrid ? "HashGrid"
+		                                          : "LooseQuadtree";
+	}
+
+	auto random_bounds(std::mt19937& rng, const Rectangle& world)
+	    -> Rectangle
+	{
+		std::uniform_int_distribution<uint32_t> x(0, world.width() - 1);
+		std::uniform_int_distribution<uint32_t> y(0, world.height() - 1);
+		std::uniform_int_distribution<uint32_t> size(1, 96);
+		return { { x(rng), y(rng) }, { size(rng), size(rng) } };
+	}
+
+	auto sorted(std::vector<EntryID> ids) -> std::vector<EntryID>
+	{
+		std::sort(ids.begin(), ids.end());
+		return ids;
+	}
+
+	struct Reference {
+		std::vector<Rectangle> bounds;
+		std::vector<bool> is_present;
+
+		auto inRange(const Rectangle& area) const -> std::vector<EntryID>
+		{
+			std::vector<EntryID> result;
+			for (EntryID id = 0; id < bounds.size(); ++id) {
+				if (is_present[id] && bounds[id].intersects(area)) {
+					result.push_back(id);
+				}
+			}
+			return result;
+		}
+
+		auto nearestDistance(Point point) const -> uint64_t
+		{
+			uint64_t best = UINT64_MAX;
+			for (EntryID id = 0; id < bounds.size(); ++id) {
+				if (is_present[id]) {
+					best = std::min(best, squared_distance(
+					                          point, bounds[id]
+					                      ));
+				}
+			}
+			return best;
+		}
+	};
+
+	TEST("elemental::ISpatialIndex - squared_distance to a rectangle")
+	{
+		Rectangle bounds{ { 10, 10 }, { 10, 10 } };
+
+		CHECK(squared_distance({ 15, 15 }, bounds) == 0);
+		CHECK(squared_distance({ 10, 19 }, bounds) == 0);
+		CHECK(squared_distance({ 5, 15 }, bounds) == 25);
+		CHECK(squared_distance({ 23, 24 }, bounds) == 16 + 25);
+	}
+
+	TEST("elemental::ISpatialIndex - Create() picks the implementation")
+	{
+		auto grid = ISpatialIndex::Create(SpatialIndexKind::HashGrid,
+		                                  kWorld, 64);
+		auto tree = ISpatialIndex::Create(
+		    SpatialIndexKind::LooseQuadtree, kWorld
+		);
+
+		REQUIRE(dynamic_cast<SpatialHashGrid*>(grid.get()) != nullptr);
+		CHECK(dynamic_cast<SpatialHashGrid*>(grid.get())->getCellSize() ==
+		      64);
+		CHECK(dynamic_cast<LooseQuadtree*>(tree.get()) != nullptr);
+	}
+
+	TEST("elemental::ISpatialIndex - insert, update and remove entries")
+	{
+		for (auto kind : kKinds) {
+			INFO(kind_name(kind));
+			auto index = ISpatialIndex::Create(kind, kWorld);
+
+			index->insert(3, { { 100, 100 }, { 10, 10 } });
+			REQUIRE(index->contains(3));
+			CHECK_FALSE(index->contains(2));
+			CHECK(index->size() == 1);
+
+			// insert() on a present entry moves it
+			index->insert(3, { { 500, 500 }, { 10, 10 } });
+			CHECK(index->size() == 1);
+			CHECK(index->getBounds(3)->x() == 500);
+
+			CHECK(index->update(3, { { 2000, 20 }, { 8, 8 } }));
+			CHECK_FALSE(index->update(7, { { 0, 0 }, { 1, 1 } }));
+
+			std::vector<EntryID> found;
+			index->queryPoint({ 2004, 24 }, found);
+			CHECK(found == std::vector<EntryID>{ 3 });
+			found.clear();
+			index->queryPoint({ 104, 104 }, found);
+			CHECK(found.empty());
+
+			CHECK(index->remove(3));
+			CHECK_FALSE(index->remove(3));
+			CHECK(index->size() == 0);
+			CHECK(index->getBounds(3) == nullptr);
+			CHECK_FALSE(index->queryNearest({ 0, 0 }).has_value());
+		}
+	}
+
+	TEST("elemental::ISpatialIndex - queries match a brute-force scan")
+	{
+		for (auto kind : kKinds) {
+			INFO(kind_name(kind));
+			std::mt19937 rng(1234);
+			auto index = ISpatialIndex::Create(kind, kWorld, 128);
+			Reference reference;
+
+			const EntryID kCount = 2000;
+			for (EntryID id = 0; id < kCount; ++id) {
+				reference.bounds.push_back(random_bounds(rng, kWorld));
+				reference.is_present.push_back(true);
+				index->insert(id, reference.bounds.back());
+			}
+
+			// Move half, remove a tenth
+			for (EntryID id = 0; id < kCount; id += 2) {
+				reference.bounds[id] = random_bounds(rng, kWorld);
+				REQUIRE(index->update(id, reference.bounds[id]));
+			}
+			for (EntryID id = 0; id < kCount; id += 10) {
+				reference.is_present[id] = false;
+				REQUIRE(index->remove(id));
+			}
+			CHECK(index->size() == kCount - kCount / 10);
+
+			for (int query = 0; query < 200; ++query) {
+				auto area = random_bounds(rng, kWorld);
+				area.size = { area.width() * 4, area.height() * 4 };
+
+				std::vector<EntryID> found;
+				index->queryRange(area, found);
+				// sorted() also exposes duplicates
+				REQUIRE(sorted(found) == reference.inRange(area));
+
+				Point point = random_bounds(rng, kWorld).position;
+				found.clear();
+				index->queryPoint(point, found);
+				REQUIRE(sorted(found) ==
+				        reference.inRange({ point, { 1, 1 } }));
+
+				auto nearest = index->queryNearest(point);
+				REQUIRE(nearest.has_value());
+				CHECK(squared_distance(point,
+				                       reference.bounds[*nearest]) ==
+				      reference.nearestDistance(point));
+			}
+		}
+	}
+
+	TEST("elemental::ISpatialIndex - entries outside the world are found")
+	{
+		for (auto kind : kKinds) {
+			INFO(kind_name(kind));
+			auto index = ISpatialIndex::Create(kind, kWorld);
+
+			index->insert(1, { { 9000, 9000 }, { 20, 20 } });
+			index->insert(2, { { 10, 10 }, { 4000, 4000 } });
+
+			std::vector<EntryID> found;
+			index->queryRange({ { 8990, 8990 }, { 20, 20 } }, found);
+			CHECK(found == std::vector<EntryID>{ 1 });
+
+			found.clear();
+			index->queryPoint({ 3000, 3000 }, found);
+			CHECK(found == std::vector<EntryID>{ 2 });
+
+			CHECK(index->queryNearest({ 9500, 9500 }) == EntryID{ 1 });
+		}
+	}
+
+	TEST("elemental::ISpatialIndex - queryNearest() honours max_distance")
+	{
+		for (auto kind : kKinds) {
+			INFO(kind_name(kind));
+			auto index = ISpatialIndex::Create(kind, kWorld, 32);
+
+			index->insert(1, { { 1000, 1000 }, { 10, 10 } });
+
+			CHECK_FALSE(index->queryNearest({ 1000, 900 }, 99));
+			CHECK(index->queryNearest({ 1000, 900 }, 100) == EntryID{ 1 });
+			CHECK(index->queryNearest({ 1005, 1005 }, 0) == EntryID{ 1 });
+		}
+	}
+
+	TEST("elemental::ISpatialIndex - queryNearest() across a sparse world")
+	{
+		// Millions of pixels of empty cells lie between the entries;
+		// the search must not walk them one ring at a time
+		for (auto kind : kKinds) {
+			INFO(kind_name(kind));
+			auto index = ISpatialIndex::Create(kind, kWorld);
+
+			index->insert(1, { { 4'000'000, 4'000'000 }, { 10, 10 } });
+			CHECK(index->queryNearest({ 0, 0 }) == EntryID{ 1 });
+			CHECK_FALSE(index->queryNearest({ 0, 0 }, 1'000'000));
+
+			index->insert(2, { { 10, 10 }, { 10, 10 } });
+			CHECK(index->queryNearest({ 3'000'000, 3'000'000 }) ==
+			      EntryID{ 1 });
+			CHECK(index->queryNearest({ 1'000'000, 0 }) == EntryID{ 2 });
+
+			// Coming back leaves the occupied extent stretched
+			index->update(1, { { 30, 30 }, { 10, 10 } });
+			CHECK(index->queryNearest({ 3'000'000, 3'000'000 }) ==
+			      EntryID{ 1 });
+			CHECK(index->queryNearest({ 0, 0 }) == EntryID{ 2 });
+		}
+	}
+
+	TEST("elemental::ISpatialIndex - clear() empties the index")
+	{
+		for (auto kind : kKinds) {
+			INFO(kind_name(kind));
+			std::mt19937 rng(99);
+			auto index = ISpatialIndex::Create(kind, kWorld);
+			for (EntryID id = 0; id < 100; ++id) {
+				index->insert(id, random_bounds(rng, kWorld));
+			}
+
+			index->clear();
+			std::vector<EntryID> found;
+			index->queryRange(kWorld, found);
+
+			CHECK(index->size() == 0);
+			CHECK(found.empty());
+			CHECK_FALSE(index->contains(0));
+		}
+	}
+
+	BENCHMARK_TEST("elemental::ISpatialIndex - build, move and query")
+	{
+		for (EntryID count : { 10'000u, 100'000u, 1'000'000u }) {
+			// Keep density constant: about one entity per 64x64 area
+			uint32_t side = static_cast<uint32_t>(
+			    64 * std::sqrt(static_cast<double>(count))
+			);
+			Rectangle world{ { 0, 0 }, { side, side } };
+
+			for (auto kind : kKinds) {
+				std::mt19937 rng(42);
+				std::vector<Rectangle> bounds(count);
+				for (auto& rect : bounds) {
+					rect = random_bounds(rng, world);
+				}
+				auto index = ISpatialIndex::Create(kind, world, 128);
+				auto elapsed_ns = [](auto start) {
+					return duration<double, std::nano>(
+					           steady_clock::now() - start
+					)
+					    .count();
+				};
+
+				auto start = steady_clock::now();
+				for (EntryID id = 0; id < count; ++id) {
+					index->insert(id, bounds[id]);
+				}
+				auto build_ns = elapsed_ns(start);
+
+				std::uniform_int_distribution<int64_t> step(-8, 8);
+				// Stay inside the world; unsigned wrap-around would
+				// throw entities billions of units away
+				auto nudge = [&](uint32_t coordinate) {
+					return static_cast<uint32_t>(std::clamp<int64_t>(
+					    coordinate + step(rng), 0, side - 1
+					));
+				};
+				start = steady_clock::now();
+				for (EntryID id = 0; id < count; ++id) {
+					auto& rect = bounds[id];
+					rect.position.x = nudge(rect.position.x);
+					rect.position.y = nudge(rect.position.y);
+					index->update(id, rect);
+				}
+				auto move_ns = elapsed_ns(start);
+
+				const int kQueries = 10'000;
+				std::vector<EntryID> found;
+				size_t range_hits = 0;
+				start = steady_clock::now();
+				for (int query = 0; query < kQueries; ++query) {
+					found.clear();
+					index->queryRange(
+					    { random_bounds(rng, world).position,
+					      { 512, 512 } },
+					    found
+					);
+					range_hits += found.size();
+				}
+				auto range_ns = elapsed_ns(start);
+
+				start = steady_clock::now();
+				for (int query = 0; query < kQueries; ++query) {
+					found.clear();
+					index->queryPoint(
+					    random_bounds(rng, world).position, found
+					);
+				}
+				auto point_ns = elapsed_ns(start);
+
+				start = steady_clock::now();
+				size_t nearest_hits = 0;
+				for (int query = 0; query < kQueries; ++query) {
+					nearest_hits += index->queryNearest(
+					    random_bounds(rng, world).position
+					).has_value();
+				}
+				auto nearest_ns = elapsed_ns(start);
+
+				std::cout << kind_name(kind) << " " << count
+					  << " entities: build "
+					  << build_ns / count << " ns, move "
+					  << move_ns / count << " ns, range "
+					  << range_ns / kQueries << " ns ("
+					  << range_hits / kQueries << " hits), point "
+					  << point_ns / kQueries << " ns, nearest "
+					  << nearest_ns / kQueries << " ns"
+					  << std::endl;
+				CHECK(index->size() == count);
+				CHECK(nearest_hits == kQueries);
+			}
+		}
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,108 @@
+/* SpscRing.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "SpscRing.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <cstdint>
+#include <thread>
+
+BEGIN_TEST_SUITE("elemental::SpscRing")
+{
+	using namespace elemental;
+
+	TEST("elemental::SpscRing - pops items in the order they were pushed")
+	{
+		SpscRing<int, 8> ring;
+		int value = -1;
+
+		CHECK(ring.empty());
+		CHECK_FALSE(ring.tryPop(value));
+
+		for (int i = 0; i < 5; ++i) {
+			REQUIRE(ring.tryPush(i));
+		}
+		CHECK(ring.size() == 5);
+
+		for (int i = 0; i < 5; ++i) {
+			REQUIRE(ring.tryPop(value));
+			CHECK(value == i);
+		}
+		CHECK(ring.empty());
+	}
+
+	TEST("elemental::SpscRing - counts pushes that overflow")
+	{
+		SpscRing<int, 4> ring;
+
+		for (int i = 0; i < 4; ++i) {
+			REQUIRE(ring.tryPush(i));
+		}
+		CHECK_FALSE(ring.tryPush(4));
+		CHECK_FALSE(ring.tryPush(5));
+		CHECK(ring.getOverflowCount() == 2);
+		CHECK(ring.size() == ring.capacity());
+
+		// Overflowed items are dropped, not queued
+		int value = -1;
+		REQUIRE(ring.tryPop(value));
+		CHECK(value == 0);
+		REQUIRE(ring.tryPush(6));
+		ring.clear();
+		CHECK(ring.empty());
+		CHECK(ring.getOverflowCount() == 2);
+	}
+
+	TEST("elemental::SpscRing - wraps around its capacity")
+	{
+		SpscRing<int, 4> ring;
+		int value = -1;
+
+		for (int i = 0; i < 100; ++i) {
+			REQUIRE(ring.tryPush(i));
+			REQUIRE(ring.tryPush(i + 1000));
+			REQUIRE(ring.tryPop(value));
+			CHECK(value == i);
+			REQUIRE(ring.tryPop(value));
+			CHECK(value == i + 1000);
+		}
+	}
+
+	TEST("elemental::SpscRing - one producer and one consumer thread")
+	{
+		const uint64_t kItemCount = 200'000;
+		SpscRing<uint64_t, 64> ring;
+
+		std::thread producer([&]() {
+			for (uint64_t i = 0; i < kItemCount;) {
+				if (ring.tryPush(i)) {
+					++i;
+				}
+			}
+		});
+
+		uint64_t expected = 0;
+		bool in_order = true;
+		while (expected < kItemCount) {
+			uint64_t value;
+			if (ring.tryPop(value)) {
+				in_order = in_order && (value == expected);
+				++expected;
+			}
+		}
+		producer.join();
+
+		CHECK(in_order);
+		CHECK(ring.empty());
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,270 @@
+/* SystemScheduler.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "SystemScheduler.hpp"
+#include "ThreadPool.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::SystemScheduler")
+{
+	using namespace elemental;
+	using namespace std::chrono;
+	using InstanceID = Component::InstanceID;
+	using SystemID = SystemScheduler::SystemID;
+
+	struct Position {
+		float x, y;
+	};
+	struct Velocity {
+		float dx, dy;
+	};
+	struct Health {
+		int points;
+	};
+	// One distinct component type per benchmark system
+	template<size_t TLane>
+	struct Lane {
+		double value;
+	};
+
+	const auto kStep = milliseconds(8);
+
+	auto noop() -> SystemScheduler::SystemFunction
+	{
+		return [](ComponentFactory&, nanoseconds) {};
+	}
+
+	TEST("elemental::SystemScheduler - conflicting systems are ordered")
+	{
+		ThreadPool pool(2);
+		SystemScheduler scheduler(pool);
+
+		auto move = scheduler.addSystem<Reads<Velocity>, Writes<Position>>(
+		    "move", noop()
+		);
+		auto heal = scheduler.addSystem<Reads<>, Writes<Health>>(
+		    "heal", noop()
+		);
+		auto render = scheduler.addSystem<Reads<Position, Health>>(
+		    "render", noop()
+		);
+		auto steer = scheduler.addSystem<Reads<Position>, Writes<Velocity>>(
+		    "steer", noop()
+		);
+
+		CHECK(scheduler.getDependencies(move).empty());
+		CHECK(scheduler.getDependencies(heal).empty());
+		CHECK(scheduler.getDependencies(render) ==
+		      std::vector<SystemID>{ move, heal });
+		// Reading Position alongside render is fine, but writing the
+		// Velocity that move reads is not
+		CHECK(scheduler.getDependencies(steer) ==
+		      std::vector<SystemID>{ move });
+		CHECK(scheduler.getName(steer) == "steer");
+		CHECK_THROWS(scheduler.getDependencies(99));
+	}
+
+	TEST("elemental::SystemScheduler - dependents see earlier writes")
+	{
+		ThreadPool pool(4);
+		SystemScheduler scheduler(pool);
+		ComponentFactory components;
+		for (InstanceID id = 0; id < 100; ++id) {
+			components.createComponent<Position>(id, 0.0f, 0.0f);
+			components.createComponent<Velocity>(id, 1.0f, 0.0f);
+		}
+
+		scheduler.addSystem<Reads<Velocity>, Writes<Position>>(
+		    "move", [](ComponentFactory& factory, nanoseconds) {
+			    factory.view<Position, Velocity>().forEach(
+				[](InstanceID, Position& position,
+			           Velocity& velocity) {
+					position.x += velocity.dx;
+				}
+			    );
+		    }
+		);
+		std::atomic<int> mismatches{ 0 };
+		scheduler.addSystem<Reads<Position>>(
+		    "check", [&](ComponentFactory& factory, nanoseconds) {
+			    for (auto& position : factory.getPool<Position>()) {
+				    if (position.x != 1.0f) {
+					    ++mismatches;
+				    }
+			    }
+		    }
+		);
+
+		scheduler.run(components, kStep);
+		CHECK(mismatches == 0);
+	}
+
+	TEST("elemental::SystemScheduler - independent systems run "
+	     "concurrently")
+	{
+		ThreadPool pool(2);
+		SystemScheduler scheduler(pool);
+		ComponentFactory components;
+		std::atomic<int> arrived{ 0 };
+		std::atomic<int> met{ 0 };
+
+		// Each waits (bounded) for the other to start; this can only
+		// succeed if both run at the same time.
+		auto rendezvous = [&](ComponentFactory&, nanoseconds) {
+			++arrived;
+			auto deadline = steady_clock::now() + seconds(2);
+			while (arrived.load() < 2 &&
+			       steady_clock::now() < deadline) {
+				std::this_thread::yield();
+			}
+			if (arrived.load() == 2) {
+				++met;
+			}
+		};
+		scheduler.addSystem<Reads<Position>>("first", rendezvous);
+		scheduler.addSystem<Reads<Position>>("second", rendezvous);
+
+		scheduler.run(components, kStep);
+		CHECK(met == 2);
+	}
+
+	TEST("elemental::SystemScheduler - every system runs once per tick")
+	{
+		ThreadPool pool(3);
+		SystemScheduler scheduler(pool);
+		ComponentFactory components;
+		std::vector<std::atomic<int>> runs(6);
+
+		auto counter = [&](size_t index) {
+			return [&runs, index](ComponentFactory&, nanoseconds) {
+				++runs[index];
+			};
+		};
+		scheduler.addSystem<Reads<>, Writes<Position>>("a", counter(0));
+		scheduler.addSystem<Reads<Position>>("b", counter(1));
+		scheduler.addSystem<Reads<Position>>("c", counter(2));
+		scheduler.addSystem<Reads<>, Writes<Position>>("d", counter(3));
+		scheduler.addSystem<Reads<>, Writes<Health>>("e", counter(4));
+		scheduler.addSystem<Reads<Health, Position>>("f", counter(5));
+
+		for (int tick = 0; tick < 50; ++tick) {
+			scheduler.run(components, kStep);
+		}
+		for (auto& count : runs) {
+			CHECK(count == 50);
+		}
+	}
+
+	TEST("elemental::SystemScheduler - runs from a pool thread")
+	{
+		// With one worker, run() must process its own systems
+		ThreadPool pool(1);
+		SystemScheduler scheduler(pool);
+		ComponentFactory components;
+		std::atomic<int> runs{ 0 };
+
+		auto counter = [&](ComponentFactory&, nanoseconds) { ++runs; };
+		scheduler.addSystem<Reads<>, Writes<Position>>("a", counter);
+		scheduler.addSystem<Reads<Position>>("b", counter);
+		scheduler.addSystem<Reads<>, Writes<Health>>("c", counter);
+
+		auto tick = pool.submit([&]() {
+			scheduler.run(components, kStep);
+		});
+		tick.wait();
+		CHECK(runs == 3);
+	}
+
+	TEST("elemental::SystemScheduler - rethrows a failed system")
+	{
+		ThreadPool pool(2);
+		SystemScheduler scheduler(pool);
+		ComponentFactory components;
+		std::atomic<bool> dependent_ran{ false };
+
+		scheduler.addSystem<Reads<>, Writes<Position>>(
+		    "fails", [](ComponentFactory&, nanoseconds) {
+			    throw std::runtime_error("system failed");
+		    }
+		);
+		scheduler.addSystem<Reads<Position>>(
+		    "after", [&](ComponentFactory&, nanoseconds) {
+			    dependent_ran = true;
+		    }
+		);
+
+		CHECK_THROWS_AS(scheduler.run(components, kStep),
+		                std::runtime_error);
+		CHECK_FALSE(dependent_ran);
+	}
+
+	BENCHMARK_TEST("elemental::SystemScheduler - scaling with threads")
+	{
+		const int kTicks = 20;
+
+		// Each system writes its own component type, so none conflict
+		constexpr size_t kSystemCount = 16;
+		auto burn = [](ComponentFactory&, nanoseconds) {
+			volatile double sink = 0;
+			for (int i = 0; i < 200'000; ++i) {
+				sink = sink + std::sqrt(static_cast<double>(i));
+			}
+		};
+
+		auto measure = [&](unsigned thread_count) {
+			ThreadPool pool(thread_count);
+			SystemScheduler scheduler(pool);
+			ComponentFactory components;
+			[&]<size_t... TLanes>(std::index_sequence<TLanes...>) {
+				(scheduler.addSystem<Reads<>, Writes<Lane<TLanes>>>(
+				     "burn", burn
+				 ),
+				 ...);
+			}(std::make_index_sequence<kSystemCount>{});
+			for (SystemID id = 0; id < kSystemCount; ++id) {
+				REQUIRE(scheduler.getDependencies(id).empty());
+			}
+
+			auto start = steady_clock::now();
+			for (int tick = 0; tick < kTicks; ++tick) {
+				scheduler.run(components, kStep);
+			}
+			return duration<double, std::milli>(
+			           steady_clock::now() - start
+			)
+			           .count() /
+			       kTicks;
+		};
+
+		auto hardware_threads =
+		    std::max(1u, std::thread::hardware_concurrency());
+		auto single_ms = measure(1);
+		std::cout << "1 thread: " << single_ms << " ms/tick\n";
+		for (unsigned threads = 2; threads <= hardware_threads;
+		     threads *= 2) {
+			auto multi_ms = measure(threads);
+			std::cout << threads << " threads: " << multi_ms
+				  << " ms/tick (" << single_ms / multi_ms
+				  << "x)\n";
+		}
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
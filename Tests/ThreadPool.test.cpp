@@ -0,0 +1,235 @@
+/* ThreadPool.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "ThreadPool.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::ThreadPool")
+{
+	using namespace elemental;
+	using namespace std::chrono;
+
+	// Fork-join Fibonacci: one spawned task and one inline call per level
+	auto fibonacci(ThreadPool & pool, int n, int cutoff) -> uint64_t
+	{
+		if (n < 2) {
+			return n;
+		}
+		if (n <= cutoff) {
+			return fibonacci(pool, n - 1, cutoff) +
+			       fibonacci(pool, n - 2, cutoff);
+		}
+		uint64_t left = 0;
+		auto task = pool.submit(
+		    [&]() { left = fibonacci(pool, n - 1, cutoff); }
+		);
+		auto right = fibonacci(pool, n - 2, cutoff);
+		task.wait();
+		return left + right;
+	}
+
+	TEST("elemental::ThreadPool - runs submitted tasks")
+	{
+		ThreadPool pool(4);
+		std::atomic<int> count{ 0 };
+
+		std::vector<TaskHandle> handles;
+		for (int i = 0; i < 1000; ++i) {
+			handles.push_back(pool.submit([&]() { ++count; }));
+		}
+		for (auto& handle : handles) {
+			handle.wait();
+			CHECK(handle.isDone());
+		}
+		CHECK(count == 1000);
+		CHECK(pool.getThreadCount() == 4);
+	}
+
+	TEST("elemental::ThreadPool - wait rethrows the task's exception")
+	{
+		ThreadPool pool(2);
+		auto handle = pool.submit(
+		    []() { throw std::runtime_error("task failed"); }
+		);
+
+		CHECK_THROWS_AS(handle.wait(), std::runtime_error);
+		CHECK(handle.isDone());
+		CHECK_NOTHROW(TaskHandle().wait());
+	}
+
+	TEST("elemental::ThreadPool - continuations run after their task")
+	{
+		ThreadPool pool(4);
+		std::atomic<int> stage{ 0 };
+		std::atomic<bool> ordered{ true };
+
+		auto first = pool.submit([&]() {
+			std::this_thread::sleep_for(milliseconds(5));
+			stage = 1;
+		});
+		auto second = first.then([&]() {
+			ordered = ordered && stage.load() == 1;
+			stage = 2;
+		});
+		second.wait();
+		CHECK(ordered);
+		CHECK(stage == 2);
+
+		// Chaining onto a finished task queues the continuation at once
+		auto third = first.then([&]() { stage = 3; });
+		third.wait();
+		CHECK(stage == 3);
+	}
+
+	TEST("elemental::ThreadPool - parallelFor covers every index once")
+	{
+		ThreadPool pool(4);
+		std::vector<std::atomic<int>> visits(10'007);
+
+		pool.parallelFor(0, visits.size(), [&](size_t begin, size_t end) {
+			for (auto index = begin; index < end; ++index) {
+				visits[index].fetch_add(1);
+			}
+		});
+
+		bool exact = true;
+		for (auto& count : visits) {
+			exact = exact && count.load() == 1;
+		}
+		CHECK(exact);
+		CHECK_NOTHROW(pool.parallelFor(5, 5, [](size_t, size_t) {}));
+	}
+
+	TEST("elemental::ThreadPool - parallelFor rethrows")
+	{
+		ThreadPool pool(3);
+		CHECK_THROWS_AS(pool.parallelFor(0,
+		                                 1000,
+		                                 [](size_t begin, size_t) {
+			                                 if (begin >= 500) {
+				                                 throw std::
+				                                     runtime_error(
+				                                         "chunk"
+				                                     );
+			                                 }
+		                                 },
+		                                 10),
+		                std::runtime_error);
+	}
+
+	TEST("elemental::ThreadPool - tasks may wait on tasks they spawn")
+	{
+		// More nested waits than workers: only completes if waiting
+		// threads run other tasks instead of blocking.
+		ThreadPool pool(2);
+		CHECK(fibonacci(pool, 22, 8) == 17711);
+	}
+
+	TEST("elemental::ThreadPool - destruction drops queued tasks")
+	{
+		std::atomic<int> count{ 0 };
+		{
+			ThreadPool pool(1);
+			pool.submit(
+			    []() { std::this_thread::sleep_for(milliseconds(20)); }
+			);
+			for (int i = 0; i < 100; ++i) {
+				pool.submit([&]() { ++count; });
+			}
+		}
+		CHECK(count < 100);
+	}
+
+	BENCHMARK_TEST("elemental::ThreadPool - task spawn overhead")
+	{
+		const int kTaskCount = 200'000;
+		ThreadPool pool;
+
+		auto per_task_ns = [&](auto spawn_all) {
+			auto start = steady_clock::now();
+			spawn_all();
+			return duration<double, std::nano>(
+			           steady_clock::now() - start
+			)
+			           .count() /
+			       kTaskCount;
+		};
+
+		// From outside the pool, through the injection queue
+		auto external_ns = per_task_ns([&]() {
+			std::vector<TaskHandle> handles;
+			handles.reserve(kTaskCount);
+			for (int i = 0; i < kTaskCount; ++i) {
+				handles.push_back(pool.submit([]() {}));
+			}
+			for (auto& handle : handles) {
+				handle.wait();
+			}
+		});
+
+		// From a worker, onto its own deque
+		auto worker_ns = per_task_ns([&]() {
+			pool.submit([&]() {
+				    std::vector<TaskHandle> handles;
+				    handles.reserve(kTaskCount);
+				    for (int i = 0; i < kTaskCount; ++i) {
+					    handles.push_back(
+						pool.submit([]() {})
+					    );
+				    }
+				    for (auto& handle : handles) {
+					    handle.wait();
+				    }
+			    }).wait();
+		});
+
+		std::cout << "spawn + run + wait: " << external_ns
+			  << " ns/task from outside, " << worker_ns
+			  << " ns/task from a worker\n";
+	}
+
+	BENCHMARK_TEST("elemental::ThreadPool - fork-join scaling")
+	{
+		const int kN = 32;
+		const int kCutoff = 18;
+		auto hardware_threads =
+		    std::max(1u, std::thread::hardware_concurrency());
+
+		double single_ms = 0;
+		for (unsigned threads = 1; threads <= hardware_threads;
+		     threads *= 2) {
+			ThreadPool pool(threads);
+			auto start = steady_clock::now();
+			auto result = fibonacci(pool, kN, kCutoff);
+			auto elapsed_ms = duration<double, std::milli>(
+					      steady_clock::now() - start
+			)
+					      .count();
+			CHECK(result == 2178309);
+
+			if (threads == 1) {
+				single_ms = elapsed_ms;
+			}
+			std::cout << "fib(" << kN << ") on " << threads
+				  << " threads: " << elapsed_ms << " ms ("
+				  << single_ms / elapsed_ms << "x)\n";
+		}
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
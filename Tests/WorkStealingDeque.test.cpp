@@ -0,0 +1,110 @@
+/* WorkStealingDeque.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "WorkStealingDeque.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::WorkStealingDeque")
+{
+	using namespace elemental;
+
+	TEST("elemental::WorkStealingDeque - owner pops newest, thieves oldest")
+	{
+		WorkStealingDeque<int> deque;
+		for (int i = 0; i < 4; ++i) {
+			deque.push(i);
+		}
+
+		int item = -1;
+		REQUIRE(deque.pop(item));
+		CHECK(item == 3);
+		REQUIRE(deque.steal(item));
+		CHECK(item == 0);
+		CHECK(deque.size() == 2);
+
+		REQUIRE(deque.pop(item));
+		REQUIRE(deque.pop(item));
+		CHECK_FALSE(deque.pop(item));
+		CHECK_FALSE(deque.steal(item));
+		CHECK(deque.empty());
+	}
+
+	TEST("elemental::WorkStealingDeque - grows past its initial capacity")
+	{
+		WorkStealingDeque<int> deque(4);
+		int item = -1;
+
+		// Offset the indices so growth copies a wrapped range
+		deque.push(-1);
+		REQUIRE(deque.steal(item));
+
+		for (int i = 0; i < 1000; ++i) {
+			deque.push(i);
+		}
+		CHECK(deque.size() == 1000);
+		for (int i = 0; i < 1000; ++i) {
+			REQUIRE(deque.steal(item));
+			CHECK(item == i);
+		}
+	}
+
+	TEST("elemental::WorkStealingDeque - every item is taken exactly once")
+	{
+		const int kItemCount = 200'000;
+		const int kThiefCount = 3;
+		WorkStealingDeque<int> deque(16);
+		std::vector<std::atomic<int>> taken(kItemCount);
+		std::atomic<bool> done{ false };
+
+		std::vector<std::thread> thieves;
+		for (int i = 0; i < kThiefCount; ++i) {
+			thieves.emplace_back([&]() {
+				int item;
+				while (!done.load()) {
+					if (deque.steal(item)) {
+						taken[item].fetch_add(1);
+					}
+				}
+			});
+		}
+
+		// The owner mixes pushes and pops, as a worker would
+		int item;
+		for (int i = 0; i < kItemCount; ++i) {
+			deque.push(i);
+			if (i % 3 == 0 && deque.pop(item)) {
+				taken[item].fetch_add(1);
+			}
+		}
+		while (deque.pop(item)) {
+			taken[item].fetch_add(1);
+		}
+		// Let thieves finish any steal already in progress
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		done.store(true);
+		for (auto& thief : thieves) {
+			thief.join();
+		}
+
+		bool exactly_once = true;
+		for (auto& count : taken) {
+			exactly_once = exactly_once && count.load() == 1;
+		}
+		CHECK(exactly_once);
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,200 @@
+/* culling.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "util/culling.hpp"
+#include "types/rendering.hpp"
+
+#include "test-utils/common.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::culling")
+{
+	using namespace elemental;
+
+	const Rectangle kViewport{ { 0, 0 }, { 1280, 720 } };
+
+	auto make_random_rectangles(size_t count, uint32_t seed)
+	    -> std::vector<Rectangle>
+	{
+		std::mt19937 generator(seed);
+		std::uniform_int_distribution<uint32_t> coordinate(0, 2560);
+		std::uniform_int_distribution<uint32_t> extent(0, 200);
+
+		std::vector<Rectangle> rectangles(count);
+		for (auto& rect : rectangles) {
+			rect = { { coordinate(generator), coordinate(generator) },
+				 { extent(generator), extent(generator) } };
+		}
+		return rectangles;
+	}
+
+	auto same_rectangle(const Rectangle& lhs, const Rectangle& rhs) -> bool
+	{
+		return lhs.x() == rhs.x() && lhs.y() == rhs.y() &&
+		       lhs.width() == rhs.width() && lhs.height() == rhs.height();
+	}
+
+	struct CullResult {
+		std::vector<uint32_t> indices;
+		std::vector<Rectangle> clipped;
+	};
+
+	template<typename TKernel>
+	auto run_kernel(TKernel kernel, const std::vector<Rectangle>& input,
+	                const Rectangle& viewport) -> CullResult
+	{
+		CullResult result{ std::vector<uint32_t>(input.size()),
+			           std::vector<Rectangle>(input.size()) };
+		auto count =
+		    kernel(input, viewport, result.indices, result.clipped);
+		result.indices.resize(count);
+		result.clipped.resize(count);
+		return result;
+	}
+
+	TEST("elemental::culling - keeps, clips and drops rectangles")
+	{
+		std::vector<Rectangle> input = {
+			{ { 10, 10 }, { 32, 32 } },     // inside
+			{ { 1270, 700 }, { 32, 32 } },  // straddles the corner
+			{ { 2000, 10 }, { 32, 32 } },   // off to the right
+			{ { 100, 100 }, { 0, 32 } },    // empty
+			{ { 1280, 0 }, { 32, 32 } },    // touches the edge
+		};
+
+		auto result =
+		    run_kernel(culling::cull_rectangles, input, kViewport);
+
+		REQUIRE(result.indices.size() == 2);
+		CHECK(result.indices[0] == 0);
+		CHECK(result.indices[1] == 1);
+		CHECK(same_rectangle(result.clipped[0], input[0]));
+		CHECK(same_rectangle(
+		    result.clipped[1], { { 1270, 700 }, { 10, 20 } }
+		));
+	}
+
+	TEST("elemental::culling - empty viewport hides everything")
+	{
+		auto input = make_random_rectangles(64, 7);
+		auto result = run_kernel(
+		    culling::cull_rectangles, input, Rectangle{ { 5, 5 }, {} }
+		);
+		CHECK(result.indices.empty());
+	}
+
+	TEST("elemental::culling - every supported kernel matches the scalar "
+	     "kernel")
+	{
+		using culling::Kernel;
+
+		for (auto kernel : { Kernel::SSE2, Kernel::AVX2 }) {
+			if (!culling::is_supported(kernel)) {
+				continue;
+			}
+			auto cull = [kernel](auto&&... args) {
+				return culling::cull_rectangles_with(
+				    kernel, args...
+				);
+			};
+
+			// Odd sizes exercise the scalar tail after the vector
+			// loop
+			for (size_t count :
+			     { 0, 1, 3, 4, 7, 8, 9, 31, 1000, 4099 }) {
+				auto input =
+				    make_random_rectangles(count, 42 + count);
+				Rectangle viewport{ { 300, 200 },
+					            { 1280, 720 } };
+
+				auto expected = run_kernel(
+				    culling::cull_rectangles_scalar, input,
+				    viewport
+				);
+				auto actual = run_kernel(cull, input, viewport);
+
+				INFO("kernel: " << static_cast<int>(kernel)
+						<< ", count: " << count);
+				REQUIRE(actual.indices == expected.indices);
+				for (size_t i = 0; i < actual.clipped.size();
+				     ++i) {
+					CHECK(same_rectangle(
+					    actual.clipped[i],
+					    expected.clipped[i]
+					));
+				}
+			}
+		}
+	}
+
+	TEST("elemental::culling - clipped rectangles stay in the viewport")
+	{
+		auto input = make_random_rectangles(2048, 1234);
+		auto result =
+		    run_kernel(culling::cull_rectangles, input, kViewport);
+
+		REQUIRE_FALSE(result.indices.empty());
+		for (size_t i = 0; i < result.indices.size(); ++i) {
+			const auto& original = input[result.indices[i]];
+			CHECK(kViewport.contains(result.clipped[i]));
+			CHECK(original.contains(result.clipped[i]));
+			CHECK_FALSE(result.clipped[i].isEmpty());
+		}
+	}
+
+	BENCHMARK_TEST("elemental::culling - throughput")
+	{
+		using namespace std::chrono;
+		const auto kKernelNames = std::vector{ "scalar", "sse2", "avx2" };
+
+		std::cout << "active kernel: "
+			  << kKernelNames[static_cast<size_t>(
+				 culling::active_kernel()
+			     )]
+			  << "\n";
+
+		for (size_t count : { 10'000, 100'000, 1'000'000 }) {
+			auto input = make_random_rectangles(count, 99);
+			std::vector<uint32_t> indices(count);
+			std::vector<Rectangle> clipped(count);
+
+			auto measure = [&](auto kernel) {
+				const int kRepetitions = 20;
+				size_t visible = 0;
+				auto start = steady_clock::now();
+				for (int rep = 0; rep < kRepetitions; ++rep) {
+					visible += kernel(
+					    input, kViewport, indices, clipped
+					);
+				}
+				duration<double> elapsed =
+				    steady_clock::now() - start;
+				CHECK(visible > 0);
+				return static_cast<double>(count) *
+				       kRepetitions / elapsed.count();
+			};
+
+			auto scalar_rate =
+			    measure(culling::cull_rectangles_scalar);
+			auto vector_rate = measure(culling::cull_rectangles);
+
+			std::cout << count << " rects: scalar "
+				  << scalar_rate / 1e6 << " M/s, dispatched "
+				  << vector_rate / 1e6 << " M/s\n";
+		}
+	}
+}
+
+// clang-format off
+// vim: set foldmethod=syntax foldlevel=1 textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
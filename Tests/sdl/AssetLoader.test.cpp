@@ -0,0 +1,135 @@
+/* AssetLoader.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <SDL.h>
+
+#include "AssetLoader.hpp"
+#include "IRenderer.hpp"
+#include "SdlRenderer.hpp"
+
+#include "test-utils/SdlHelpers.hpp"
+#include "test-utils/common.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <thread>
+
+BEGIN_TEST_SUITE("elemental::AssetLoader")
+{
+	using namespace elemental;
+	using namespace std::chrono_literals;
+	namespace fs = std::filesystem;
+
+	const fs::path kTestDataDir = "data/tests";
+
+	// Polls until condition() holds or the deadline passes
+	template<typename TCondition>
+	auto wait_until(TCondition condition,
+	                std::chrono::milliseconds timeout = 5s) -> bool
+	{
+		auto deadline = std::chrono::steady_clock::now() + timeout;
+		while (!condition()) {
+			if (std::chrono::steady_clock::now() >= deadline) {
+				return false;
+			}
+			std::this_thread::sleep_for(1ms);
+		}
+		return true;
+	}
+
+	TEST("elemental::AssetLoader - decode errors reach the future")
+	{
+		AssetLoader loader(2);
+		auto texture = loader.loadTexture(kTestDataDir / "missing.png");
+
+		REQUIRE(texture.wait_for(5s) == std::future_status::ready);
+		REQUIRE_THROWS(texture.get());
+		// A failed decode leaves the count before its future is set
+		CHECK(loader.getPendingCount() == 0);
+		CHECK(loader.getUploadQueueSize() == 0);
+	}
+
+	TEST("elemental::AssetLoader - decoded images wait for an upload")
+	{
+		AssetLoader loader(2);
+		auto texture = loader.loadTexture(kTestDataDir / "winter_map.jpg");
+
+		// Decoding finishes on a worker, but the texture is only
+		// created on the render thread.
+		REQUIRE(wait_until(
+		    [&]() { return loader.getUploadQueueSize() == 1; }
+		));
+		CHECK(texture.wait_for(0s) == std::future_status::timeout);
+		CHECK(loader.getPendingCount() == 1);
+	}
+
+	TEST("elemental::AssetLoader - stop drops requests without a texture")
+	{
+		AssetLoader loader(1);
+		auto texture = loader.loadTexture(kTestDataDir / "winter_map.jpg");
+		loader.stop();
+
+		CHECK(loader.getPendingCount() == 0);
+		REQUIRE(texture.wait_for(0s) == std::future_status::ready);
+		CHECK_THROWS_AS(texture.get(), std::future_error);
+	}
+
+	TEST("elemental::AssetLoader - requests after stop fail immediately")
+	{
+		AssetLoader loader(1);
+		loader.stop();
+		auto texture = loader.loadTexture(kTestDataDir / "winter_map.jpg");
+
+		CHECK(loader.getPendingCount() == 0);
+		REQUIRE(texture.wait_for(0s) == std::future_status::ready);
+		CHECK_THROWS_AS(texture.get(), std::future_error);
+	}
+
+#if !defined(NO_GUI) || defined(VIM_LSP)
+	TEST("elemental::AssetLoader - loads textures in parallel")
+	{
+		SdlTestFixture sdl_context;
+		RendererSettings settings{ { "Test",
+			                     WindowMode::Windowed,
+			                     WindowPlacement::Centered,
+			                     { 0, 0 },
+			                     { 1024, 768 } },
+			                   { 1024, 768 } };
+		auto& renderer = IRenderer::GetInstance<SdlRenderer>();
+		renderer.init(settings);
+
+		AssetLoader loader;
+		auto map_texture =
+		    loader.loadTexture(kTestDataDir / "winter_map.jpg");
+		auto skull_texture =
+		    loader.loadTexture(kTestDataDir / "test-skull.png");
+
+		// Only wait on the first one; the second may finish later
+		REQUIRE(loader.waitFor(map_texture, renderer) != nullptr);
+		REQUIRE(loader.waitFor(skull_texture, renderer) != nullptr);
+		CHECK(wait_until(
+		    [&]() { return loader.getPendingCount() == 0; }
+		));
+
+		// Uploads respect the budget but always make progress
+		auto extra_texture =
+		    loader.loadTexture(kTestDataDir / "test-skull.png");
+		while (loader.getPendingCount() > 0) {
+			loader.processUploads(renderer, 0ns);
+		}
+		REQUIRE(extra_texture.get() != nullptr);
+
+		renderer.deactivate();
+	}
+#endif
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
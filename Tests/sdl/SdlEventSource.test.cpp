@@ -17,6 +17,9 @@
 #include "util/testing.hpp"
 
 #include <SDL.h>
+
+#include <chrono>
+#include <iostream>
 #include <random>
 
 namespace NS = elemental;
@@ -26,11 +29,21 @@ template<>
 class NS::debug::Inspector<SdlEventSource>
 {
   public:
-	static auto getEventQueue(SdlEventSource& other)
-	    -> std::queue<SDL_Event>&
+	using EventQueue = decltype(SdlEventSource::event_queue);
+
+	static auto getEventQueue(SdlEventSource& other) -> EventQueue&
 	{
 		return other.event_queue;
 	}
+
+	// The source is a singleton; observers from earlier tests are gone
+	static void clearObservers(SdlEventSource& other)
+	{
+		other.observers.clear();
+		other.typed_observers.clear();
+		other.observers_by_type.clear();
+		other.is_coalescing = true;
+	}
 };
 typedef NS::debug::Inspector<NS::SdlEventSource> Inspector;
 
@@ -52,6 +65,17 @@ BEGIN_TEST_SUITE("elemental::SdlEventSource")
 		std::vector<SDL_Event> received;
 	};
 
+	class TypedEventRecorder : public ITypedObserver<SDL_Event>
+	{
+	  public:
+		void recieveMessage(const TypedObservable<SDL_Event>& sender,
+		                    const SDL_Event& event) override
+		{
+			received.push_back(event);
+		}
+		std::vector<SDL_Event> received;
+	};
+
 	struct SdlEventSourceFixture : public SdlTestFixture
 	{
 
@@ -63,15 +87,14 @@ BEGIN_TEST_SUITE("elemental::SdlEventSource")
 		    , dev_rand()
 		{
 			/* Clear the event queue in between tests */
-			while (!event_queue_ref.empty()) {
-				event_queue_ref.pop();
-			}
+			event_queue_ref.clear();
+			Inspector::clearObservers(test_object);
 		}
 
 		~SdlEventSourceFixture() override = default;
 		SdlEventSource& test_object;
 		EventRecorder recorder;
-		std::queue<SDL_Event>& event_queue_ref;
+		Inspector::EventQueue& event_queue_ref;
 
 		std::random_device dev_rand;
 	};
@@ -89,14 +112,14 @@ BEGIN_TEST_SUITE("elemental::SdlEventSource")
 		for (unsigned i = 0; i < rand_count; ++i) {
 			auto& input = test_input_list[i];
 			input = SdlEventSimulator::randomArrowKey();
-			event_queue_ref.push(input);
+			REQUIRE(event_queue_ref.tryPush(input));
 		}
 
 		REQUIRE(event_queue_ref.size() == rand_count);
 
 		for (unsigned i = 0; i < rand_count; ++i) {
-			auto event = event_queue_ref.front();
-			event_queue_ref.pop();
+			SDL_Event event;
+			REQUIRE(event_queue_ref.tryPop(event));
 
 			REQUIRE(event.key.keysym.sym ==
 			        test_input_list[i].key.keysym.sym);
@@ -118,7 +141,7 @@ BEGIN_TEST_SUITE("elemental::SdlEventSource")
 		for (unsigned i = 0; i < rand_count; ++i) {
 			auto& input = test_input[i];
 			input = SdlEventSimulator::randomArrowKey();
-			event_queue_ref.push(input);
+			REQUIRE(event_queue_ref.tryPush(input));
 		}
 
 		test_object.sendEvents();
@@ -133,13 +156,190 @@ BEGIN_TEST_SUITE("elemental::SdlEventSource")
 		}
 	}
 
+	FIXTURE_TEST(
+	    "elemental::SdlEventSource::Notify reaches typed and legacy observers")
+	{
+		TypedEventRecorder typed_recorder;
+		test_object.registerObserver(typed_recorder);
+		test_object.registerObserver(recorder);
+
+		SDL_Event input = SdlEventSimulator::randomArrowKey();
+		REQUIRE(event_queue_ref.tryPush(input));
+		test_object.sendEvents();
+
+		REQUIRE(typed_recorder.received.size() == 1);
+		CHECK(typed_recorder.received[0].key.keysym.sym ==
+		      input.key.keysym.sym);
+		REQUIRE_FALSE(recorder.received.empty());
+		CHECK(recorder.received.back().key.keysym.sym ==
+		      input.key.keysym.sym);
+	}
+
+	auto make_motion(Sint32 x, Sint32 y, Sint32 xrel, Sint32 yrel)
+	    -> SDL_Event
+	{
+		SDL_Event event{};
+		event.type = SDL_MOUSEMOTION;
+		event.motion.x = x;
+		event.motion.y = y;
+		event.motion.xrel = xrel;
+		event.motion.yrel = yrel;
+		return event;
+	}
+	auto make_axis(Uint8 axis, Sint16 value) -> SDL_Event
+	{
+		SDL_Event event{};
+		event.type = SDL_JOYAXISMOTION;
+		event.jaxis.axis = axis;
+		event.jaxis.value = value;
+		return event;
+	}
+
+	FIXTURE_TEST("elemental::SdlEventSource::Subscribe by event type")
+	{
+		TypedEventRecorder quit_recorder;
+		TypedEventRecorder all_recorder;
+		auto quit_subscription =
+		    test_object.subscribe(quit_recorder, SDL_QUIT);
+		auto all_subscription = test_object.subscribe(all_recorder);
+
+		SDL_Event quit{};
+		quit.type = SDL_QUIT;
+		REQUIRE(event_queue_ref.tryPush(
+		    SdlEventSimulator::randomArrowKey()
+		));
+		REQUIRE(event_queue_ref.tryPush(quit));
+		REQUIRE(event_queue_ref.tryPush(make_motion(1, 1, 1, 1)));
+		test_object.sendEvents();
+
+		REQUIRE(quit_recorder.received.size() == 1);
+		CHECK(quit_recorder.received[0].type == SDL_QUIT);
+		CHECK(all_recorder.received.size() == 3);
+
+		quit_subscription.reset();
+		REQUIRE(event_queue_ref.tryPush(quit));
+		test_object.sendEvents();
+		CHECK(quit_recorder.received.size() == 1);
+	}
+
+	FIXTURE_TEST("elemental::SdlEventSource::Coalesces motion and axis runs")
+	{
+		TypedEventRecorder typed_recorder;
+		auto subscription = test_object.subscribe(typed_recorder);
+		auto coalesced_before = test_object.getCoalescedEventCount();
+
+		// motion x3 | key | motion x2 | axis 0 x2 | axis 1
+		REQUIRE(event_queue_ref.tryPush(make_motion(10, 10, 1, 2)));
+		REQUIRE(event_queue_ref.tryPush(make_motion(12, 13, 2, 3)));
+		REQUIRE(event_queue_ref.tryPush(make_motion(15, 17, 3, 4)));
+		REQUIRE(event_queue_ref.tryPush(
+		    SdlEventSimulator::randomArrowKey()
+		));
+		REQUIRE(event_queue_ref.tryPush(make_motion(16, 17, 1, 0)));
+		REQUIRE(event_queue_ref.tryPush(make_motion(18, 17, 2, 0)));
+		REQUIRE(event_queue_ref.tryPush(make_axis(0, 100)));
+		REQUIRE(event_queue_ref.tryPush(make_axis(0, 200)));
+		REQUIRE(event_queue_ref.tryPush(make_axis(1, 300)));
+		test_object.sendEvents();
+
+		auto& received = typed_recorder.received;
+		REQUIRE(received.size() == 5);
+		CHECK(received[0].motion.x == 15);
+		CHECK(received[0].motion.y == 17);
+		CHECK(received[0].motion.xrel == 6);
+		CHECK(received[0].motion.yrel == 9);
+		CHECK(received[1].type == SDL_KEYDOWN);
+		CHECK(received[2].motion.x == 18);
+		CHECK(received[2].motion.xrel == 3);
+		CHECK(received[3].jaxis.value == 200);
+		CHECK(received[4].jaxis.axis == 1);
+		CHECK(test_object.getCoalescedEventCount() ==
+		      coalesced_before + 4);
+
+		// Without coalescing, every event is delivered
+		received.clear();
+		test_object.setCoalescing(false);
+		REQUIRE(event_queue_ref.tryPush(make_motion(1, 1, 1, 1)));
+		REQUIRE(event_queue_ref.tryPush(make_motion(2, 2, 1, 1)));
+		test_object.sendEvents();
+		CHECK(received.size() == 2);
+	}
+
+	FIXTURE_BENCHMARK(
+	    "elemental::SdlEventSource - dispatch under heavy mouse input")
+	{
+		using namespace std::chrono;
+		const int kFrames = 1000;
+		const int kObserverCount = 8;
+
+		struct QuitWatcher : public ITypedObserver<SDL_Event> {
+			void recieveMessage(
+			    const TypedObservable<SDL_Event>& sender,
+			    const SDL_Event& event
+			) override
+			{
+				++calls;
+				is_quit = is_quit || event.type == SDL_QUIT;
+			}
+			uint64_t calls = 0;
+			bool is_quit = false;
+		};
+
+		// One frame of input: a burst of motion, then a key press
+		auto fill_frame = [&]() {
+			for (int i = 0; i < 200; ++i) {
+				event_queue_ref.tryPush(make_motion(i, i, 1, 1));
+			}
+			SDL_Event key{};
+			key.type = SDL_KEYDOWN;
+			event_queue_ref.tryPush(key);
+		};
+
+		auto measure = [&](bool is_filtered) {
+			std::vector<QuitWatcher> watchers(kObserverCount);
+			std::vector<Subscription> subscriptions;
+			for (auto& watcher : watchers) {
+				subscriptions.push_back(
+				    is_filtered
+					? test_object.subscribe(watcher, SDL_QUIT)
+					: test_object.subscribe(watcher)
+				);
+			}
+			test_object.setCoalescing(is_filtered);
+
+			duration<double, std::micro> elapsed{ 0 };
+			for (int frame = 0; frame < kFrames; ++frame) {
+				fill_frame();
+				auto start = steady_clock::now();
+				test_object.sendEvents();
+				elapsed += steady_clock::now() - start;
+			}
+
+			uint64_t calls = 0;
+			for (auto& watcher : watchers) {
+				calls += watcher.calls;
+			}
+			return std::pair(elapsed.count() / kFrames,
+			                 calls / kFrames);
+		};
+
+		auto [unfiltered_us, unfiltered_calls] = measure(false);
+		auto [filtered_us, filtered_calls] = measure(true);
+
+		std::cout << "all events, no coalescing: " << unfiltered_us
+			  << " us/frame, " << unfiltered_calls
+			  << " observer calls/frame\n"
+			  << "per-type + coalescing: " << filtered_us
+			  << " us/frame, " << filtered_calls
+			  << " observer calls/frame\n";
+		CHECK(filtered_calls * 10 < unfiltered_calls);
+	}
+
 	FIXTURE_TEST("elemental::SdlEventSource::PollEvents works")
 	{
 		auto& event_queue = Inspector::getEventQueue(test_object);
-		while (!event_queue.empty()) {
-			event_queue.pop();
-		}
-		
+		event_queue.clear();
+
 		SDL_Event event;
 		while (SDL_PollEvent(&event)) {
 			;
@@ -152,6 +352,32 @@ BEGIN_TEST_SUITE("elemental::SdlEventSource")
 
 		REQUIRE(event_queue.size() > 0);
 	}
+
+	FIXTURE_TEST("elemental::SdlEventSource::PollEvents drops overflow")
+	{
+		const auto kCapacity = SdlEventSource::kEventQueueCapacity;
+
+		SDL_Event event;
+		while (SDL_PollEvent(&event)) {
+			;
+		}
+		auto dropped_before = test_object.getDroppedEventCount();
+
+		// Leave room for exactly one of the five polled events
+		SDL_Event filler{};
+		filler.type = SDL_USEREVENT;
+		for (size_t n = 0; n < kCapacity - 1; ++n) {
+			REQUIRE(event_queue_ref.tryPush(filler));
+		}
+		for (unsigned n = 0; n < 5; ++n) {
+			SdlEventSimulator::randomArrowKey();
+		}
+
+		REQUIRE_NOTHROW(test_object.pollEvents());
+
+		CHECK(event_queue_ref.size() == kCapacity);
+		CHECK(test_object.getDroppedEventCount() >= dropped_before + 4);
+	}
 }
 // clang-format off
  // vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -15,27 +15,14 @@
 #include "sys/platform.hpp"
 
 #include "test-utils/SdlHelpers.hpp"
+#include "test-utils/SdlRendererInspector.hpp"
 #include "test-utils/common.hpp"
 
+#include <catch2/benchmark/catch_benchmark.hpp>
+
 #include <chrono>
 #include <thread>
-
-namespace elemental::debug {
-template<>
-struct Inspector<SdlRenderer>
-{
-	struct
-	{
-		bool& is_initialized;
-		SdlPtr<SDL_Window>& sdl_window_ptr;
-		SdlPtr<SDL_Renderer>& sdl_renderer_ptr;
-	} state;
-
-	Inspector(SdlRenderer& subject)
-	    : state{ subject.is_initialized, subject.sdl_window_ptr,
-		     subject.sdl_renderer_ptr } {};
-};
-} // namespace elemental::debug
+#include <vector>
 
 BEGIN_TEST_SUITE("elemental::SdlRenderer")
 {
@@ -82,10 +69,10 @@ BEGIN_TEST_SUITE("elemental::SdlRenderer")
 			SDL_Rect result =
 			    renderer.fromRectangle<SDL_Rect>(test_input);
 
-			CHECK(result.x == test_input.x);
-			CHECK(result.y == test_input.y);
-			CHECK(result.w == test_input.width);
-			CHECK(result.h == test_input.height);
+			CHECK(result.x == test_input.x());
+			CHECK(result.y == test_input.y());
+			CHECK(result.w == test_input.width());
+			CHECK(result.h == test_input.height());
 		}());
 	}
 	TEST("elemental::SdlRenderer - convert SDL_Rect to Rectangle")
@@ -96,10 +83,10 @@ BEGIN_TEST_SUITE("elemental::SdlRenderer")
 			Rectangle result =
 			    renderer.toRectangle<SDL_Rect>(test_input);
 
-			CHECK(result.x == test_input.x);
-			CHECK(result.y == test_input.y);
-			CHECK(result.width == test_input.w);
-			CHECK(result.height == test_input.h);
+			CHECK(result.x() == test_input.x);
+			CHECK(result.y() == test_input.y);
+			CHECK(result.width() == test_input.w);
+			CHECK(result.height() == test_input.h);
 		}());
 	}
 
@@ -228,6 +215,139 @@ BEGIN_TEST_SUITE("elemental::SdlRenderer")
 		}
 		std::this_thread::sleep_for(seconds(2));
 	}
+	FIXTURE_TEST("elemental::SdlRenderer - SubmitBatch works")
+	{
+		UniqueSdlPtr<SDL_Surface> image_surf_ptr;
+		SdlPtr<SDL_Texture> img_texture_ptr = nullptr;
+
+		// 1. Before initialization, throws error. The texture is a
+		// non-null placeholder so the renderer check is what fails;
+		// it is never dereferenced.
+		int placeholder_texture = 0;
+		SpriteInstance sprite{ &placeholder_texture,
+			               {},
+			               { 0, 0, 48, 48 } };
+		REQUIRE_FALSE(test_renderer.isInitialized());
+		REQUIRE_THROWS([&]() {
+			test_renderer.submitBatch({ &sprite, 1 });
+		}());
+
+		test_renderer.init(settings);
+		test_renderer.clearScreen();
+		image_surf_ptr = IMG_Load("data/tests/test-skull.png");
+		REQUIRE(image_surf_ptr != nullptr);
+		img_texture_ptr = SDL_CreateTextureFromSurface(
+		    renderer_info.state.sdl_renderer_ptr, image_surf_ptr);
+		REQUIRE(img_texture_ptr != nullptr);
+
+		// 2. Whole-texture and sub-rectangle sprites can be mixed
+		std::vector<SpriteInstance> sprites;
+		for (uint32_t i = 0; i < 10; ++i) {
+			sprites.push_back({ img_texture_ptr.get(),
+			                    {},
+			                    { i * 50, 10, 48, 48 } });
+			sprites.push_back({ img_texture_ptr.get(),
+			                    { 0, 0, 24, 24 },
+			                    { i * 50, 70, 24, 24 } });
+		}
+		REQUIRE_NOTHROW(test_renderer.submitBatch(sprites));
+
+		// 3. Sprites straddling or outside the viewport are clipped
+		// or culled
+		auto viewport = test_renderer.getViewport();
+		CHECK(viewport.width() == settings.resolution.width);
+		CHECK(viewport.height() == settings.resolution.height);
+
+		sprites.clear();
+		sprites.push_back({ img_texture_ptr.get(),
+		                    {},
+		                    { viewport.right() - 24, 10, 48, 48 } });
+		sprites.push_back({ img_texture_ptr.get(),
+		                    {},
+		                    { viewport.right() + 10, 10, 48, 48 } });
+		REQUIRE_NOTHROW(test_renderer.submitBatch(sprites));
+		REQUIRE_NOTHROW(test_renderer.blit(
+		    img_texture_ptr, sprites.back().placement
+		));
+
+		// 4. Interleaved textures are stably sorted into one
+		// geometry call per texture; culled sprites are left out
+		SdlPtr<SDL_Texture> other_texture_ptr = nullptr;
+		other_texture_ptr = SDL_CreateTextureFromSurface(
+		    renderer_info.state.sdl_renderer_ptr, image_surf_ptr);
+		REQUIRE(other_texture_ptr != nullptr);
+
+		sprites.clear();
+		for (uint32_t i = 0; i < 6; ++i) {
+			auto* texture = (i % 2) ? other_texture_ptr.get()
+			                        : img_texture_ptr.get();
+			sprites.push_back(
+			    { texture, {}, { i * 50, 200, 48, 48 } }
+			);
+		}
+		sprites.push_back({ img_texture_ptr.get(),
+		                    {},
+		                    { viewport.right() + 10, 200, 48, 48 } });
+
+		renderer_info.state.geometry_call_count = 0;
+		renderer_info.state.geometry_vertex_count = 0;
+		test_renderer.submitBatch(sprites);
+
+		CHECK(renderer_info.state.geometry_call_count == 2);
+		CHECK(renderer_info.state.geometry_vertex_count == 6 * 4);
+
+		const auto& order = renderer_info.state.batch_order;
+		REQUIRE(order.size() == 6);
+		for (size_t index = 1; index < order.size(); ++index) {
+			const auto* previous = order[index - 1].sprite;
+			const auto* current = order[index].sprite;
+			if (current->texture == previous->texture) {
+				// Stable: submission order within a run
+				CHECK(current > previous);
+			}
+		}
+		CHECK(order[0].sprite->texture == order[2].sprite->texture);
+		CHECK(order[3].sprite->texture == order[5].sprite->texture);
+		CHECK(order[0].sprite->texture != order[3].sprite->texture);
+		test_renderer.flip();
+	}
+	FIXTURE_BENCHMARK("elemental::SdlRenderer - blit vs. submitBatch")
+	{
+		const uint32_t kSpriteCount = 4096;
+		const uint32_t kColumns = 64;
+
+		UniqueSdlPtr<SDL_Surface> image_surf_ptr;
+		SdlPtr<SDL_Texture> img_texture_ptr = nullptr;
+
+		test_renderer.init(settings);
+		image_surf_ptr = IMG_Load("data/tests/test-skull.png");
+		REQUIRE(image_surf_ptr != nullptr);
+		img_texture_ptr = SDL_CreateTextureFromSurface(
+		    renderer_info.state.sdl_renderer_ptr, image_surf_ptr);
+		REQUIRE(img_texture_ptr != nullptr);
+
+		std::vector<SpriteInstance> sprites;
+		for (uint32_t i = 0; i < kSpriteCount; ++i) {
+			sprites.push_back({ img_texture_ptr.get(),
+			                    {},
+			                    { (i % kColumns) * 16,
+			                      (i / kColumns) * 12,
+			                      16,
+			                      16 } });
+		}
+
+		BENCHMARK("blit, one call per sprite")
+		{
+			for (auto& sprite : sprites) {
+				test_renderer.blit(img_texture_ptr,
+				                   sprite.placement);
+			}
+		};
+		BENCHMARK("submitBatch, one call per texture")
+		{
+			test_renderer.submitBatch(sprites);
+		};
+	}
 #endif
 }
 
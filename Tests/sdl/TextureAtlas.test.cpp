@@ -0,0 +1,253 @@
+/* TextureAtlas.test.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <SDL.h>
+#include <SDL_image.h>
+
+#include "IRenderer.hpp"
+#include "SdlRenderer.hpp"
+#include "TextureAtlas.hpp"
+
+#include "test-utils/SdlHelpers.hpp"
+#include "test-utils/SdlRendererInspector.hpp"
+#include "test-utils/common.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+BEGIN_TEST_SUITE("elemental::TextureAtlas")
+{
+	using namespace elemental;
+	namespace fs = std::filesystem;
+
+	const fs::path kTestDataDir = "data/tests";
+
+	auto find_test_images() -> std::vector<fs::path>
+	{
+		std::vector<fs::path> images;
+		for (auto& entry : fs::directory_iterator(kTestDataDir)) {
+			auto extension = entry.path().extension();
+			if (extension == ".png" || extension == ".jpg") {
+				images.push_back(entry.path());
+			}
+		}
+		return images;
+	}
+
+	auto solid_surface(Uint8 red, Uint8 green, Uint8 blue)
+	    -> UniqueSdlPtr<SDL_Surface>
+	{
+		UniqueSdlPtr<SDL_Surface> surface = nullptr;
+		surface = SDL_CreateRGBSurfaceWithFormat(
+		    0, 8, 8, 32, SDL_PIXELFORMAT_RGBA32
+		);
+		REQUIRE(surface != nullptr);
+		SDL_FillRect(surface,
+		             nullptr,
+		             SDL_MapRGBA(surface->format, red, green, blue, 255));
+		return surface;
+	}
+
+	auto overlaps(const TextureAtlas::Slot& lhs,
+	              const TextureAtlas::Slot& rhs) -> bool
+	{
+		return lhs.page == rhs.page &&
+		       lhs.position.x < rhs.position.x + rhs.size.width &&
+		       rhs.position.x < lhs.position.x + lhs.size.width &&
+		       lhs.position.y < rhs.position.y + rhs.size.height &&
+		       rhs.position.y < lhs.position.y + lhs.size.height;
+	}
+
+	TEST("elemental::TextureAtlas - packs the test images without overlap")
+	{
+		const unsigned kCopiesPerImage = 24;
+		TextureAtlas atlas({ 1024, 1024 });
+
+		auto images = find_test_images();
+		REQUIRE_FALSE(images.empty());
+
+		// Add each image several times so that pages actually fill up
+		for (auto& image_path : images) {
+			for (unsigned copy = 0; copy < kCopiesPerImage; ++copy) {
+				atlas.addImage(image_path,
+				               image_path.filename().string() +
+				                   "#" + std::to_string(copy));
+			}
+		}
+		REQUIRE_NOTHROW(atlas.pack());
+
+		const auto& slots = atlas.getSlots();
+		REQUIRE(slots.size() == images.size() * kCopiesPerImage);
+
+		std::vector<TextureAtlas::Slot> placed;
+		for (const auto& [name, slot] : slots) {
+			REQUIRE(slot.page < atlas.getPageCount());
+			REQUIRE(slot.position.x + slot.size.width <=
+			        atlas.getPageSize().width);
+			REQUIRE(slot.position.y + slot.size.height <=
+			        atlas.getPageSize().height);
+			placed.push_back(slot);
+		}
+		for (size_t i = 0; i < placed.size(); ++i) {
+			for (size_t j = i + 1; j < placed.size(); ++j) {
+				REQUIRE_FALSE(overlaps(placed[i], placed[j]));
+			}
+		}
+
+		CHECK(atlas.getOccupancy() > 0.0);
+	}
+
+	BENCHMARK_TEST("elemental::TextureAtlas - packing report")
+	{
+		const unsigned kCopiesPerImage = 24;
+		TextureAtlas atlas({ 1024, 1024 });
+
+		auto images = find_test_images();
+		REQUIRE_FALSE(images.empty());
+		for (auto& image_path : images) {
+			for (unsigned copy = 0; copy < kCopiesPerImage; ++copy) {
+				atlas.addImage(image_path,
+				               image_path.filename().string() +
+				                   "#" + std::to_string(copy));
+			}
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		atlas.pack();
+		auto pack_ms = std::chrono::duration<double, std::milli>(
+		                   std::chrono::steady_clock::now() - start
+		)
+		                   .count();
+
+		std::cout << "TextureAtlas packing report: "
+		          << atlas.getSlots().size() << " images in "
+		          << atlas.getPageCount() << " "
+		          << atlas.getPageSize().width << "x"
+		          << atlas.getPageSize().height << " page(s), "
+		          << atlas.getOccupancy() * 100.0 << "% occupied, packed in "
+		          << pack_ms << " ms" << std::endl;
+	}
+
+	TEST("elemental::TextureAtlas - rejects duplicate names and "
+	     "oversized images")
+	{
+		TextureAtlas atlas({ 32, 32 });
+		auto skull_path = kTestDataDir / "test-skull.png";
+
+		REQUIRE_NOTHROW(atlas.addImage(skull_path, "skull"));
+		REQUIRE_THROWS(atlas.addImage(skull_path, "skull"));
+
+		// test-skull.png is 48x48 and cannot fit in a 32x32 page
+		REQUIRE_THROWS(atlas.pack());
+	}
+
+	TEST("elemental::TextureAtlas - packing continues after an oversized "
+	     "image")
+	{
+		TextureAtlas atlas({ 32, 32 });
+		atlas.addSurface("small", solid_surface(255, 0, 0));
+		atlas.addImage(kTestDataDir / "test-skull.png", "skull");
+
+		// The skull is packed first (tallest first) and fails
+		REQUIRE_THROWS(atlas.pack());
+		REQUIRE_NOTHROW(atlas.pack());
+
+		CHECK(atlas.getSlots().size() == 1);
+		CHECK(atlas.getSlots().contains("small"));
+		CHECK_FALSE(atlas.getSlots().contains("skull"));
+	}
+
+#if !defined(NO_GUI) || defined(VIM_LSP)
+	TEST("elemental::TextureAtlas - uploaded regions can be blitted")
+	{
+		SdlTestFixture sdl_context;
+		RendererSettings settings{ { "Test",
+			                     WindowMode::Windowed,
+			                     WindowPlacement::Centered,
+			                     { 0, 0 },
+			                     { 1024, 768 } },
+			                   { 1024, 768 } };
+		auto& renderer = IRenderer::GetInstance<SdlRenderer>();
+		renderer.init(settings);
+
+		TextureAtlas atlas({ 1024, 1024 });
+		for (auto& image_path : find_test_images()) {
+			atlas.addImage(image_path, image_path.filename().string());
+		}
+		REQUIRE_THROWS(atlas.getRegion("test-skull.png"));
+		atlas.upload(renderer);
+		REQUIRE(atlas.getPageCount() == 1);
+
+		auto region = atlas.getRegion("test-skull.png");
+		REQUIRE(region.texture != nullptr);
+		CHECK(region.source.width() == 48);
+		CHECK(region.source.height() == 48);
+
+		Rectangle placement{ 10, 10, 48, 48 };
+		renderer.clearScreen();
+		REQUIRE_NOTHROW(
+		    renderer.blit(region.texture, region.source, placement)
+		);
+		renderer.flip();
+		renderer.deactivate();
+	}
+
+	TEST("elemental::TextureAtlas - images added to an uploaded page keep "
+	     "their colors")
+	{
+		SdlTestFixture sdl_context;
+		RendererSettings settings{ { "Test",
+			                     WindowMode::Windowed,
+			                     WindowPlacement::Centered,
+			                     { 0, 0 },
+			                     { 1024, 768 } },
+			                   { 1024, 768 } };
+		auto& renderer = IRenderer::GetInstance<SdlRenderer>();
+		renderer.init(settings);
+		debug::Inspector<SdlRenderer> renderer_info(renderer);
+		SDL_Renderer* sdl_renderer =
+		    renderer_info.state.sdl_renderer_ptr.get();
+
+		// Red and blue differ, so a swapped channel order shows up
+		TextureAtlas atlas({ 64, 64 });
+		atlas.addSurface("first", solid_surface(200, 50, 10));
+		atlas.upload(renderer);
+		atlas.addSurface("second", solid_surface(10, 100, 220));
+		atlas.upload(renderer);
+		REQUIRE(atlas.getPageCount() == 1);
+
+		auto read_back = [&](const std::string& name) {
+			auto region = atlas.getRegion(name);
+			Rectangle placement{ 0, 0, 8, 8 };
+			renderer.clearScreen();
+			renderer.blit(region.texture, region.source, placement);
+
+			Uint8 pixel[4] = {};
+			SDL_Rect center{ 4, 4, 1, 1 };
+			REQUIRE(SDL_RenderReadPixels(sdl_renderer,
+			                             &center,
+			                             SDL_PIXELFORMAT_RGBA32,
+			                             pixel,
+			                             sizeof(pixel)) == 0);
+			return std::vector<int>{ pixel[0], pixel[1], pixel[2] };
+		};
+
+		CHECK(read_back("first") == std::vector<int>{ 200, 50, 10 });
+		CHECK(read_back("second") == std::vector<int>{ 10, 100, 220 });
+		renderer.flip();
+		renderer.deactivate();
+	}
+#endif
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,70 @@
+/* AllocationCounter.cpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "AllocationCounter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+using elemental::test::AllocationCounter;
+
+namespace {
+thread_local size_t* active_count = nullptr;
+
+auto counted_malloc(size_t size) -> void*
+{
+	if (active_count != nullptr) {
+		++*active_count;
+	}
+	if (auto* memory = std::malloc(size == 0 ? 1 : size)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+} // namespace
+
+AllocationCounter::AllocationCounter()
+{
+	active_count = &count;
+}
+
+AllocationCounter::~AllocationCounter()
+{
+	active_count = nullptr;
+}
+
+// Replacement global allocation functions (the over-aligned forms keep
+// their default definitions)
+auto operator new(size_t size) -> void*
+{
+	return counted_malloc(size);
+}
+auto operator new[](size_t size) -> void*
+{
+	return counted_malloc(size);
+}
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+void operator delete[](void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
@@ -0,0 +1,40 @@
+/* AllocationCounter.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace elemental::test {
+
+/*! \brief Counts global operator new calls made by the current thread
+ * while it is alive.
+ *
+ * Backed by replacement global allocation functions in
+ * AllocationCounter.cpp, which forward to malloc / free. Counters do not
+ * nest. */
+class AllocationCounter
+{
+  public:
+	AllocationCounter();
+	~AllocationCounter();
+
+	AllocationCounter(const AllocationCounter&) = delete;
+	auto operator=(const AllocationCounter&) -> AllocationCounter& = delete;
+
+	auto getCount() const -> size_t { return count; }
+
+  protected:
+	size_t count{ 0 };
+};
+
+} // namespace elemental::test
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
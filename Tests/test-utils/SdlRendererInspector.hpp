@@ -0,0 +1,49 @@
+/* SdlRendererInspector.hpp
+ * Copyright © 2024 Saul D. Beniquez
+ * License: Mozilla Public License v. 2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License,
+ * v.2.0. If a copy of the MPL was not distributed with this file, You can
+ * obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "SDL_Memory.hpp"
+#include "SdlRenderer.hpp"
+
+#include <SDL.h>
+
+#include <vector>
+
+namespace elemental::debug {
+// Shared by every test that needs SdlRenderer internals, so that the
+// specialization has a single definition in the test runner.
+template<>
+struct Inspector<SdlRenderer>
+{
+	using BatchItem = SdlRenderer::BatchItem;
+
+	struct
+	{
+		bool& is_initialized;
+		SdlPtr<SDL_Window>& sdl_window_ptr;
+		SdlPtr<SDL_Renderer>& sdl_renderer_ptr;
+		//! Sprites of the last batch, in draw order
+		std::vector<BatchItem>& batch_order;
+		size_t& geometry_call_count;
+		size_t& geometry_vertex_count;
+	} state;
+
+	Inspector(SdlRenderer& subject)
+	    : state{ subject.is_initialized,
+		     subject.sdl_window_ptr,
+		     subject.sdl_renderer_ptr,
+		     subject.batch_order,
+		     subject.geometry_call_count,
+		     subject.geometry_vertex_count } {};
+};
+} // namespace elemental::debug
+
+// clang-format off
+// vim: set foldmethod=syntax textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
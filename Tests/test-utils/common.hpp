@@ -25,6 +25,12 @@
 
 #define FIXTURE_TEST(testname) TEST_WITH_FIXTURE(TestFixture, testname)
 
+/* Benchmarks are hidden from the default run (and from ctest); run them with
+ * `test-runner "[benchmark]"` */
+#define BENCHMARK_TEST(testname) TEST_CASE(testname, "[.][benchmark]")
+#define FIXTURE_BENCHMARK(testname)                                             \
+	TEST_CASE_METHOD(TestFixture, testname, "[.][benchmark]")
+
 // clang-format off
 // vim: set foldmethod=marker foldmarker=#region,#endregion textwidth=80 ts=8 sts=0 sw=8  noexpandtab ft=cpp.doxygen :
 